@@ -25,6 +25,7 @@ REM ____________________________________________________________________________
 REM  DESHI_WINDOWS:  0 = not 64-bit windows        1 = build for 64-bit windows
 REM  DESHI_SLOW:     0 = no slow code allowed      1 = slow code allowed
 REM  DESHI_INTERNAL: 0 = build for public release  1 = build for developer only
+REM  DESHI_HEADLESS: 0 = build with the renderer   1 = build only the simulation (see build_physics_bench.sh)
 
 @set DEFINES_DEBUG=/D"DESHI_INTERNAL=1" /D"DESHI_SLOW=1" 
 @set DEFINES_RELEASE=
@@ -0,0 +1,58 @@
+#!/bin/sh
+# builds the headless physics benchmark (src/bench/physics_bench.cpp) for linux, it needs no window, gpu, or sdk
+# run it from the repository root so it finds data/levels: ./build/physics_bench -scene piles -bodies 2000
+cd "$(dirname "$0")/../src" || exit 1
+
+# _____________________________________________________________________________________________________
+#                                       Includes/Sources/Libs
+# _____________________________________________________________________________________________________
+
+INCLUDES="-I../src"
+SOURCES="bench/physics_bench.cpp game/Event.cpp game/components/Physics.cpp game/components/Collider.cpp
+         game/systems/PhysicsWorld.cpp game/systems/PhysicsSolver.cpp game/systems/PhysicsConvex.cpp
+         game/systems/PhysicsQuery.cpp game/systems/PhysicsIntegrator.cpp game/systems/PhysicsPrimitives.cpp
+         core/jobs.cpp core/memory.cpp"
+LIBS="-pthread"
+
+# _____________________________________________________________________________________________________
+#                                      Compiler and Linker Flags
+# _____________________________________________________________________________________________________
+
+CXX="${CXX:-g++}"
+WARNINGS="-Wno-return-type -Wno-unused-result"
+COMPILE_FLAGS="-std=c++17 -ffp-contract=off $WARNINGS" # no fused multiply adds, so the SIMD and scalar kernels agree on every platform
+OUT_EXE="physics_bench"
+
+# _____________________________________________________________________________________________________
+#                                            Defines
+# _____________________________________________________________________________________________________
+
+#  DESHI_HEADLESS: 0 = build with the renderer   1 = build only what runs without a window (see build_delle.bat for the rest)
+
+DEFINES_DEBUG="-DDESHI_SLOW=1"
+DEFINES_RELEASE=""
+DEFINES_GENERIC="-DDESHI_INTERNAL=1 -DDESHI_HEADLESS=1" # internal so core/memory.cpp counts the step allocations
+
+# _____________________________________________________________________________________________________
+#                                    Command Line Arguments
+# _____________________________________________________________________________________________________
+
+OUT_DIR="../build"
+mkdir -p "$OUT_DIR"
+case "$1" in
+	-d)
+		# DEBUG (compiles without optimization)
+		echo "$(date)    Debug"
+		echo "---------------------------------"
+		$CXX -g -O0 $COMPILE_FLAGS $DEFINES_DEBUG $DEFINES_GENERIC $INCLUDES $SOURCES -o "$OUT_DIR/$OUT_EXE" $LIBS
+		;;
+	*)
+		# RELEASE (compiles with optimization, what the numbers should be measured with)
+		echo "$(date)    Release"
+		echo "---------------------------------"
+		$CXX -O2 $COMPILE_FLAGS $DEFINES_RELEASE $DEFINES_GENERIC $INCLUDES $SOURCES -o "$OUT_DIR/$OUT_EXE" $LIBS
+		;;
+esac
+STATUS=$?
+echo "---------------------------------"
+exit $STATUS
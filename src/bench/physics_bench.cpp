@@ -0,0 +1,462 @@
+/* Headless Physics Benchmark
+Steps PhysicsWorlds for a fixed number of ticks without a window, renderer, or gpu and reports how long each
+stage of a step took, the broadphase and narrowphase pair counts, and a hash of the state every body ended in.
+The scenes are built the same way every run, so the hash only changes when the simulation does.
+Build it with misc/build_physics_bench.sh and run it from the repository root so it can find data/levels.
+
+Usage: physics_bench [options]
+  -level name    load the bodies of data/levels/name (a path to a level folder works too)
+  -scene name    generate a stress scene instead: stacks, piles, chains, or particles (default stacks)
+  -bodies n      bodies in a generated scene (default 1000)
+  -ticks n       steps to run (default 600)
+  -worlds n      step n copies of the scene at the same time on their own threads (default 1)
+  -threads n     job system workers for the narrowphase and raycasts, 0 for one per core (default 0)
+  -serial        run the narrowphase on the stepping thread instead of the job system
+  -nosleep       never put bodies to sleep
+  -simd          test spheres and AABBs against their candidates through the one-vs-many kernels, then run the
+                 scene again without them and check both ended in the same state
+  -triggers n    scatter n static sphere, AABB, and box trigger volumes over the scene (default 0)
+*/
+
+#include "../defines.h"
+#include "../core/console.h"
+#include "../core/jobs.h"
+#include "../core/memory.h"
+#include "../core/time.h"
+#include "../game/components/Physics.h"
+#include "../game/components/Collider.h"
+#include "../game/systems/PhysicsWorld.h"
+#include "../utils/utils.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <thread>
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+//the simulation only needs these from the engine, the rest of deshi.cpp's globals are left out
+local Console   console; Console*   g_console = &console;
+local JobSystem jobs;    JobSystem* g_jobs    = &jobs;
+Admin* g_admin = 0;
+
+//there is no console window, so messages go to stdout without their color tags
+void Console::PushConsole(std::string s){
+	std::string out;
+	for(u32 i = 0; i < s.size(); ++i){
+		if(s.compare(i, 3, "[c:") == 0 || s.compare(i, 3, "[c]") == 0){
+			size_t end = s.find(']', i);
+			if(end != std::string::npos){ i = end; continue; }
+		}
+		out += s[i];
+	}
+	printf("%s\n", out.c_str());
+}
+
+struct BenchOptions{
+	std::string level;
+	std::string scene = "stacks";
+	u32 bodies  = 1000;
+	u32 ticks   = 600;
+	u32 worlds  = 1;
+	u32 threads = 0;
+	u32 triggers = 0;
+	b32 serial  = false;
+	b32 sleep   = true;
+	b32 simd    = false;
+};
+
+//deterministic so generated scenes are the same on every machine
+struct BenchRandom{
+	u64 state;
+	
+	f32 Next(){ //[0,1)
+		state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+		return f32(state >> 40) / f32(1 << 24);
+	}
+	
+	f32 Range(f32 min, f32 max){ return min + (max - min) * Next(); }
+};
+
+local Physics* BenchBody(PhysicsWorld* world, Vector3 position, Collider* collider, f32 mass, b32 staticPosition, Vector3 scale = Vector3::ONE){
+	Physics* p = new Physics(position, Vector3::ZERO, Vector3::ZERO, Vector3::ZERO, Vector3::ZERO, Vector3::ZERO, .2f, mass, staticPosition);
+	p->scale = scale;
+	world->AddBody(p, collider);
+	return p;
+}
+
+local void BenchFloor(PhysicsWorld* world, f32 halfWidth){
+	BenchBody(world, Vector3(0, -1, 0), new AABBCollider(Vector3(halfWidth, 1, halfWidth), 100000.f), 100000.f, true);
+}
+
+//////////////////
+//// scenes  ////
+//////////////////
+
+//towers of ten boxes standing on a floor in a grid, which settle into long lived resting contacts
+local void SceneStacks(PhysicsWorld* world, u32 bodies){
+	const u32 height = 10;
+	u32 towers = Max((bodies + height-1) / height, 1u);
+	u32 side   = (u32)ceilf(sqrtf((f32)towers));
+	BenchFloor(world, side * 2.f + 4.f);
+	u32 placed = 0;
+	for(u32 tower = 0; tower < towers && placed < bodies; ++tower){
+		f32 x = ((tower % side) - side * .5f) * 4.f;
+		f32 z = ((tower / side) - side * .5f) * 4.f;
+		for(u32 level = 0; level < height && placed < bodies; ++level, ++placed){
+			BenchBody(world, Vector3(x, .5f + level * 1.01f, z), new AABBCollider(Vector3(.5f, .5f, .5f), 1.f), 1.f, false);
+		}
+	}
+}
+
+//spheres and boxes dropped from random heights over a small area so they land on each other in a heap
+local void ScenePiles(PhysicsWorld* world, u32 bodies){
+	BenchRandom random{1};
+	f32 spread = sqrtf((f32)bodies) * .75f + 2.f;
+	BenchFloor(world, spread * 2.f);
+	forI(bodies){
+		Vector3 position(random.Range(-spread, spread), random.Range(2.f, 2.f + bodies * .02f), random.Range(-spread, spread));
+		if(random.Next() < .5f){
+			f32 radius = random.Range(.3f, .7f);
+			BenchBody(world, position, new SphereCollider(radius, 1.f), 1.f, false);
+		}else{
+			Vector3 halfDims(random.Range(.3f, .7f), random.Range(.3f, .7f), random.Range(.3f, .7f));
+			BenchBody(world, position, new AABBCollider(halfDims, 1.f), 1.f, false);
+		}
+	}
+}
+
+//rows of sixteen touching spheres and boxes dropped across static bars so they drape over them like limp ragdolls
+//NOTE there are no joints, so the links are only held together by the contacts between neighbours
+local void SceneChains(PhysicsWorld* world, u32 bodies){
+	const u32 links = 16;
+	u32 chains = Max((bodies + links-1) / links, 1u);
+	BenchFloor(world, chains * 1.5f + links);
+	u32 placed = 0;
+	for(u32 chain = 0; chain < chains && placed < bodies; ++chain){
+		f32 z = (chain - chains * .5f) * 2.5f;
+		BenchBody(world, Vector3(0, 6.f, z), new BoxCollider(Vector3(.25f, .25f, 1.f), 100000.f), 100000.f, true);
+		for(u32 link = 0; link < links && placed < bodies; ++link, ++placed){
+			Vector3 position((link - links * .5f) * .8f, 7.f + (chain % 4) * .5f, z);
+			Collider* collider = (link % 2) ? (Collider*)new SphereCollider(.4f, 1.f) : (Collider*)new AABBCollider(Vector3(.4f, .4f, .4f), 1.f);
+			BenchBody(world, position, collider, 1.f, false);
+		}
+	}
+}
+
+//a swarm of small spheres and cubes drifting without gravity inside a closed box, packed densely enough that every
+//body has a crowd of broadphase candidates within the tree's margin which it mostly doesnt touch
+local void SceneParticles(PhysicsWorld* world, u32 bodies){
+	BenchRandom random{1};
+	world->gravity = 0;
+	f32 half = cbrtf(bodies / 60.f) * .5f + .2f;
+	f32 wall = 1.f;
+	forI(6){
+		Vector3 offset, halfDims(half + wall, half + wall, half + wall);
+		(&offset.x)[i/2] = (i % 2) ? half + wall : -half - wall;
+		(&halfDims.x)[i/2] = wall;
+		BenchBody(world, offset, new AABBCollider(halfDims, 100000.f), 100000.f, true);
+	}
+	forI(bodies){
+		Vector3 position(random.Range(-half, half), random.Range(-half, half), random.Range(-half, half));
+		f32 size = random.Range(.06f, .1f);
+		Collider* collider = (random.Next() < .5f) ? (Collider*)new SphereCollider(size, 1.f) : (Collider*)new AABBCollider(Vector3(size, size, size), 1.f);
+		Physics* p = BenchBody(world, position, collider, 1.f, false);
+		p->velocity = Vector3(random.Range(-1.f, 1.f), random.Range(-1.f, 1.f), random.Range(-1.f, 1.f));
+	}
+}
+
+//static noCollide volumes of every trigger shape spread over the space the scene's bodies start in
+local void SceneTriggers(PhysicsWorld* world, u32 triggers){
+	if(!triggers || world->tuples.empty()) return;
+	Vector3 min = world->tuples[0].physics->position, max = min;
+	for(PhysicsTuple& t : world->tuples){
+		min = Vector3(Min(min.x, t.physics->position.x), Min(min.y, t.physics->position.y), Min(min.z, t.physics->position.z));
+		max = Vector3(Max(max.x, t.physics->position.x), Max(max.y, t.physics->position.y), Max(max.z, t.physics->position.z));
+	}
+	
+	BenchRandom random{2};
+	forI(triggers){
+		Vector3 position(random.Range(min.x, max.x), random.Range(min.y, max.y), random.Range(min.z, max.z));
+		Vector3 halfDims(random.Range(1.f, 3.f), random.Range(1.f, 3.f), random.Range(1.f, 3.f));
+		Collider* collider;
+		switch(i % 3){
+			case 0:  collider = new SphereCollider(halfDims.x, 1.f, 0, Event_NONE, true); break;
+			case 1:  collider = new AABBCollider(halfDims, 1.f, 0, Event_NONE, true); break;
+			default: collider = new BoxCollider(halfDims, 1.f, 0, Event_NONE, true); break;
+		}
+		Physics* p = BenchBody(world, position, collider, 1.f, true);
+		if(i % 3 == 2) p->rotation = Vector3(0, random.Range(0.f, 90.f), 0);
+	}
+}
+
+////////////////
+//// level ////
+////////////////
+
+local Vector3 BenchVec3(const std::string& str){
+	Vector3 v = Vector3::ZERO;
+	sscanf(str.c_str(), " (%f,%f,%f)", &v.x, &v.y, &v.z);
+	return v;
+}
+
+//makes a body for an entity file of a text level (see Entity::LoadTEXT), entities without physics are skipped
+//only the physics, collider, and entity transform sections are read and mesh based colliders arent supported
+local b32 LoadBenchEntity(PhysicsWorld* world, const std::string& filepath){
+	std::ifstream file(filepath);
+	if(!file.is_open()) return false;
+	
+	std::string section, line;
+	Vector3 position = Vector3::ZERO, rotation = Vector3::ZERO, scale = Vector3::ONE;
+	Vector3 velocity = Vector3::ZERO, rotVelocity = Vector3::ZERO, halfDims = Vector3::ONE;
+	f32 elasticity = .2f, mass = 1.f, kinetic = .3f, statik = .42f, radius = 1.f;
+	b32 hasPhysics = false, staticPosition = false, staticRotation = false, twoD = false, continuous = false;
+	std::string colliderType;
+	while(std::getline(file, line)){
+		line = Utils::eatComments(line, "#");
+		line = Utils::eatSpacesLeading(line);
+		line = Utils::eatSpacesTrailing(line);
+		if(!line.empty() && line.back() == '\r') line.pop_back();
+		if(line.empty()) continue;
+		if(line[0] == '>'){
+			section = line.substr(1);
+			if(section == "physics") hasPhysics = true;
+			continue;
+		}
+		
+		size_t split = line.find_first_of(" \t");
+		if(split == std::string::npos) continue;
+		std::string key = line.substr(0, split);
+		std::string value = Utils::eatSpacesLeading(line.substr(split));
+		if(section == "entity"){
+			if     (key == "position") position = BenchVec3(value);
+			else if(key == "rotation") rotation = BenchVec3(value);
+			else if(key == "scale")    scale    = BenchVec3(value);
+		}else if(section == "physics"){
+			if     (key == "velocity")         velocity       = BenchVec3(value);
+			else if(key == "rot_velocity")     rotVelocity    = BenchVec3(value);
+			else if(key == "elasticity")       elasticity     = std::stof(value);
+			else if(key == "mass")             mass           = std::stof(value);
+			else if(key == "friction_kinetic") kinetic        = std::stof(value);
+			else if(key == "friction_static")  statik         = std::stof(value);
+			else if(key == "static_position")  staticPosition = (value == "true" || value == "1");
+			else if(key == "static_rotation")  staticRotation = (value == "true" || value == "1");
+			else if(key == "twod")             twoD           = (value == "true" || value == "1");
+			else if(key == "continuous")       continuous     = (value == "true" || value == "1");
+		}else if(section == "collider"){
+			if     (key == "type" && colliderType.empty()) colliderType = value;
+			else if(key == "half_dims") halfDims = BenchVec3(value);
+			else if(key == "radius")    radius   = std::stof(value);
+		}
+	}
+	if(!hasPhysics) return false;
+	
+	Collider* collider = 0;
+	if     (colliderType == "aabb"   || colliderType == "2") collider = new AABBCollider(halfDims, mass);
+	else if(colliderType == "box"    || colliderType == "1") collider = new BoxCollider(halfDims, mass);
+	else if(colliderType == "sphere" || colliderType == "3") collider = new SphereCollider(radius, mass);
+	else if(!colliderType.empty()) printf("skipping the %s collider of '%s', mesh colliders need the renderer's meshes\n", colliderType.c_str(), filepath.c_str());
+	
+	Physics* p = new Physics(position, rotation, velocity, Vector3::ZERO, rotVelocity, Vector3::ZERO, elasticity, mass, staticPosition,
+							 staticRotation, twoD, kinetic, statik);
+	p->scale      = scale;
+	p->continuous = continuous;
+	world->AddBody(p, collider);
+	return true;
+}
+
+local b32 LoadBenchLevel(PhysicsWorld* world, std::string level){
+	namespace fs = std::filesystem;
+	if(!fs::is_directory(level)) level = "data/levels/" + level;
+	if(!fs::is_directory(level)){
+		printf("failed to find the level directory: %s\n", level.c_str());
+		return false;
+	}
+	
+	//sorted so the tuple order, and so the hash, doesnt depend on the filesystem
+	std::vector<std::string> files;
+	for(const fs::directory_entry& entry : fs::directory_iterator(level)){
+		if(entry.is_regular_file() && entry.path().filename() != "_") files.push_back(entry.path().string());
+	}
+	std::sort(files.begin(), files.end());
+	for(std::string& file : files) LoadBenchEntity(world, file);
+	return true;
+}
+
+/////////////////
+//// running ////
+/////////////////
+
+struct BenchResult{
+	f64 totalTime; //milliseconds
+	f64 stageTimes[PhysicsStage_COUNT];
+	f64 maxStepTime;
+	u64 pairsTested;
+	u64 pairsFound;
+	u64 collisions;
+	u64 stepAllocations;
+	u32 lastAllocatingTick; //containers only grow until the scene settles, after this tick every step allocated nothing
+	u64 triggerTests;
+	u64 triggerEvents;
+	u32 sleeping;
+	u64 hash;
+};
+
+//FNV-1a over the bits of every body's state, so any change to the simulation changes it
+local u64 HashWorld(PhysicsWorld* world){
+	u64 hash = 14695981039346656037ULL;
+	auto add = [&](f32 value){
+		u32 bits;
+		memcpy(&bits, &value, sizeof(bits));
+		forI(4){
+			hash ^= (bits >> (i*8)) & 0xFF;
+			hash *= 1099511628211ULL;
+		}
+	};
+	for(PhysicsTuple& t : world->tuples){
+		Physics* p = t.physics;
+		add(p->position.x);    add(p->position.y);    add(p->position.z);
+		add(p->rotation.x);    add(p->rotation.y);    add(p->rotation.z);
+		add(p->velocity.x);    add(p->velocity.y);    add(p->velocity.z);
+		add(p->rotVelocity.x); add(p->rotVelocity.y); add(p->rotVelocity.z);
+	}
+	return hash;
+}
+
+local void BuildBenchWorld(PhysicsWorld* world, BenchOptions& options){
+	world->Init(1.f / 60.f);
+	world->parallelNarrowphase = !options.serial;
+	world->sleepEnabled        = options.sleep;
+	world->simdNarrowphase     = options.simd;
+	if(!options.level.empty()){
+		LoadBenchLevel(world, options.level);
+	}else if(options.scene == "piles"){
+		ScenePiles(world, options.bodies);
+	}else if(options.scene == "chains"){
+		SceneChains(world, options.bodies);
+	}else if(options.scene == "particles"){
+		SceneParticles(world, options.bodies);
+	}else{
+		if(options.scene != "stacks") printf("unknown scene '%s', using stacks\n", options.scene.c_str());
+		SceneStacks(world, options.bodies);
+	}
+	SceneTriggers(world, options.triggers);
+}
+
+local void RunBenchWorld(PhysicsWorld* world, u32 ticks, BenchResult* result){
+	*result = BenchResult{};
+	TIMER_START(total);
+	forI(ticks){
+		TIMER_START(step);
+		world->Step();
+		f64 stepTime = TIMER_END(step);
+		result->maxStepTime = Max(result->maxStepTime, stepTime);
+		forX(stage, PhysicsStage_COUNT) result->stageTimes[stage] += world->stageTimes[stage];
+		result->pairsTested     += world->pairsTested;
+		result->pairsFound      += world->pairsFound;
+		result->collisions      += world->collisionCount;
+		result->stepAllocations += world->stepAllocations;
+		if(world->stepAllocations) result->lastAllocatingTick = i + 1;
+		result->triggerTests    += world->triggerTests;
+		result->triggerEvents   += world->triggerEvents.size();
+		world->triggerEvents.clear(); //nothing else reads them, so they'd pile up
+	}
+	result->totalTime = TIMER_END(total);
+	result->sleeping  = world->sleepingCount;
+	result->hash      = HashWorld(world);
+}
+
+local void ParseOptions(int argc, char** argv, BenchOptions& options){
+	for(int i = 1; i < argc; ++i){
+		std::string arg = argv[i];
+		b32 hasValue = (i+1 < argc);
+		if     (arg == "-level"   && hasValue) options.level   = argv[++i];
+		else if(arg == "-scene"   && hasValue) options.scene   = argv[++i];
+		else if(arg == "-bodies"  && hasValue) options.bodies  = (u32)atoi(argv[++i]);
+		else if(arg == "-ticks"   && hasValue) options.ticks   = (u32)atoi(argv[++i]);
+		else if(arg == "-worlds"  && hasValue) options.worlds  = (u32)atoi(argv[++i]);
+		else if(arg == "-threads" && hasValue) options.threads = (u32)atoi(argv[++i]);
+		else if(arg == "-triggers" && hasValue) options.triggers = (u32)atoi(argv[++i]);
+		else if(arg == "-serial")  options.serial = true;
+		else if(arg == "-nosleep") options.sleep  = false;
+		else if(arg == "-simd")    options.simd   = true;
+		else printf("unknown argument '%s'\n", arg.c_str());
+	}
+	if(options.worlds == 0) options.worlds = 1;
+}
+
+int main(int argc, char** argv){
+	BenchOptions options;
+	ParseOptions(argc, argv, options);
+	if(!options.serial) jobs.Init(options.threads);
+	
+	//the component pools arent thread safe, so the worlds are built before any of them step
+	std::vector<PhysicsWorld> worlds(options.worlds);
+	for(PhysicsWorld& world : worlds) BuildBenchWorld(&world, options);
+	if(worlds[0].tuples.empty()){
+		printf("the scene has no bodies\n");
+		return 1;
+	}
+	
+	std::vector<BenchResult> results(worlds.size());
+	if(worlds.size() == 1){
+		RunBenchWorld(&worlds[0], options.ticks, &results[0]);
+	}else{
+		std::vector<std::thread> threads;
+		forI(worlds.size()) threads.push_back(std::thread(RunBenchWorld, &worlds[i], options.ticks, &results[i]));
+		for(std::thread& t : threads) t.join();
+	}
+	
+	BenchResult& r = results[0];
+	f64 ticks = (f64)options.ticks;
+	printf("scene        %s\n", (options.level.empty()) ? options.scene.c_str() : options.level.c_str());
+	printf("bodies       %zu\n", worlds[0].tuples.size());
+	printf("ticks        %u\n", options.ticks);
+	printf("workers      %u%s\n", Max(jobs.workerCount, 1u), (options.serial) ? " (serial narrowphase)" : "");
+	printf("total        %.3f ms  (%.4f ms/tick, worst %.4f ms)\n", r.totalTime, r.totalTime / ticks, r.maxStepTime);
+	forI(PhysicsStage_COUNT){
+		printf("  %-12s %10.3f ms  %8.4f ms/tick\n", PhysicsStageStrings[i], r.stageTimes[i], r.stageTimes[i] / ticks);
+	}
+	printf("pairs tested %llu  (%.1f/tick)\n", (unsigned long long)r.pairsTested, r.pairsTested / ticks);
+	printf("pairs found  %llu  (%.1f/tick)\n", (unsigned long long)r.pairsFound, r.pairsFound / ticks);
+	printf("narrowphase  %llu checks\n", (unsigned long long)r.collisions);
+	printf("trigger      %llu tests  %llu events\n", (unsigned long long)r.triggerTests, (unsigned long long)r.triggerEvents);
+	printf("step allocs  %llu  (none after tick %u)\n", (unsigned long long)r.stepAllocations, r.lastAllocatingTick);
+	printf("sleeping     %u\n", r.sleeping);
+	printf("hash         %016llx\n", (unsigned long long)r.hash);
+	
+	//every copy ran the same scene, so they have to agree with each other
+	b32 diverged = false;
+	for(u32 i = 1; i < results.size(); ++i){
+		if(results[i].hash != r.hash){
+			printf("world %u diverged: hash %016llx\n", i, (unsigned long long)results[i].hash);
+			diverged = true;
+		}
+	}
+	if(worlds.size() > 1 && !diverged) printf("all %zu worlds matched\n", worlds.size());
+	
+	//the kernels only skip pairs the per-pair tests would have found apart, so without them the bodies end the same
+	if(options.simd){
+		BenchOptions scalarOptions = options;
+		scalarOptions.simd = false;
+		PhysicsWorld scalar;
+		BuildBenchWorld(&scalar, scalarOptions);
+		BenchResult scalarResult;
+		RunBenchWorld(&scalar, options.ticks, &scalarResult);
+		if(scalarResult.hash != r.hash){
+			printf("scalar narrowphase diverged: hash %016llx\n", (unsigned long long)scalarResult.hash);
+			diverged = true;
+		}else{
+			printf("scalar narrowphase matched\n");
+		}
+		scalar.Cleanup();
+	}
+	
+	for(PhysicsWorld& world : worlds) world.Cleanup();
+	if(!options.serial) jobs.Cleanup();
+	return (diverged) ? 1 : 0;
+}
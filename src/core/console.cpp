@@ -14,6 +14,7 @@
 #include "../game/components/Player.h"
 #include "../game/components/Movement.h"
 #include "../game/entities/Trigger.h"
+#include "../game/systems/PhysicsIntegrator.h"
 #include "../external/imgui/imgui_impl_glfw.h"
 #include "../external/imgui/imgui_impl_vulkan.h"
 
@@ -433,6 +434,7 @@ void Console::DrawConsole() {
 //this must be a separate funciton because TextEditCallback had a fit when I tried
 //making this the main AddLog function
 void Console::PushConsole(std::string s) {
+	std::lock_guard<std::mutex> lock(pushLock);
 	AddLog(s);
 }
 
@@ -605,9 +607,42 @@ CMDFUNC(time_engine){
 
 CMDFUNC(time_game){
 	return admin->FormatAdminTime("Layers:  Physics:{P}ms Canvas:{C}ms World:{W}ms Send:{S}ms Last:{L}ms\n"
-								  "Systems: Physics:{p}ms Canvas:{c}ms World:{w}ms Send:{s}ms");
+								  "Systems: Physics:{p}ms Canvas:{c}ms World:{w}ms Send:{s}ms\n"
+								  "Scheduled: Wall:{A}ms Critical:{R}ms Serial:{T}ms");
 }
 
+//times the scalar and SIMD integrators over the same random bodies, optional arg is the body count
+CMDSTART(phys_bench_integrate){
+	u32 count = (args.size() > 0) ? (u32)std::stoi(args[0]) : 10000;
+	if(!count) return "[c:red]Body count must be greater than 0[c]";
+	
+	PhysicsBodiesSoA scalar;
+	scalar.Resize(count);
+	forI(count){
+		auto rnd = [](){ return f32(rand() % 2000) / 100.f - 10.f; };
+		scalar.Set(i, Vector3(rnd(), rnd(), rnd()), Vector3(rnd(), rnd(), rnd()), Vector3::ZERO,
+				   Vector3(rnd(), rnd(), rnd()), 1.f + f32(rand() % 10), (rand() % 8) == 0);
+	}
+	PhysicsBodiesSoA simd = scalar;
+	PhysicsIntegrateParams params{DengTime->fixedDeltaTime, admin->physics.gravity, admin->physics.frictionAir * 9.807f,
+		admin->physics.minVelocity, admin->physics.maxVelocity};
+	
+	TIMER_START(bench);
+	IntegrateBodiesScalar(scalar, params);
+	f32 scalarTime = TIMER_END(bench);
+	TIMER_RESET(bench);
+	IntegrateBodiesSIMD(simd, params);
+	f32 simdTime = TIMER_END(bench);
+	
+	f32 maxDiff = 0;
+	forI(count){
+		maxDiff = Max(maxDiff, (Vector3(scalar.px[i], scalar.py[i], scalar.pz[i]) - Vector3(simd.px[i], simd.py[i], simd.pz[i])).mag());
+		maxDiff = Max(maxDiff, (Vector3(scalar.vx[i], scalar.vy[i], scalar.vz[i]) - Vector3(simd.vx[i], simd.vy[i], simd.vz[i])).mag());
+	}
+	return TOSTRING(count, " bodies  scalar: ", scalarTime, "ms  simd: ", simdTime, "ms  speedup: ",
+					scalarTime / Max(simdTime, 1e-6f), "x  max difference: ", maxDiff);
+}CMDEND("phys_bench_integrate <count:Uint>");
+
 CMDFUNC(undo){
 	admin->editor.undo_manager.Undo(); return "";
 }
@@ -693,6 +728,7 @@ CMDSTARTA(load_obj, args.size() > 0){
 	f32 mass = 1.f, elasticity = .5f; b32 staticPosition = 1, twoDphys = false;
 	ColliderType ctype = ColliderType_NONE;
 	Event event = 0;
+	ConvexHullParams hullParams;
 	//check for optional params after the first arg
 	for (auto s = args.begin() + 1; s != args.end(); ++s) {
 		if (std::regex_search(s->c_str(), m, Vec3Regex("pos"))){
@@ -727,6 +763,12 @@ CMDSTARTA(load_obj, args.size() > 0){
 				found = true; event = (u32)i;  break;
 			}
 			if (!found) return TOSTRING("[c:red]Unknown event '", m[1], "'");
+		} else if (std::regex_search(s->c_str(), m, IntRegex("hull_vertices"))) {
+			if(std::stoi(m[1]) < 4) return "[c:red]Hulls need at least 4 vertices[c]";
+			hullParams.maxVertices = std::stoi(m[1]);
+		} else if (std::regex_search(s->c_str(), m, IntRegex("hulls"))) {
+			if(std::stoi(m[1]) < 1) return "[c:red]Complex colliders need at least 1 hull[c]";
+			hullParams.maxHulls = std::stoi(m[1]);
 		} else {
 			return "[c:red]Invalid parameter: " + *s + "[c]";
 		}
@@ -747,7 +789,7 @@ CMDSTARTA(load_obj, args.size() > 0){
 		case ColliderType_Sphere:    col = new SphereCollider(1, 1, 0U, event); break;
 		case ColliderType_Landscape: col = new LandscapeCollider(mesh, 0U, event); break;
 		case ColliderType_Box:       col = new BoxCollider(Vector3(1, 1, 1), 1, 0U, event); break;
-		case ColliderType_Complex:   col = new ComplexCollider(mesh, 0, event); break;
+		case ColliderType_Complex:   col = new ComplexCollider(mesh, 0, event, 0, hullParams); break;
 	}
 	
 	MeshComp* mc = new MeshComp(id);
@@ -757,7 +799,7 @@ CMDSTARTA(load_obj, args.size() > 0){
 	admin->CreateEntity({ mc, p, s, col }, name, Transform(pos, rot, scale));
 	
 	return TOSTRING("Loaded mesh ", args[0], " to ID: ", id);
-}CMDEND("load_obj <model.obj:String> -pos=(x,y,z) -rot=(x,y,z) -scale=(x,y,z) -collider=String{aabb|sphere} -mass=Float -static=Bool");
+}CMDEND("load_obj <model.obj:String> -pos=(x,y,z) -rot=(x,y,z) -scale=(x,y,z) -collider=String{aabb|sphere} -mass=Float -static=Bool -hull_vertices=Int -hulls=Int");
 
 CMDSTART(spawn_box_uv){
 	Vector3 pos{}, rot{}, scale = vec3::ONE;
@@ -926,7 +968,12 @@ CMDSTARTA(add_force, args.size() > 0) {
 	std::cmatch m;
 	for (std::string s : args) {
 		if (std::regex_search(s.c_str(), m, Vec3Regex("force"))) {
-			if(Physics* p = admin->editor.selected[0]->GetComponent<Physics>()){
+			Entity* sel = admin->editor.selected.size() ? admin->GetEntity(admin->editor.selected[0]) : 0;
+			if(!sel){
+				ERROR("No object selected");
+				return "";
+			}
+			if(Physics* p = sel->GetComponent<Physics>()){
 				p->AddForce(nullptr, Vector3(std::stof(m[1]), std::stof(m[2]), std::stof(m[3])));
 				return "";
 			}else{
@@ -1272,6 +1319,7 @@ void Console::AddCommands(){
 	CMDADD(daytime, "Logs the time in day-time format");
 	CMDADD(time_engine, "Logs the engine times");
 	CMDADD(time_game, "Logs the game times");
+	CMDADD(phys_bench_integrate, "Times the scalar and SIMD physics integrators over random bodies");
 	CMDADD(undo, "Undos previous level editor action");
 	CMDADD(redo, "Redos last undone level editor action");
 	CMDADD(add_player, "Adds a player to the world.");
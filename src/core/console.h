@@ -10,6 +10,7 @@
 #include <vector>
 #include <string>     // std::string, std::stoi
 #include <map>
+#include <mutex>
 
 struct ImGuiInputTextCallbackData;
 struct Command;
@@ -26,6 +27,7 @@ struct Console  {
 	std::string alert_message;
 	Color alert_color = Color::RED;
 	bool show_alert = false;
+	std::mutex pushLock; //components updated on job threads can log, so pushes are serialized
 	
 	bool dispcon = false;
 	bool autoScroll = true;
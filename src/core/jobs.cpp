@@ -0,0 +1,101 @@
+#include "jobs.h"
+#include "console.h"
+
+local thread_local u32 workerIndex = -1; //threads the job system didnt start arent workers
+
+//the calling thread's deque, threads that arent workers (the physics thread, other systems' threads) share the last one
+local u32 DequeIndex(JobSystem* js){
+	return (workerIndex < js->workerCount) ? workerIndex : js->workerCount;
+}
+
+local void WorkerLoop(JobSystem* js, u32 index){
+	workerIndex = index;
+	while(js->running){
+		if(js->RunOne(index)) continue;
+
+		//sleep until a job is submitted, the timeout covers a submit that races the check
+		std::unique_lock<std::mutex> lock(js->sleepLock);
+		js->sleepCV.wait_for(lock, std::chrono::milliseconds(1), [js](){ return js->queued > 0 || !js->running; });
+	}
+}
+
+void JobSystem::Init(u32 threadCount){
+	if(threadCount == 0) threadCount = Max(std::thread::hardware_concurrency(), 1u);
+	workerCount = threadCount;
+	workers = new Worker[workerCount+1];
+	workerIndex = 0; //the thread that called Init
+	running = true;
+
+	threads.reserve(workerCount-1);
+	for(u32 i = 1; i < workerCount; ++i){
+		threads.push_back(std::thread(WorkerLoop, this, i));
+	}
+	SUCCESS("Started job system with ", workerCount, " workers");
+}
+
+void JobSystem::Cleanup(){
+	running = false;
+	sleepCV.notify_all();
+	for(std::thread& t : threads) t.join();
+	threads.clear();
+	delete[] workers;
+	workers = 0;
+	workerCount = 0;
+}
+
+void JobSystem::Submit(std::function<void()> fn, JobCounter* counter){
+	if(counter) counter->value++;
+	if(!workerCount){ //not initialized, run it now
+		fn();
+		if(counter) counter->value--;
+		return;
+	}
+
+	Worker& w = workers[DequeIndex(this)];
+	{
+		std::lock_guard<std::mutex> lock(w.lock);
+		w.jobs.push_back(Job{std::move(fn), counter});
+	}
+	queued++;
+	sleepCV.notify_one();
+}
+
+b32 JobSystem::RunOne(u32 worker){
+	Job job;
+	b32 found = false;
+
+	//own deque first, newest job since its data is most likely still in cache
+	{
+		Worker& w = workers[worker];
+		std::lock_guard<std::mutex> lock(w.lock);
+		if(w.jobs.size() > w.head){
+			job = std::move(w.jobs.back());
+			w.jobs.pop_back();
+			found = true;
+		}
+		if(w.jobs.size() == w.head){ w.jobs.clear(); w.head = 0; }
+	}
+
+	//steal the oldest job from someone else, starting after ourselves so thieves spread out
+	for(u32 i = 1; !found && i <= workerCount; ++i){
+		Worker& w = workers[(worker + i) % (workerCount+1)];
+		std::lock_guard<std::mutex> lock(w.lock);
+		if(w.jobs.size() > w.head){
+			job = std::move(w.jobs[w.head++]);
+			found = true;
+		}
+		if(w.jobs.size() == w.head){ w.jobs.clear(); w.head = 0; }
+	}
+	if(!found) return false;
+
+	queued--;
+	job.fn();
+	if(job.counter) job.counter->value--;
+	return true;
+}
+
+void JobSystem::Wait(JobCounter* counter){
+	while(counter->value > 0){
+		if(!RunOne(DequeIndex(this))) std::this_thread::yield();
+	}
+}
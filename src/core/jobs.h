@@ -0,0 +1,92 @@
+#pragma once
+#ifndef DESHI_JOBS_H
+#define DESHI_JOBS_H
+
+#include "../defines.h"
+
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <functional>
+#include <condition_variable>
+
+//a counter that is incremented for every job submitted with it and decremented when the job finishes,
+//so waiting on it waits for all of those jobs
+struct JobCounter{
+	std::atomic<u32> value{0};
+};
+
+struct Job{
+	std::function<void()> fn;
+	JobCounter* counter;
+};
+
+//fixed pool of worker threads, each with its own deque of jobs. a worker pops from the back of its own
+//deque and when that is empty it steals from the front of another worker's deque. the thread that called
+//Init is worker 0 and only runs jobs while it is in Wait. threads the job system didnt start share one extra
+//deque after the workers' so they never push onto a worker's own deque
+//the deques are vectors with a moving front that reset once they empty out, so they keep their memory
+//and steady frames dont allocate to queue jobs
+struct JobSystem{
+	struct Worker{
+		std::vector<Job> jobs;
+		u32 head = 0; //front of the deque, jobs before it were stolen
+		std::mutex lock;
+	};
+
+	std::vector<std::thread> threads;
+	Worker* workers = 0; //workerCount+1, the last is the shared one
+	u32 workerCount = 0;
+	std::atomic<u32> queued{0}; //jobs sitting in deques, not counting running ones
+	std::atomic<b32> running{false};
+	std::mutex sleepLock;
+	std::condition_variable sleepCV;
+
+	//threadCount of 0 uses one worker per hardware thread
+	void Init(u32 threadCount = 0);
+	void Cleanup();
+
+	//queues fn on the calling thread's deque, counter may be 0 if nothing will wait on it
+	void Submit(std::function<void()> fn, JobCounter* counter);
+
+	//runs queued jobs on the calling thread until counter reaches zero
+	void Wait(JobCounter* counter);
+
+	//pops a job from this thread's deque or steals one, returns false if there was nothing to run
+	b32 RunOne(u32 worker);
+};
+
+//global_ job system pointer
+extern JobSystem* g_jobs;
+#define DengJobs g_jobs
+
+//calls fn(start, end) over [0, count) split into batches of batchSize and waits for all of them
+//runs inline if there would only be one batch or there are no worker threads
+template<class F>
+inline void parallel_for(u32 count, u32 batchSize, F fn){
+	if(count == 0) return;
+	if(batchSize == 0) batchSize = 1;
+	if(count <= batchSize || !DengJobs || DengJobs->workerCount < 2){
+		fn(u32(0), count);
+		return;
+	}
+
+	JobCounter counter;
+	for(u32 start = batchSize; start < count; start += batchSize){
+		u32 end = Min(start + batchSize, count);
+		DengJobs->Submit([&fn, start, end](){ fn(start, end); }, &counter);
+	}
+	fn(u32(0), batchSize); //the first batch runs on the calling thread
+	DengJobs->Wait(&counter);
+}
+
+//calls fn(item) for every item of the vector using parallel_for
+template<class T, class F>
+inline void parallel_for_each(std::vector<T>& items, u32 batchSize, F fn){
+	parallel_for(items.size(), batchSize, [&](u32 start, u32 end){
+		for(u32 i = start; i < end; ++i) fn(items[i]);
+	});
+}
+
+#endif //DESHI_JOBS_H
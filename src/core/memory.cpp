@@ -0,0 +1,64 @@
+#include "memory.h"
+
+#if DESHI_INTERNAL
+#include <new>
+#include <cstdlib>
+
+local thread_local u64 heapAllocations = 0;
+
+u64 ThreadHeapAllocations(){
+	return heapAllocations;
+}
+
+//the aligned overloads are left alone, they pair with their own deletes and nothing hot uses them
+void* operator new(size_t size){
+	heapAllocations++;
+	void* result = malloc((size) ? size : 1);
+	if(!result) throw std::bad_alloc();
+	return result;
+}
+
+void* operator new[](size_t size){
+	return operator new(size);
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept{
+	heapAllocations++;
+	return malloc((size) ? size : 1);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept{
+	return operator new(size, std::nothrow);
+}
+
+void operator delete(void* ptr) noexcept{
+	free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept{
+	free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept{
+	free(ptr);
+}
+
+void operator delete[](void* ptr, size_t) noexcept{
+	free(ptr);
+}
+
+void operator delete(void* ptr, const std::nothrow_t&) noexcept{
+	free(ptr);
+}
+
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept{
+	free(ptr);
+}
+
+#else //DESHI_INTERNAL
+
+u64 ThreadHeapAllocations(){
+	return 0;
+}
+
+#endif //DESHI_INTERNAL
@@ -0,0 +1,14 @@
+#pragma once
+#ifndef DESHI_MEMORY_H
+#define DESHI_MEMORY_H
+
+#include "../defines.h"
+
+//global operator new and delete are replaced in memory.cpp so heap allocations can be counted,
+//the count is per thread so a system can measure its own allocations while other threads run
+//only DESHI_INTERNAL builds replace them (the physics bench always does), the others leave the heap alone
+
+//heap allocations made by the calling thread since it started, always 0 without DESHI_INTERNAL
+u64 ThreadHeapAllocations();
+
+#endif //DESHI_MEMORY_H
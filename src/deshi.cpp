@@ -182,6 +182,7 @@ __________ maybe store the text in the actual source and create the file from th
 #include "core/console2.h"
 #include "core/imgui.h"
 #include "core/input.h"
+#include "core/jobs.h"
 #include "core/renderer.h"
 #include "core/time.h"
 #include "core/window.h"
@@ -193,6 +194,7 @@ local Input   input;   Input*   g_input   = &input;
 local Console console; Console* g_console = &console;
 local Admin   admin;   Admin*   g_admin   = &admin;
 local Debug   debug;   Debug*   g_debug   = &debug;
+local JobSystem jobs;  JobSystem* g_jobs  = &jobs;
 
 int main() {
 	TIMER_START(t_d); TIMER_START(t_f); TIMER_START(t_s);
@@ -200,9 +202,10 @@ int main() {
 	Assets::enforceDirectories();
 	
 	//init engine core
-	TIMER_RESET(t_s); time_.Init(300);        SUCCESS("Finished time initialization in ", TIMER_END(t_s), "ms");
+	TIMER_RESET(t_s); time_.Init(60);         SUCCESS("Finished time initialization in ", TIMER_END(t_s), "ms");
 	TIMER_RESET(t_s); window.Init(1280, 720); SUCCESS("Finished input and window initialization in ", TIMER_END(t_s), "ms");
 	TIMER_RESET(t_s); console.Init(); Console2::Init(); SUCCESS("Finished console initialization in ", TIMER_END(t_s), "ms");
+	TIMER_RESET(t_s); jobs.Init();            SUCCESS("Finished job system initialization in ", TIMER_END(t_s), "ms");
 	TIMER_RESET(t_s); Render::Init();         SUCCESS("Finished render initialization in ", TIMER_END(t_s), "ms");
 	TIMER_RESET(t_s); DeshiImGui::init();     SUCCESS("Finished imgui initialization in ", TIMER_END(t_s), "ms");
 	SUCCESS("Finished deshi initialization in ", TIMER_END(t_d), "ms");
@@ -218,11 +221,15 @@ int main() {
 		DeshiImGui::newFrame();                                                         //place imgui calls after this
 		TIMER_RESET(t_d); time_.Update();           time_.timeTime   = TIMER_END(t_d);
 		TIMER_RESET(t_d); window.Update();          time_.windowTime = TIMER_END(t_d);
+		admin.physics.worldLock.lock(); //game state is only touched while holding this so a physics thread can step during rendering
 		TIMER_RESET(t_d); input.Update();           time_.inputTime  = TIMER_END(t_d);
 		TIMER_RESET(t_d); admin.Update();           time_.adminTime  = TIMER_END(t_d);
 		TIMER_RESET(t_d); console.Update(); Console2::Update(); time_.consoleTime = TIMER_END(t_d);
+		admin.physics.worldLock.unlock();
 		TIMER_RESET(t_d); Render::Update();         time_.renderTime = TIMER_END(t_d);  //place imgui calls before this
+		admin.physics.worldLock.lock();
 		TIMER_RESET(t_d); admin.PostRenderUpdate(); time_.adminTime += TIMER_END(t_d);
+		admin.physics.worldLock.unlock();
 		g_debug->Update(); //TODO(sushi) put a timer on this
 		time_.frameTime = TIMER_END(t_f); TIMER_RESET(t_f);
 	}
@@ -233,6 +240,7 @@ int main() {
 	Render::Cleanup();
 	window.Cleanup();
 	console.CleanUp(); Console2::Cleanup();
+	jobs.Cleanup();
 	
 #if 0
 	DEBUG_BREAK;
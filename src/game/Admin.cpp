@@ -12,6 +12,7 @@
 #include "components/AudioSource.h"
 #include "components/AudioListener.h"
 #include "../core/time.h"
+#include "../core/jobs.h"
 #include "../core/renderer.h"
 #include "../core/window.h"
 #include "../core/assets.h"
@@ -25,6 +26,8 @@
 
 TIMER_START(t_a);
 
+void UpdateLayer(ComponentLayer layer);
+
 void Admin::Init() {
     //decide initial gamestate
 #if defined(DESHI_BUILD_PLAY)
@@ -44,7 +47,6 @@ void Admin::Init() {
     entities.reserve(1000);
     creationBuffer.reserve(100);
     deletionBuffer.reserve(100);
-    forI(ComponentLayer_World+1) freeCompLayers.push_back(ContainerManager<Component*>());
     
     //init singletons
     physics.Init(this);
@@ -57,6 +59,23 @@ void Admin::Init() {
     editor.Init(this);
     mainCamera = editor.camera;//TODO(delle) remove this eventually
     
+    //schedule layers and systems in their serial order, the scheduler overlaps the ones that dont conflict
+    //NOTE sushi: we need to maybe make a pause_phys_layer thing, because things unrelated to physics in that layer arent getting updated in editor. eg. lights
+    //			  or we can just have different update blocks for different game states
+    scheduler.Clear();
+    scheduler.Add("physics layer", {ComponentType_Transform, ComponentType_Light | ComponentType_OrbManager | ComponentType_Player, true}, &physLyrTime,
+                  [this](){ if(!skip && /*!pause_phys &&*/ !paused){ UpdateLayer(ComponentLayer_Physics); } });
+    scheduler.Add("physics system", physics.access, &physSysTime,
+                  [this](){ if(!skip && !pause_phys && !paused){ physics.Update(); } });
+    scheduler.Add("canvas layer", {ComponentType_Transform, ComponentType_MeshComp, false}, &canvasLyrTime,
+                  [this](){ if(!skip && !pause_canvas){ UpdateLayer(ComponentLayer_Canvas); } });
+    scheduler.Add("canvas system", canvas.access, &canvasSysTime,
+                  [this](){ if(!skip && !pause_canvas){ canvas.Update(); } });
+    scheduler.Add("sound layer", {ComponentType_Transform, ComponentType_AudioSource | ComponentType_AudioListener, false}, &sndLyrTime,
+                  [this](){ if(!skip && !pause_sound && !paused){ UpdateLayer(ComponentLayer_Sound); } });
+    scheduler.Add("sound system", sound.access, &sndSysTime,
+                  [this](){ if(!skip && !pause_sound && !paused){ sound.Update(); } });
+    
     //default values
     player = 0;
     skip = false;
@@ -68,16 +87,44 @@ void Admin::Init() {
 }
 
 void Admin::Cleanup() {
+    physics.StopThread();
     SaveDESH((state == GameState_Editor) ? "temp.desh" : "auto.desh");
 	keybinds.save();
 }
 
-void UpdateLayer(ContainerManager<Component*> cl) {
-    forI(cl.size()) {
-        if (cl[i]) {
-            cl[i].value->Update();
-        }
-    }
+//calls fn with every component type's pool
+template<class F>
+inline void ForEachComponentPool(F fn){
+    fn(AudioListener::pool);
+    fn(AudioSource::pool);
+    fn(Camera::pool);
+    fn(Door::pool);
+    fn(Light::pool);
+    fn(MeshComp::pool);
+    fn(Movement::pool);
+    fn(OrbManager::pool);
+    fn(Physics::pool);
+    fn(Player::pool);
+    fn(BoxCollider::pool);
+    fn(AABBCollider::pool);
+    fn(SphereCollider::pool);
+    fn(LandscapeCollider::pool);
+    fn(ComplexCollider::pool);
+}
+
+//updates the components in a layer by walking each type's packed pool
+//thread-safe components are split across the job system once the rest of their pool has updated
+void UpdateLayer(ComponentLayer layer) {
+    persist thread_local std::vector<Component*> jobComps; //layers can be updated at the same time by the scheduler
+    ForEachComponentPool([layer](auto& pool){
+        jobComps.clear();
+        pool.ForEach([layer](auto* c){
+            if(!c->inLayer || c->layer != layer) return;
+            if(c->threadSafe) jobComps.push_back(c);
+            else c->Update();
+        });
+        parallel_for_each(jobComps, 64, [](Component* c){ c->Update(); });
+    });
 }
 
 void Admin::Update() {
@@ -86,35 +133,37 @@ void Admin::Update() {
     if(!skip) controller.Update();
     if(!skip) mainCamera->Update();
     
-    //NOTE sushi: we need to maybe make a pause_phys_layer thing, because things unrelated to physics in that layer arent getting updated in editor. eg. lights
-    //			  or we can just have different update blocks for different game states
-    TIMER_RESET(t_a); 
-    if(!skip && /*!pause_phys &&*/ !paused)  { UpdateLayer(freeCompLayers[ComponentLayer_Physics]); }
-    physLyrTime =   TIMER_END(t_a); TIMER_RESET(t_a);
-    if(!skip && !pause_phys && !paused) { physics.Update(); }
-    physSysTime =   TIMER_END(t_a); TIMER_RESET(t_a);
-    if(!skip && !pause_canvas)          { UpdateLayer(freeCompLayers[ComponentLayer_Canvas]); }
-    canvasLyrTime = TIMER_END(t_a); TIMER_RESET(t_a);
-    if(!skip && !pause_canvas)          { canvas.Update(); }
-    canvasSysTime = TIMER_END(t_a); TIMER_RESET(t_a);
-    if(!skip && !pause_sound && !paused){ UpdateLayer(freeCompLayers[ComponentLayer_Sound]); }
-    sndLyrTime =    TIMER_END(t_a); TIMER_RESET(t_a);
-    if(!skip && !pause_sound && !paused){ sound.Update(); }
-    sndSysTime =    TIMER_END(t_a);
+    //layer and system times are how long each one ran for, they can overlap now
+    scheduler.Run();
+    DispatchEvents(); //events sent by the layers and systems are delivered here in one batch
     ImGui::EndDebugLayer();
 }
 
 void Admin::PostRenderUpdate(){ //no imgui stuff allowed b/c rendering already happened
     TIMER_RESET(t_a);
-    if (!skip && !pause_world) UpdateLayer(freeCompLayers[ComponentLayer_World]); 
+    if (!skip && !pause_world) UpdateLayer(ComponentLayer_World); 
     worldLyrTime = TIMER_END(t_a); TIMER_RESET(t_a);
     
     //deletion buffer
-    for(Entity* e : deletionBuffer) {
-        for(Component* c : e->components) freeCompLayers[c->layer].remove_from(c->layer_index);
-        for(int i = e->id+1; i < entities.size(); ++i) entities[i]->id -= 1;
-        entities.erase(entities.begin()+e->id);
+    if(deletionBuffer.size() || creationBuffer.size()) componentsVersion++;
+    for(EntityHandle handle : deletionBuffer) {
+        Entity* e = GetEntity(handle);
+        if(!e) continue; //already deleted
+        
+        //swap-remove from the dense array
+        if(e->id < entities.size() && entities[e->id] == e){
+            Entity* last = entities.back();
+            entities[e->id] = last;
+            last->id = e->id;
+            for(Component* c : last->components) c->entityID = last->id;
+            entities.pop_back();
+        }else{
+            //entity was still in the creation buffer
+            forI(creationBuffer.size()){ if(creationBuffer[i] == e){ creationBuffer.erase(creationBuffer.begin()+i); break; } }
+        }
+        
         if (e == player) player = nullptr;
+        FreeEntityHandle(handle);
         delete e;
     }
     deletionBuffer.clear();
@@ -129,7 +178,7 @@ void Admin::PostRenderUpdate(){ //no imgui stuff allowed b/c rendering already h
             c->entityID = e->id;
             c->compID = compIDcount;
             c->entity = e;
-            c->layer_index = freeCompLayers[c->layer].add(c);
+            c->inLayer = true;
             if (c->comptype == ComponentType_Light) scene.lights.push_back(dyncast(Light, c));
             compIDcount++;
         }
@@ -156,61 +205,91 @@ void Admin::PostRenderUpdate(){ //no imgui stuff allowed b/c rendering already h
     skip = false;
 }
 
-u32 Admin::CreateEntity(const char* name) {
-    u32 id = entities.size() + creationBuffer.size() - 1;
-    creationBuffer.push_back(new Entity(this, id, Transform(), name));
-    return id;
+EntityHandle Admin::CreateEntity(const char* name) {
+    return CreateEntity(new Entity(this, -1, Transform(), name));
 }
 
-u32 Admin::CreateEntity(std::vector<Component*> components, const char* name, Transform transform) {
-    u32 id = entities.size() + creationBuffer.size() - 1;
-    creationBuffer.push_back(new Entity(this, id, transform, name, components));
-    return id;
+EntityHandle Admin::CreateEntity(std::vector<Component*> components, const char* name, Transform transform) {
+    return CreateEntity(new Entity(this, -1, transform, name, components));
 }
 
-u32 Admin::CreateEntity(Entity* e) {
-    if(!e) return -1;
+EntityHandle Admin::CreateEntity(Entity* e) {
+    if(!e) return EntityHandle();
 	
     e->admin = this;
+    e->handle = AllocateEntityHandle(e);
     creationBuffer.push_back(e);
-    return entities.size() + creationBuffer.size() - 1;
+    return e->handle;
 }
 
 Entity* Admin::CreateEntityNow(std::vector<Component*> components, const char* name, Transform transform) {
     Entity* e = new Entity(this, entities.size(), transform, name, components);
+    e->handle = AllocateEntityHandle(e);
     entities.push_back(e);
+    componentsVersion++;
     for (Component* c : e->components) {
         c->entityID = e->id;
         c->compID = compIDcount;
         c->entity = e;
-        c->layer_index = freeCompLayers[c->layer].add(c);
+        c->inLayer = true;
         if (c->comptype == ComponentType_Light) scene.lights.push_back(dyncast(Light, c));
         compIDcount++;
     }
     return e;
 }
 
-void Admin::DeleteEntity(u32 id) {
-    if(id < entities.size()){
-        deletionBuffer.push_back(entities[id]);
+void Admin::DeleteEntity(EntityHandle handle) {
+    if(GetEntity(handle)){
+        deletionBuffer.push_back(handle);
     }else{
-        ERROR("Attempted to add entity '", id, "' to deletion buffer when it doesn't exist on the admin");
+        ERROR("Attempted to add entity '", handle.index, ":", handle.generation, "' to deletion buffer when it doesn't exist on the admin");
     }
 }
 
 void Admin::DeleteEntity(Entity* e) {
-    if(e && e->id < entities.size()){
-        deletionBuffer.push_back(e);
+    if(e && GetEntity(e->handle) == e){
+        deletionBuffer.push_back(e->handle);
     }else{
-        ERROR("Attempted to add entity '", e->id, "' to deletion buffer when it doesn't exist on the admin");
+        ERROR("Attempted to add an entity to deletion buffer when it doesn't exist on the admin");
     }
 }
 
+Entity* Admin::GetEntity(EntityHandle handle) {
+    if(handle.index >= entitySlots.size()) return 0;
+    EntitySlot& slot = entitySlots[handle.index];
+    return (slot.generation == handle.generation) ? slot.entity : 0;
+}
+
+EntityHandle Admin::AllocateEntityHandle(Entity* e) {
+    if(entitySlotFreeList == -1){
+        entitySlots.push_back({0, 0, (u32)-1});
+        entitySlotFreeList = entitySlots.size()-1;
+    }
+    u32 index = entitySlotFreeList;
+    EntitySlot& slot = entitySlots[index];
+    entitySlotFreeList = slot.nextFree;
+    slot.entity = e;
+    slot.nextFree = -1;
+    
+    EntityHandle handle;
+    handle.index = index;
+    handle.generation = slot.generation;
+    return handle;
+}
+
+void Admin::FreeEntityHandle(EntityHandle handle) {
+    EntitySlot& slot = entitySlots[handle.index];
+    slot.entity = 0;
+    slot.generation += 1; //invalidates every handle to this slot
+    slot.nextFree = entitySlotFreeList;
+    entitySlotFreeList = handle.index;
+}
+
 void Admin::AddComponentToLayers(Component* c){
     if(!c) return;
 	
     c->compID = compIDcount;
-    c->layer_index = freeCompLayers[c->layer].add(c);
+    c->inLayer = true;
     if(c->comptype == ComponentType_Light) scene.lights.push_back(dyncast(Light, c));
     compIDcount++;
 }
@@ -288,10 +367,16 @@ void Admin::ChangeState(GameState new_state){
 void Admin::Reset(){
     SUCCESS("Resetting admin");
     TIMER_START(t_r);
-    for(Entity* e : entities) delete e;
+    for(Entity* e : entities){
+        FreeEntityHandle(e->handle);
+        delete e;
+    }
     entities.clear();
+    componentsVersion++;
+    
+    //give the memory of emptied pools back
+    ForEachComponentPool([](auto& pool){ pool.Trim(); });
     
-    for(auto& layer : freeCompLayers) layer.clear();
     scene.Reset();
     Render::Reset();
     Render::LoadScene(&scene);
@@ -916,6 +1001,7 @@ void Admin::LoadDESH(const char* filename) {
         memcpy(entName,   data+cursor, sizeof(char)*DESHI_NAME_SIZE); cursor += sizeof(char)*DESHI_NAME_SIZE;
         memcpy(&entTrans, data+cursor, sizeof(vec3)*3);  cursor += sizeof(vec3)*3;
         entities.push_back(new Entity(this, entities.size(), entTrans, entName, {}));
+        entities.back()->handle = AllocateEntityHandle(entities.back());
     }
     
     //// parse and load textures ////
@@ -1029,6 +1115,15 @@ std::string Admin::FormatAdminTime(std::string fmt){
 				case('s'):{
 					out.append(std::to_string(sndSysTime));
 				}i+=2;continue;
+				case('A'):{
+					out.append(std::to_string(scheduler.wallTime));
+				}i+=2;continue;
+				case('R'):{
+					out.append(std::to_string(scheduler.criticalTime));
+				}i+=2;continue;
+				case('T'):{
+					out.append(std::to_string(scheduler.serialTime));
+				}i+=2;continue;
 			}
 		}
 		out.push_back(fmt[i]);
@@ -9,13 +9,15 @@
 #include "systems/PhysicsSystem.h"
 #include "systems/CanvasSystem.h"
 #include "systems/SoundSystem.h"
+#include "systems/SystemScheduler.h"
 #include "entities/Entity.h"
+#include "components/Component.h"
 #include "../defines.h"
-#include "../utils/ContainerManager.h"
 #include "../scene/scene.h"
 
 #include <vector>
 #include <string>
+#include <tuple>
 
 //struct Entity;
 struct System;
@@ -23,6 +25,25 @@ struct Component;
 struct Command;
 struct Camera;
 
+//cached list of every entity that has all of the component types Ts, see Admin::Query
+template<class... Ts>
+struct ComponentView{
+	struct Row{
+		Entity* entity;
+		std::tuple<Ts*...> components;
+		
+		template<class T> T* Get(){ return std::get<T*>(components); }
+	};
+	
+	std::vector<Row> rows;
+	u32 version = -1; //the admin's componentsVersion when this was built
+	
+	Row* begin(){ return rows.data(); }
+	Row* end(){ return rows.data() + rows.size(); }
+	u32  size(){ return rows.size(); }
+	Row& operator[](u32 i){ return rows[i]; }
+};
+
 enum GameStateBits : u32{
 	GameState_Play, GameState_Menu, GameState_Debug, GameState_Editor, GameState_COUNT
 }; typedef u32 GameState;
@@ -34,6 +55,7 @@ struct Admin {
 	PhysicsSystem physics;
 	CanvasSystem  canvas;
 	SoundSystem   sound;
+	SystemScheduler scheduler;
 	
 	//admin singletons
 	Scene       scene;
@@ -44,13 +66,22 @@ struct Admin {
 	Camera* mainCamera;
 	Entity* player;
 	
-	std::vector<Entity*> entities;
+	std::vector<Entity*> entities; //dense and unordered, Entity::id is the entity's index in here
 	std::vector<Entity*> creationBuffer;
-	std::vector<Entity*> deletionBuffer;
-	
-	//stores the components to be executed in between layers
-	std::vector<ContainerManager<Component*>> freeCompLayers;
+	std::vector<EntityHandle> deletionBuffer;
+	
+	//generational slots that EntityHandles index into, freed slots are reused from a free list
+	struct EntitySlot{
+		Entity* entity;
+		u32 generation;
+		u32 nextFree;
+	};
+	std::vector<EntitySlot> entitySlots;
+	u32 entitySlotFreeList = -1;
+	
+	//components are stored in per-type pools (see COMPONENT_POOL) and updated by layer from there
 	u32 compIDcount = 0;
+	u32 componentsVersion = 0; //incremented whenever an entity in entities gains or loses components
 	
 	//pause flags
 	b32  skip;
@@ -70,7 +101,7 @@ struct Admin {
 	
 	inline void SkipUpdate(){ skip = true; };
 	void ChangeState(GameState state);
-	std::string FormatAdminTime(std::string format);
+	std::string FormatAdminTime(std::string format); //{A}, {R}, {T} are the scheduler's wall, critical path, and serial times
 	
 	void Reset();
 	void SaveTEXT(std::string savename);
@@ -81,33 +112,56 @@ struct Admin {
 	//// entity and component storage functions ////
 	
 	//initializes an entity with no components and adds it to the creation buffer
-	//returns the eventual position in the admin's entities array
-	u32 CreateEntity(const char* name = 0);
+	//returns a handle to the entity
+	EntityHandle CreateEntity(const char* name = 0);
 	
 	//initializes an entity with a component vector and adds it to the creation buffer
-	//returns the eventual position in the admin's entities array
-	u32 CreateEntity(std::vector<Component*> components, const char* name = 0, Transform transform = Transform());
+	//returns a handle to the entity
+	EntityHandle CreateEntity(std::vector<Component*> components, const char* name = 0, Transform transform = Transform());
 	
 	//adds an already initialized entity to the creation buffer
-	u32 CreateEntity(Entity* entity);
+	//returns a handle to the entity
+	EntityHandle CreateEntity(Entity* entity);
 	
 	//initializes an entity with a component vector and adds it to entities immedietly
 	//returns a pointer to the entitiy
 	Entity* CreateEntityNow(std::vector<Component*> components, const char* name = 0, Transform transform = Transform());
 	
-	//adds the entity at ID to the deletion buffer
-	void DeleteEntity(u32 id);
+	//adds the entity the handle refers to to the deletion buffer
+	void DeleteEntity(EntityHandle handle);
 	
 	//adds an already initialized entity to the deletion buffer
 	void DeleteEntity(Entity* entity);
 	
+	//returns the entity the handle refers to, nullptr if that entity has been deleted
+	Entity* GetEntity(EntityHandle handle);
+	
+	EntityHandle AllocateEntityHandle(Entity* entity);
+	void FreeEntityHandle(EntityHandle handle);
+	
 	void AddComponentToLayers(Component* component);
+	
+	//returns a view of every entity that has all of the component types Ts
+	//the view is cached and only rebuilt after componentsVersion changes, so dont hold onto
+	//rows across entity creation/deletion
+	template<class... Ts>
+	ComponentView<Ts...>& Query(){
+		persist ComponentView<Ts...> view;
+		if(view.version != componentsVersion){
+			view.rows.clear();
+			for(Entity* e : entities){
+				typename ComponentView<Ts...>::Row row{e, std::tuple<Ts*...>(e->GetComponent<Ts>()...)};
+				if(((std::get<Ts*>(row.components) != 0) && ...)) view.rows.push_back(row);
+			}
+			view.version = componentsVersion;
+		}
+		return view;
+	}
 };
 
 
 //global_ admin pointer
 extern Admin* g_admin;
-#define EntityAt(id) g_admin->entities[id]
 #define DengAdmin  g_admin
 #define DengKeys   g_admin->keybinds
 #define DengCamera g_admin->mainCamera
@@ -24,82 +24,65 @@
 #include "../math/Math.h"
 #include "../scene/Scene.h"
 #include "../geometry/Edge.h"
+#include "../geometry/TriangleBVH.h"
 
 #include <iomanip> //std::put_time
 #include <thread>
+#include <unordered_map>
 
 local f32 font_width = 0;
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 //// inputs
 
+//triangle bvhs of the meshes picked without a collider, built the first time each mesh is clicked on
+local TriangleBVH& MeshPickingBVH(Mesh* mesh){
+    persist std::unordered_map<Mesh*, TriangleBVH> bvhs;
+    auto found = bvhs.find(mesh);
+    if(found != bvhs.end()) return found->second;
+    
+    std::vector<Vector3> vertices;
+    for(Batch& b : mesh->batchArray){
+        for(u32 i = 0; i + 2 < b.indexArray.size(); i += 3){
+            vertices.push_back(b.vertexArray[b.indexArray[i + 0]].pos);
+            vertices.push_back(b.vertexArray[b.indexArray[i + 1]].pos);
+            vertices.push_back(b.vertexArray[b.indexArray[i + 2]].pos);
+        }
+    }
+    TriangleBVH& bvh = bvhs[mesh];
+    bvh.Build(vertices);
+    return bvh;
+}
+
 Entity* Editor::SelectEntityRaycast(){
     vec3 pos = Math::ScreenToWorld(DengInput->mousePos, camera->projMat, camera->viewMat, DengWindow->dimensions);
+    vec3 direction = (pos - camera->position).normalized();
     
-    int closeindex = -1;
+    //entities with colliders are found through the physics broadphase, triggers included so they can be selected
+    Entity* closest = 0;
     f32 mint = INFINITY;
+    RaycastHit hit;
+    if(admin->physics.Raycast(camera->position, direction, mint, hit, QUERY_ALL_LAYERS, true)){
+        closest = hit.entity;
+        mint = hit.distance;
+    }
     
-    vec3 p0, p1, p2, normal, intersect;
-    mat4 transform, rotation;
-    f32  t;
-    int  index = 0;
-    bool done = false;
-    for(Entity* e : admin->entities) {
-        transform = e->transform.TransformMatrix();
-        rotation = Matrix4::RotationMatrix(e->transform.rotation);
-        if(MeshComp* mc = e->GetComponent<MeshComp>()) {
-            if(mc->mesh_visible) {
-                Mesh* m = mc->mesh;
-                for(Batch& b : m->batchArray){
-                    for(u32 i = 0; i < b.indexArray.size(); i += 3){
-                        //NOTE sushi: our normal here is now based on whatever the vertices normal is when we load the model
-                        //			  so if we end up loading models and combining vertices again, this will break
-                        p0 = b.vertexArray[b.indexArray[i + 0]].pos * transform;
-                        p1 = b.vertexArray[b.indexArray[i + 1]].pos * transform;
-                        p2 = b.vertexArray[b.indexArray[i + 2]].pos * transform;
-                        normal = b.vertexArray[b.indexArray[i + 0]].normal * rotation;
-                        
-                        //early out if triangle is not facing us
-                        if (normal.dot(p0 - camera->position) < 0) {
-                            //find where on the plane defined by the triangle our raycast intersects
-                            intersect = Math::VectorPlaneIntersect(p0, normal, camera->position, pos, t);
-                            
-                            //early out if intersection is behind us
-                            if (t > 0) {
-                                //make vectors perpendicular to each edge of the triangle
-                                Vector3 perp0 = normal.cross(p1 - p0).yInvert().normalized();
-                                Vector3 perp1 = normal.cross(p2 - p1).yInvert().normalized();
-                                Vector3 perp2 = normal.cross(p0 - p2).yInvert().normalized();
-                                
-                                //check that the intersection point is within the triangle and its the closest triangle found so far
-                                if (
-                                    perp0.dot(intersect - p0) > 0 &&
-                                    perp1.dot(intersect - p1) > 0 &&
-                                    perp2.dot(intersect - p2) > 0) {
-                                    
-                                    //if its the closest triangle so far we store its index
-                                    if (t < mint) {
-                                        closeindex = index;
-                                        mint = t;
-                                        done = true;
-                                        break;
-                                    }
-                                    
-                                }
-                            }
-                        }
-                        if(done) break;
-                    }
-                    if (done) break;
-                }
-            }
+    //visible meshes without a collider are tested against their own triangle bvh in mesh space
+    for(auto& row : admin->Query<MeshComp>()) {
+        Entity* e = row.entity;
+        MeshComp* mc = row.Get<MeshComp>();
+        if(!mc->mesh_visible || !mc->mesh || e->GetComponent<Collider>()) continue;
+        
+        mat4 inverse = e->transform.TransformMatrix().Inverse();
+        vec3 localOrigin = camera->position * inverse;
+        f32 t = mint;
+        if(MeshPickingBVH(mc->mesh).Raycast(localOrigin, (camera->position + direction) * inverse - localOrigin, t)){
+            closest = e;
+            mint = t;
         }
-        done = false;
-        index++;
     }
     
-    if (closeindex != -1) return admin->entities[closeindex];
-    else return 0;
+    return closest;
 }
 
 void Editor::TranslateEntity(Entity* e, TransformationAxis axis){
@@ -159,7 +142,7 @@ inline void HandleGrabbing(Entity* sel, Camera* c, Admin* admin, UndoManager* um
                 initialgrab = true; grabbingObj = false;  
                 admin->controller.cameraLocked = false;
                 if(initialObjPos != sel->transform.position){
-                    um->AddUndoTranslate(&sel->transform, &initialObjPos, &sel->transform.position);
+                    um->AddUndoTranslate(sel, &initialObjPos, &sel->transform.position);
                 }
                 return;
             }
@@ -340,7 +323,7 @@ inline void HandleRotating(Entity* sel, Camera* c, Admin* admin, UndoManager* um
                 initialrot = true; rotatingObj = false;  
                 admin->controller.cameraLocked = false;
                 if(initialObjRot != sel->transform.rotation){
-                    um->AddUndoRotate(&sel->transform, &initialObjRot, &sel->transform.rotation);
+                    um->AddUndoRotate(sel, &initialObjRot, &sel->transform.rotation);
                 }
                 return;
             }
@@ -450,7 +433,12 @@ inline void HandleRotating(Entity* sel, Camera* c, Admin* admin, UndoManager* um
 
 //functions to simplify the usage of our DebugLayer
 namespace ImGui {
+    //imgui only works on the thread that began the layer, draws from elsewhere (the physics thread) are dropped
+    local std::thread::id debugLayerThread;
+    local inline bool OnDebugLayerThread() { return std::this_thread::get_id() == debugLayerThread; }
+    
     void BeginDebugLayer() {
+        debugLayerThread = std::this_thread::get_id();
         //ImGui::SetNextWindowSize(ImVec2(DengWindow->width, DengWindow->height));
         ImGui::SetNextWindowPos(ImVec2(0, 0));
         ImGui::PushStyleColor(ImGuiCol_WindowBg, ImGui::ColorToImVec4(Color(0, 0, 0, 0)));
@@ -464,10 +452,12 @@ namespace ImGui {
     }
     
     void DebugDrawCircle(Vector2 pos, float radius, Color color) {
+        if(!OnDebugLayerThread()) return;
         ImGui::GetBackgroundDrawList()->AddCircle(ImVec2(pos.x, pos.y), radius, ImGui::GetColorU32(ImGui::ColorToImVec4(color)));
     }
     
     void DebugDrawCircle3(Vector3 pos, float radius, Color color) {
+        if(!OnDebugLayerThread()) return;
         Camera* c = g_admin->mainCamera;
         Vector2 windimen = DengWindow->dimensions;
         Vector2 pos2 = Math::WorldToScreen2(pos, c->projMat, c->viewMat, windimen);
@@ -475,6 +465,7 @@ namespace ImGui {
     }
     
     void DebugDrawCircleFilled3(Vector3 pos, float radius, Color color) {
+        if(!OnDebugLayerThread()) return;
         Camera* c = g_admin->mainCamera;
         Vector2 windimen = DengWindow->dimensions;
         Vector2 pos2 = Math::WorldToScreen2(pos, c->projMat, c->viewMat, windimen);
@@ -482,11 +473,13 @@ namespace ImGui {
     }
     
     void DebugDrawLine(Vector2 pos1, Vector2 pos2, Color color) {
+        if(!OnDebugLayerThread()) return;
         Math::ClipLineToBorderPlanes(pos1, pos2, DengWindow->dimensions);
         ImGui::GetBackgroundDrawList()->AddLine(ImGui::Vector2ToImVec2(pos1), ImGui::Vector2ToImVec2(pos2), ImGui::GetColorU32(ImGui::ColorToImVec4(color)));
     }
     
     void DebugDrawLine3(Vector3 pos1, Vector3 pos2, Color color) {
+        if(!OnDebugLayerThread()) return;
         Camera* c = g_admin->mainCamera;
         Vector2 windimen = DengWindow->dimensions;
         
@@ -501,6 +494,7 @@ namespace ImGui {
     }
     
     void DebugDrawText(const char* text, Vector2 pos, Color color) {		
+        if(!OnDebugLayerThread()) return;
         ImGui::SetCursorPos(ImGui::Vector2ToImVec2(pos));
         
         ImGui::PushStyleColor(ImGuiCol_Text, ImGui::ColorToImVec4(color));
@@ -509,6 +503,7 @@ namespace ImGui {
     }
     
     void DebugDrawText3(const char* text, Vector3 pos, Color color, Vector2 twoDoffset) {
+        if(!OnDebugLayerThread()) return;
         Camera* c = g_admin->mainCamera;
         Vector2 windimen = DengWindow->dimensions;
         
@@ -528,6 +523,7 @@ namespace ImGui {
     }
     
     void DebugFillTriangle(Vector2 p1, Vector2 p2, Vector2 p3, Color color) {
+        if(!OnDebugLayerThread()) return;
         ImGui::GetBackgroundDrawList()->AddTriangleFilled(ImGui::Vector2ToImVec2(p1), ImGui::Vector2ToImVec2(p2), ImGui::Vector2ToImVec2(p3), 
                                                           ImGui::GetColorU32(ImGui::ColorToImVec4(color)));
     }
@@ -540,6 +536,7 @@ namespace ImGui {
     
     //TODO(sushi, Ui) add triangle clipping to this function
     void DebugFillTriangle3(Vector3 p1, Vector3 p2, Vector3 p3, Color color) {
+        if(!OnDebugLayerThread()) return;
         Vector2 p1n = Math::WorldToScreen(p1, g_admin->mainCamera->projMat, g_admin->mainCamera->viewMat, DengWindow->dimensions).ToVector2();
         Vector2 p2n = Math::WorldToScreen(p2, g_admin->mainCamera->projMat, g_admin->mainCamera->viewMat, DengWindow->dimensions).ToVector2();
         Vector2 p3n = Math::WorldToScreen(p3, g_admin->mainCamera->projMat, g_admin->mainCamera->viewMat, DengWindow->dimensions).ToVector2();
@@ -549,6 +546,7 @@ namespace ImGui {
     }
     
     void DebugDrawGraphFloat(Vector2 pos, float inval, float sizex, float sizey) {
+        if(!OnDebugLayerThread()) return;
         //display in value
         ImGui::SetCursorPos(ImVec2(pos.x, pos.y - 10));
         ImGui::TextEx(TOSTRING(inval).c_str());
@@ -951,9 +949,9 @@ inline void EventsMenu(Entity* current) {
 inline void EntitiesTab(Admin* admin, float fontsize){
     persist b32 rename_ent = false;
     persist char rename_buffer[DESHI_NAME_SIZE] = {};
-    persist Entity* events_ent = 0;
+    persist EntityHandle events_ent;
     
-    std::vector<Entity*>& selected = admin->editor.selected;
+    std::vector<EntityHandle>& selected = admin->editor.selected;
     
     //// selected entity keybinds ////
     //start renaming first selected entity
@@ -961,13 +959,13 @@ inline void EntitiesTab(Admin* admin, float fontsize){
         rename_ent = true;
         DengConsole->IMGUI_KEY_CAPTURE = true;
         if(selected.size() > 1) selected.erase(selected.begin()+1, selected.end());
-        cpystr(rename_buffer, selected[0]->name, DESHI_NAME_SIZE);
+        cpystr(rename_buffer, admin->GetEntity(selected[0])->name, DESHI_NAME_SIZE);
     }
     //submit renaming entity
     if(rename_ent && DengInput->KeyPressedAnyMod(Key::ENTER)){
         rename_ent = false;
         DengConsole->IMGUI_KEY_CAPTURE = false;
-        cpystr(selected[0]->name, rename_buffer, DESHI_NAME_SIZE);
+        if(selected.size()) cpystr(admin->GetEntity(selected[0])->name, rename_buffer, DESHI_NAME_SIZE);
     }
     //stop renaming entity
     if(rename_ent && DengInput->KeyPressedAnyMod(Key::ESCAPE)){
@@ -1026,7 +1024,7 @@ inline void EntitiesTab(Admin* admin, float fontsize){
                     char label[8];
                     sprintf(label, " %04d ", ent->id);
                     u32 selected_idx = -1;
-                    forI(selected.size()){ if(ent == selected[i]){ selected_idx = i; break; } }
+                    forI(selected.size()){ if(ent->handle == selected[i]){ selected_idx = i; break; } }
                     bool is_selected = selected_idx != -1;
                     if(ImGui::Selectable(label, is_selected, ImGuiSelectableFlags_SpanAllColumns | ImGuiSelectableFlags_AllowItemOverlap)){
                         if(is_selected){
@@ -1034,14 +1032,14 @@ inline void EntitiesTab(Admin* admin, float fontsize){
                                 selected.erase(selected.begin()+selected_idx);
                             }else{
                                 selected.clear();
-                                selected.push_back(ent);
+                                selected.push_back(ent->handle);
                             }
                         }else{
                             if(DengInput->LCtrlDown()){
-                                selected.push_back(ent);
+                                selected.push_back(ent->handle);
                             }else{
                                 selected.clear();
-                                selected.push_back(ent);
+                                selected.push_back(ent->handle);
                             }
                         }
                         rename_ent = false;
@@ -1061,9 +1059,9 @@ inline void EntitiesTab(Admin* admin, float fontsize){
                     //// events button ////
                     ImGui::TableSetColumnIndex(3);
                     if (ImGui::Button("Events", ImVec2(-FLT_MIN, 0.0f))) {
-                        events_ent = (events_ent != ent) ? ent : 0;
+                        events_ent = (events_ent != ent->handle) ? ent->handle : EntityHandle();
                     }
-                    EventsMenu(events_ent);
+                    EventsMenu(admin->GetEntity(events_ent));
 					
                     //// delete button ////
                     ImGui::TableSetColumnIndex(4);
@@ -1106,14 +1104,14 @@ inline void EntitiesTab(Admin* admin, float fontsize){
         }
 		
         selected.clear();
-        if(ent) selected.push_back(ent);
+        if(ent) selected.push_back(ent->handle);
     }
     ImGui::SameLine(); ImGui::Combo("##preset_combo", &current_preset, presets, ArrayCount(presets));
     
     ImGui::Separator();
     
     //// selected entity inspector panel ////
-    Entity* sel = admin->editor.selected.size() ? admin->editor.selected[0] : 0;
+    Entity* sel = admin->editor.selected.size() ? admin->GetEntity(admin->editor.selected[0]) : 0;
     if(!sel) return;
     ImGui::PushStyleVar(ImGuiStyleVar_IndentSpacing, 5.0f);
     ImGui::SetCursorPosX(ImGui::GetWindowWidth()*0.025);
@@ -1134,9 +1132,9 @@ inline void EntitiesTab(Admin* admin, float fontsize){
             if(ImGui::InputVector3("##ent_pos", &sel->transform.position)){
                 if(Physics* p = sel->GetComponent<Physics>()){
                     p->position = sel->transform.position;
-                    admin->editor.undo_manager.AddUndoTranslate(&sel->transform, &oldVec, &p->position);
+                    admin->editor.undo_manager.AddUndoTranslate(sel, &oldVec, &p->position);
                 }else{
-                    admin->editor.undo_manager.AddUndoTranslate(&sel->transform, &oldVec, &sel->transform.position);
+                    admin->editor.undo_manager.AddUndoTranslate(sel, &oldVec, &sel->transform.position);
                 }
             }ImGui::Separator();
             
@@ -1145,9 +1143,9 @@ inline void EntitiesTab(Admin* admin, float fontsize){
             if(ImGui::InputVector3("##ent_rot", &sel->transform.rotation)){
                 if(Physics* p = sel->GetComponent<Physics>()){
                     p->rotation = sel->transform.rotation;
-                    admin->editor.undo_manager.AddUndoRotate(&sel->transform, &oldVec, &p->rotation);
+                    admin->editor.undo_manager.AddUndoRotate(sel, &oldVec, &p->rotation);
                 }else{
-                    admin->editor.undo_manager.AddUndoRotate(&sel->transform, &oldVec, &sel->transform.rotation);
+                    admin->editor.undo_manager.AddUndoRotate(sel, &oldVec, &sel->transform.rotation);
                 }
             }ImGui::Separator();
             
@@ -1156,9 +1154,9 @@ inline void EntitiesTab(Admin* admin, float fontsize){
             if(ImGui::InputVector3("##ent_scale",   &sel->transform.scale)){
                 if(Physics* p = sel->GetComponent<Physics>()){
                     p->scale = sel->transform.scale;
-                    admin->editor.undo_manager.AddUndoScale(&sel->transform, &oldVec, &p->scale);
+                    admin->editor.undo_manager.AddUndoScale(sel, &oldVec, &p->scale);
                 }else{
-                    admin->editor.undo_manager.AddUndoScale(&sel->transform, &oldVec, &sel->transform.scale);
+                    admin->editor.undo_manager.AddUndoScale(sel, &oldVec, &sel->transform.scale);
                 }
             }ImGui::Separator();
             ImGui::Unindent();
@@ -1308,6 +1306,7 @@ inline void EntitiesTab(Admin* admin, float fontsize){
                     ImGui::Checkbox("Static Position", &d->staticPosition);
                     ImGui::Checkbox("Static Rotation", &d->staticRotation);
                     ImGui::Checkbox("2D Physics", &d->twoDphys);
+                    ImGui::Checkbox("Continuous", &d->continuous);
 					
                     ImGui::Unindent();
                     ImGui::Separator();
@@ -1392,7 +1391,9 @@ inline void EntitiesTab(Admin* admin, float fontsize){
 							}break;
 						}
 						
-						ImGui::Checkbox("Don't Resolve Collisions", (bool*)&coll->noCollide);
+						if(ImGui::Checkbox("Don't Resolve Collisions", (bool*)&coll->noCollide)){
+							admin->physics.syncPending = true; //moves it to or from the trigger tree
+						}
 						ImGui::TextEx("Collision Layer"); ImGui::SameLine(); ImGui::SetNextItemWidth(-1);
 						local u32 min = 0, max = 9;
 						ImGui::SliderScalar("##coll_layer", ImGuiDataType_U32, &coll->collisionLayer, &min, &max, "%d");
@@ -1802,6 +1803,32 @@ inline void GlobalTab(Admin* admin){
 				admin->pause_phys = !admin->pause_phys;
 			}    
 			ImGui::TextEx("Gravity       "); ImGui::SameLine(); ImGui::InputFloat("##global__gravity", &admin->physics.gravity);
+			persist const char* collisionModes[] = {"Discrete", "Continuous", "GJK", "None"};
+			ImGui::TextEx("Collision     "); ImGui::SameLine(); ImGui::Combo("##global__collision_mode", (int*)&admin->physics.collisionMode, collisionModes, ArrayCount(collisionModes));
+			ImGui::Checkbox("Sleeping", (bool*)&admin->physics.sleepEnabled);
+			ImGui::Checkbox("SIMD Integration", (bool*)&admin->physics.simdIntegration);
+			ImGui::Checkbox("SIMD Narrowphase", (bool*)&admin->physics.simdNarrowphase);
+			ImGui::Checkbox("Physics LOD", (bool*)&admin->physics.lodEnabled);
+			if(admin->physics.lodEnabled){
+				ImGui::TextEx("LOD Distances "); ImGui::SameLine(); ImGui::InputFloat3("##global__lod_distances", admin->physics.lodDistances);
+				ImGui::TextEx("LOD Offscreen "); ImGui::SameLine(); ImGui::SliderInt("##global__lod_offscreen", (int*)&admin->physics.lodOffscreenTier, 0, PHYSICS_LOD_TIERS-1);
+			}
+			ImGui::Checkbox("Physics Thread", (bool*)&admin->physics.threaded);
+			ImGui::Checkbox("Parallel Narrowphase", (bool*)&admin->physics.parallelNarrowphase);
+			ImGui::Checkbox("Warm Starting", (bool*)&admin->physics.warmStarting);
+			ImGui::TextEx("Solver Iters  "); ImGui::SameLine(); ImGui::SliderInt("##global__solver_iterations", (int*)&admin->physics.solverIterations, 1, 32);
+			ImGui::TextEx(TOSTRING("Contacts      ", admin->physics.contactCache.manifolds.size(), " pairs").c_str());
+			if(admin->physics.threaded){
+				ImGui::TextEx(TOSTRING("Dropped steps ", admin->physics.droppedSteps).c_str());
+			}
+			ImGui::TextEx(TOSTRING("Pairs tested  ", admin->physics.pairsTested, "  found ", admin->physics.pairsFound).c_str());
+			ImGui::TextEx(TOSTRING("Trigger tests ", admin->physics.triggerTests, "  inside ", admin->physics.triggerOverlaps.size(), "  events ", admin->physics.frameTriggerEvents.size()).c_str());
+			ImGui::TextEx(TOSTRING("Sleeping      ", admin->physics.sleepingCount, " bodies").c_str());
+			ImGui::TextEx(TOSTRING("Swept         ", admin->physics.ccdBodies, "  hit ", admin->physics.ccdHits).c_str());
+			ImGui::TextEx(TOSTRING("Step allocs   ", admin->physics.stepAllocations, "  arena ", admin->physics.stepArenas[admin->physics.stepArena].used / 1024, " KB").c_str());
+			forI(PhysicsStage_COUNT){
+				ImGui::TextEx(TOSTRING(PhysicsStageStrings[i], std::string(14 - strlen(PhysicsStageStrings[i]), ' '), admin->physics.stageTimes[i], " ms").c_str());
+			}
 			
 			//ImGui::TextEx("Phys TPS      "); ImGui::SameLine(); ImGui::InputFloat("##phys_tps", )
         }
@@ -2045,6 +2072,7 @@ void Editor::DebugBar() {
     persist bool show_fps_graph = true;
     persist bool show_world_stats = true;
     persist bool show_selected_stats = true;
+    persist bool show_physics_lod = true;
     persist bool show_floating_fps_graph = false;
     persist bool show_time = true;
     
@@ -2065,7 +2093,7 @@ void Editor::DebugBar() {
     //capture mouse if hovering over this window
     WinHovCheck; 
     
-    activecols = show_fps + show_fps_graph + 3 * show_world_stats + 2 * show_selected_stats + show_time + 1;
+    activecols = show_fps + show_fps_graph + 3 * show_world_stats + 2 * show_selected_stats + show_physics_lod + show_time + 1;
     if (ImGui::BeginTable("DebugBarTable", activecols, ImGuiTableFlags_BordersV | ImGuiTableFlags_NoPadInnerX | ImGuiTableFlags_NoPadOuterX | ImGuiTableFlags_ContextMenuInBody | ImGuiTableFlags_SizingFixedFit)) {
         
         //precalc strings and stuff so we can set column widths appropriately
@@ -2079,6 +2107,9 @@ void Editor::DebugBar() {
         float strlen4 = (fontsize - (fontsize / 2)) * str4.size();
         std::string str5 = TOSTRING("sverts: ", "0");
         float strlen5 = (fontsize - (fontsize / 2)) * str5.size();
+        u32* lod = admin->physics.lodCounts;
+        std::string str8 = TOSTRING("plod: ", lod[0], "/", lod[1], "/", lod[2], "/", lod[3]);
+        float strlen8 = (fontsize - (fontsize / 2)) * str8.size();
         
         ImGui::TableSetupColumn("FPS",            ImGuiTableColumnFlags_WidthFixed, 64);
         ImGui::TableSetupColumn("FPSGraphInline", ImGuiTableColumnFlags_WidthFixed, 64);
@@ -2087,6 +2118,7 @@ void Editor::DebugBar() {
         ImGui::TableSetupColumn("VerCount",       ImGuiTableColumnFlags_None, strlen3 * 1.3);
         ImGui::TableSetupColumn("SelTriCount",    ImGuiTableColumnFlags_None, strlen4 * 1.3);
         ImGui::TableSetupColumn("SelVerCount",    ImGuiTableColumnFlags_None, strlen5 * 1.3);
+        ImGui::TableSetupColumn("PhysicsLOD",     ImGuiTableColumnFlags_None, strlen8 * 1.3);
         ImGui::TableSetupColumn("MiddleSep",      ImGuiTableColumnFlags_WidthStretch, 0);
         ImGui::TableSetupColumn("Time",           ImGuiTableColumnFlags_WidthFixed, 64);
         
@@ -2209,6 +2241,12 @@ void Editor::DebugBar() {
             ImGui::TextEx(str5.c_str());
         }
         
+        //Physics LOD tier counts, nearest first
+        if (ImGui::TableNextColumn() && show_physics_lod) {
+            ImGui::SameLine((ImGui::GetColumnWidth() - strlen8) / 2);
+            ImGui::TextEx(str8.c_str());
+        }
+        
         //Middle Empty ImGui::Separator (alert box)
         if (ImGui::TableNextColumn()) {
             if (DengConsole->show_alert) {
@@ -2291,7 +2329,10 @@ void Editor::DrawTimes(){
                                                    "World   Lyr: {W}\n"
                                                    "        Sys: {w}\n"
                                                    "Sound   Lyr: {S}\n"
-                                                   "        Sys: {s}\n");
+                                                   "        Sys: {s}\n"
+                                                   "Systems Wall: {A}\n"
+                                                   "    Critical: {R}\n"
+                                                   "      Serial: {T}\n");
     time1            += DengTime->FormatTickTime  ("Admin      : {a}\n"
                                                    "Console    : {c}\n"
                                                    "Render     : {r}\n"
@@ -2437,6 +2478,10 @@ void Editor::Init(Admin* a){
 }
 
 void Editor::Update(){
+    //drop selections of entities that have been deleted since last frame
+    selected.erase(std::remove_if(selected.begin(), selected.end(), [this](EntityHandle h){ return !admin->GetEntity(h); }), 
+                   selected.end());
+    
     ////////////////////////////
     //// handle user inputs ////
     ////////////////////////////
@@ -2451,12 +2496,12 @@ void Editor::Update(){
             if (DengInput->KeyPressed(MouseButton::LEFT)) {
                 Entity* e = SelectEntityRaycast();
                 if(!DengInput->LShiftDown()) selected.clear(); 
-                if(e) selected.push_back(e);
+                if(e) selected.push_back(e->handle);
             }
         }
         if (selected.size()) {
-            HandleGrabbing(selected[0], camera, admin, &undo_manager);
-            HandleRotating(selected[0], camera, admin, &undo_manager);
+            HandleGrabbing(admin->GetEntity(selected[0]), camera, admin, &undo_manager);
+            HandleRotating(admin->GetEntity(selected[0]), camera, admin, &undo_manager);
         }
     }
     {//// render ////
@@ -2503,8 +2548,8 @@ void Editor::Update(){
         else if (DengInput->KeyPressed(DengKeys.orthoBottomUpView)) camera->orthoview = BOTTOMUP;
         
         //look at selected
-        if(DengInput->KeyPressed(DengKeys.gotoSelected)){
-            camera->position = selected[0]->transform.position + Vector3(4.f, 3.f, -4.f);
+        if(DengInput->KeyPressed(DengKeys.gotoSelected) && selected.size()){
+            camera->position = admin->GetEntity(selected[0])->transform.position + Vector3(4.f, 3.f, -4.f);
             camera->rotation = {28.f, -45.f, 0.f};
         }
     }
@@ -2553,13 +2598,16 @@ void Editor::Update(){
     //renderer take a pointer of u32 that's stored here, or just dont have the renderer know about
     //selected entities since thats a game thing
     Render::RemoveSelectedMesh(-1);
-    for(Entity* e : selected){
+    for(EntityHandle handle : selected){
+        Entity* e = admin->GetEntity(handle);
+        if(!e) continue;
         if(MeshComp* mc = e->GetComponent<MeshComp>()){
             if(!Render::GetSettings()->findMeshTriangleNeighbors){
                 Render::AddSelectedMesh(mc->meshID);
             }else{
-                std::vector<Vector2> outline = mc->mesh->GenerateOutlinePoints(e->transform.TransformMatrix(), camera->projMat, camera->viewMat,
-                                                                               DengWindow->dimensions, camera->position);
+                persist std::vector<Vector2> outline;
+                mc->mesh->GenerateOutlinePoints(e->transform.TransformMatrix(), camera->projMat, camera->viewMat,
+                                                DengWindow->dimensions, camera->position, outline);
                 for (int i = 0; i < outline.size(); i += 2) {
                     ImGui::DebugDrawLine(outline[i], outline[i + 1], Color::CYAN);
                 }
@@ -3,6 +3,7 @@
 #define GAME_EDITOR_H
 
 #include "UndoManager.h"
+#include "entities/Entity.h"
 #include "../defines.h"
 #include "../utils/color.h"
 #include "../math/vector.h"
@@ -25,7 +26,7 @@ struct Editor{
 	Admin* admin;
 	EditorSettings settings;
 	
-	std::vector<Entity*> selected;
+	std::vector<EntityHandle> selected; //resolve with Admin::GetEntity, stale handles are dropped each update
 	Camera* camera;
 	UndoManager undo_manager;
 	
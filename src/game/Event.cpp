@@ -1,16 +1,74 @@
-#include "event.h"
+#include "Event.h"
+
+#include <mutex>
+#include <algorithm>
+
+//senders and receivers share one table of generational slots so records can hold handles instead of pointers
+struct EventSlot{
+	void* object;
+	u32 generation;
+	u32 nextFree;
+};
+local std::vector<EventSlot> eventSlots;
+local u32 eventSlotFreeList = -1;
+
+local std::vector<EventRecord> eventQueue;
+local std::vector<EventRecord> eventDispatch; //swapped with the queue so sends during dispatch go to the next batch
+local std::mutex eventQueueLock; //systems can send from job threads
+
+local EventHandle AllocateEventHandle(void* object){
+	EventHandle handle;
+	if(eventSlotFreeList != -1){
+		handle.index = eventSlotFreeList;
+		eventSlotFreeList = eventSlots[handle.index].nextFree;
+	}else{
+		handle.index = eventSlots.size();
+		eventSlots.push_back({0, 0, u32(-1)});
+	}
+	eventSlots[handle.index].object = object;
+	handle.generation = eventSlots[handle.index].generation;
+	return handle;
+}
+
+local void FreeEventHandle(EventHandle handle){
+	if(handle.index >= eventSlots.size()) return;
+	EventSlot& slot = eventSlots[handle.index];
+	slot.object = 0;
+	slot.generation++;
+	slot.nextFree = eventSlotFreeList;
+	eventSlotFreeList = handle.index;
+}
+
+local void* GetEventObject(EventHandle handle){
+	if(handle.index >= eventSlots.size() || eventSlots[handle.index].generation != handle.generation) return 0;
+	return eventSlots[handle.index].object;
+}
+
+Sender::Sender() {
+	handle = AllocateEventHandle(this);
+}
+
+Sender::~Sender() {
+	for (Receiver* r : receivers) r->senders.erase(this);
+	FreeEventHandle(handle);
+}
 
 void Sender::AddReceiver(Receiver* r) {
-	if (r) receivers.insert(r);
+	if (!r) return;
+	receivers.insert(r);
+	r->senders.insert(this);
 }
 
 void Sender::RemoveReceiver(Receiver* r) {
-	if(r) receivers.erase(r);
+	if (!r) return;
+	receivers.erase(r);
+	r->senders.erase(this);
 }
 
 void Sender::SendEvent(Event event) {
+	std::lock_guard<std::mutex> lock(eventQueueLock);
 	for (Receiver* r : receivers) {
-		r->ReceiveEvent(event);
+		eventQueue.push_back({handle, r->handle, event, r->ReceiverType()});
 	}
 }
 
@@ -20,5 +78,30 @@ bool Sender::HasReceiver(Receiver* r) {
 }
 
 Receiver::Receiver(Sender* s) {
+	handle = AllocateEventHandle(this);
 	if(s) s->AddReceiver(this);
 }
+
+Receiver::~Receiver() {
+	for (Sender* s : senders) s->receivers.erase(this);
+	FreeEventHandle(handle);
+}
+
+void DispatchEvents() {
+	{
+		std::lock_guard<std::mutex> lock(eventQueueLock);
+		eventDispatch.swap(eventQueue);
+	}
+	if(eventDispatch.empty()) return;
+
+	//stable so events to the same receiver keep the order they were sent in
+	std::stable_sort(eventDispatch.begin(), eventDispatch.end(), [](const EventRecord& a, const EventRecord& b){
+		return a.receiverType < b.receiverType;
+	});
+
+	//the handle is resolved for every record since a receiver can delete itself or others in response
+	for (EventRecord& record : eventDispatch) {
+		if (Receiver* r = (Receiver*)GetEventObject(record.receiver)) r->ReceiveEvent(record.event);
+	}
+	eventDispatch.clear();
+}
@@ -5,6 +5,7 @@
 #include "../defines.h"
 
 #include <set>
+#include <vector>
 
 struct Receiver;
 
@@ -18,22 +19,52 @@ global_ const char* EventStrings[] = {
     "NONE", "DoorToggle", "LightToggle"
 };
 
+//generational id of a sender or receiver, goes stale once the object it refers to is destroyed
+struct EventHandle{
+	u32 index      = -1;
+	u32 generation = 0;
+};
+
+//an event waiting in the queue for the next DispatchEvents
+struct EventRecord{
+	EventHandle sender;
+	EventHandle receiver;
+	Event event;
+	u32 receiverType; //records are dispatched sorted by this so the same receiver code runs together
+};
+
 //object stored on a component that wants to send a signal
 //using SendSignal and an Event
 //TODO(sushi) figure out a better way to send signals than using an Enum. Maybe string but we can't switch on strings so
 struct Sender {
+    //receivers and senders keep track of each other, so when either is destroyed it unlinks itself
+    //and no sender is left holding a receiver that no longer exists
     std::set<Receiver*> receivers;
+    EventHandle handle;
 	
+    Sender();
+    ~Sender();
     void AddReceiver(Receiver* r);
     void RemoveReceiver(Receiver* r);
+    
+    //queues the event for each receiver, it is delivered at the next DispatchEvents
     void SendEvent(Event event);
     
     bool HasReceiver(Receiver* r);
 };
 
 struct Receiver {
+    std::set<Sender*> senders; //senders this is registered with
+    EventHandle handle;
+    
     Receiver(Sender* s = 0);
+    virtual ~Receiver();
     virtual void ReceiveEvent(Event event) = 0;
+    virtual u32 ReceiverType(){ return 0; }
 };
 
+//delivers the events queued since the last call, receivers destroyed in the meantime are skipped
+//events sent while dispatching are queued for the next call
+void DispatchEvents();
+
 #endif //DESHI_EVENT_H
\ No newline at end of file
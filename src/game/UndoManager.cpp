@@ -1,5 +1,6 @@
 #include "UndoManager.h"
 #include "Transform.h"
+#include "Admin.h"
 #include "../core/input.h"
 #include "../core/console.h"
 
@@ -35,70 +36,73 @@ void RedoSelect(EditAction* edit){
 	memcpy( sel, ((u32*)edit->data) + 4, sizeof(u32)*2);
 }
 
+//returns the entity stored at the start of the edit's data, 0 if it has been deleted since
+inline Entity* EditEntity(EditAction* edit){
+	EntityHandle handle; memcpy(&handle, edit->data, sizeof(u32)*2);
+	return g_admin->GetEntity(handle);
+}
+
 //translate data layout:
-//0x00  Transform* | transform
-//0x08  vec3       | old position
-//0x14  vec3       | new position
-void UndoManager::AddUndoTranslate(Transform* t, Vector3* oldPos, Vector3* newPos){
-	Assert(sizeof(u32)*2 == sizeof(void*), "assume ptr is 8 bytes");
+//0x00  EntityHandle | entity
+//0x08  vec3         | old position
+//0x14  vec3         | new position
+void UndoManager::AddUndoTranslate(Entity* e, Vector3* oldPos, Vector3* newPos){
 	EditAction edit; edit.type = EditActionType::TRANSLATE;
-	memcpy(edit.data + 0, &t,     sizeof(u32)*2);
+	memcpy(edit.data + 0, &e->handle, sizeof(u32)*2);
 	memcpy(edit.data + 2, oldPos, sizeof(u32)*3);
 	memcpy(edit.data + 5, newPos, sizeof(u32)*3);
 	undos.push_back(edit);
 	redos.clear();
 }
 void UndoTranslate(EditAction* edit){
-	Transform* t; memcpy(&t, edit->data, sizeof(u32)*2);
-	t->position = vec3(((f32*)edit->data) + 2);
+	Entity* e = EditEntity(edit); if(!e) return;
+	e->transform.position = vec3(((f32*)edit->data) + 2);
 }
 void RedoTranslate(EditAction* edit){
-	Transform* t; memcpy(&t, edit->data, sizeof(u32)*2);
-	t->position = vec3(((f32*)edit->data) + 5);
+	Entity* e = EditEntity(edit); if(!e) return;
+	e->transform.position = vec3(((f32*)edit->data) + 5);
 }
 
 //rotate data layout:
-//0x00  Transform* | transform
-//0x08  vec3       | old rotation
-//0x14  vec3       | new rotation
-void UndoManager::AddUndoRotate(Transform* t, Vector3* oldRot, Vector3* newRot){
-	Assert(sizeof(u32)*2 == sizeof(void*), "assume ptr is 8 bytes");
+//0x00  EntityHandle | entity
+//0x08  vec3         | old rotation
+//0x14  vec3         | new rotation
+void UndoManager::AddUndoRotate(Entity* e, Vector3* oldRot, Vector3* newRot){
 	EditAction edit; edit.type = EditActionType::ROTATE;
-	memcpy(edit.data + 0, &t,     sizeof(u32)*2);
+	memcpy(edit.data + 0, &e->handle, sizeof(u32)*2);
 	memcpy(edit.data + 2, oldRot, sizeof(u32)*3);
 	memcpy(edit.data + 5, newRot, sizeof(u32)*3);
 	undos.push_back(edit);
 	redos.clear();
 }
 void UndoRotate(EditAction* edit){
-	Transform* t; memcpy(&t, edit->data, sizeof(u32)*2);
-	t->rotation = vec3(((f32*)edit->data) + 2);
+	Entity* e = EditEntity(edit); if(!e) return;
+	e->transform.rotation = vec3(((f32*)edit->data) + 2);
 }
 void RedoRotate(EditAction* edit){
-	Transform* t; memcpy(&t, edit->data, sizeof(u32)*2);
-	t->rotation = vec3(((f32*)edit->data) + 5);
+	Entity* e = EditEntity(edit); if(!e) return;
+	e->transform.rotation = vec3(((f32*)edit->data) + 5);
 }
 
 //scale data layout:
-//0x00  Transform* | transform
-//0x08  vec3       | old scale
-//0x14  vec3       | new scale
-void UndoManager::AddUndoScale(Transform* t, Vector3* oldScale, Vector3* newScale){
-	Assert(sizeof(u32)*2 == sizeof(void*), "assume ptr is 8 bytes");
+//0x00  EntityHandle | entity
+//0x08  vec3         | old scale
+//0x14  vec3         | new scale
+void UndoManager::AddUndoScale(Entity* e, Vector3* oldScale, Vector3* newScale){
 	EditAction edit; edit.type = EditActionType::SCALE;
-	memcpy(edit.data + 0, &t,       sizeof(u32)*2);
+	memcpy(edit.data + 0, &e->handle, sizeof(u32)*2);
 	memcpy(edit.data + 2, oldScale, sizeof(u32)*3);
 	memcpy(edit.data + 5, newScale, sizeof(u32)*3);
 	undos.push_back(edit);
 	redos.clear();
 }
 void UndoScale(EditAction* edit){
-	Transform* t; memcpy(&t, edit->data, sizeof(u32)*2);
-	t->scale = vec3(((f32*)edit->data) + 2);
+	Entity* e = EditEntity(edit); if(!e) return;
+	e->transform.scale = vec3(((f32*)edit->data) + 2);
 }
 void RedoScale(EditAction* edit){
-	Transform* t; memcpy(&t, edit->data, sizeof(u32)*2);
-	t->scale = vec3(((f32*)edit->data) + 5);
+	Entity* e = EditEntity(edit); if(!e) return;
+	e->transform.scale = vec3(((f32*)edit->data) + 5);
 }
 
 //create data layout:
@@ -5,7 +5,7 @@
 #include "../defines.h"
 #include <deque>
 
-struct Transform;
+struct Entity;
 struct Vector3;
 
 enum struct EditActionType : u32{
@@ -29,9 +29,9 @@ struct UndoManager{
 	void Reset();
 	
 	void AddUndoSelect(void** sel, void* oldEnt, void* newEnt);
-	void AddUndoTranslate(Transform* t, Vector3* oldPos, Vector3* newPos);
-	void AddUndoRotate(Transform* t, Vector3* oldPos, Vector3* newPos);
-	void AddUndoScale(Transform* t, Vector3* oldPos, Vector3* newPos);
+	void AddUndoTranslate(Entity* e, Vector3* oldPos, Vector3* newPos);
+	void AddUndoRotate(Entity* e, Vector3* oldPos, Vector3* newPos);
+	void AddUndoScale(Entity* e, Vector3* oldPos, Vector3* newPos);
 	void AddUndoCreate();
 	void AddUndoDelete();
 	
@@ -2,6 +2,8 @@
 
 #include "../admin.h"
 
+COMPONENT_POOL_DEFINE(AudioListener);
+
 AudioListener::AudioListener() {
 	layer = ComponentLayer_Sound;
 	comptype = ComponentType_AudioListener;
@@ -48,9 +50,9 @@ void AudioListener::LoadDESH(Admin* admin, const char* data, u32& cursor, u32 co
 		memcpy(&c->position,    data+cursor, sizeof(vec3)); cursor += sizeof(vec3);
 		memcpy(&c->velocity,    data+cursor, sizeof(vec3)); cursor += sizeof(vec3);
 		memcpy(&c->orientation, data+cursor, sizeof(vec3)); cursor += sizeof(vec3);
-		EntityAt(entityID)->AddComponent(c);
+		admin->entities[entityID]->AddComponent(c);
 		c->SetCompID(compID);
 		c->SetEvent(event);
-		c->layer_index = admin->freeCompLayers[c->layer].add(c);
+		c->inLayer = true;
 	}
 }
\ No newline at end of file
@@ -9,6 +9,8 @@
 //there can only ever be one of them as far as I know.
 //this will be implemented further later
 struct AudioListener : public Component {
+	COMPONENT_POOL(AudioListener);
+	
 	Vector3 position;
 	Vector3 velocity; //these may not be necessary
 	Vector3 orientation;
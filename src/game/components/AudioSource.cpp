@@ -5,6 +5,8 @@
 #include "../transform.h"
 #include "../../math/Vector.h"
 
+COMPONENT_POOL_DEFINE(AudioSource);
+
 AudioSource::AudioSource() {
 	cpystr(name, "AudioSource", DESHI_NAME_SIZE);
 	layer = ComponentLayer_Sound;
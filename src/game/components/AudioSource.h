@@ -12,6 +12,8 @@ struct Transform;
 
 //this is what OpenAL sees as the source of sound in 3D space
 struct AudioSource : public Component {
+	COMPONENT_POOL(AudioSource);
+	
 	//pointers to either a tranform or physics component
 	//physics pointer is necessary if you want to be able to apply the doppler
 	//effect to an object's sound. this also allows us to access these elements through
@@ -7,6 +7,8 @@
 #include "../../math/Math.h"
 #include "../../scene/Scene.h"
 
+COMPONENT_POOL_DEFINE(Camera);
+
 Camera::Camera(){
 	admin = g_admin;
 	cpystr(name, "Camera", DESHI_NAME_SIZE);
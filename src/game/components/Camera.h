@@ -18,6 +18,8 @@ enum OrthoViews {
 };
 
 struct Camera : public Component {
+	COMPONENT_POOL(Camera);
+	
 	Vector3 position{4.f, 3.f, -4.f};
 	Vector3 rotation{28.f, -45.f, 0.f};
 	float nearZ; //the distance from the camera's position to screen plane
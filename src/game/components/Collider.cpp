@@ -1,10 +1,130 @@
 #include "Collider.h"
 
+#if DESHI_HEADLESS
+#include "../../core/console.h"
+extern Admin* g_admin; //defined by the headless executable, which has no admin
+#else
 #include "../admin.h"
+#include "../../core/assets.h"
+#endif
+#include "../../core/time.h"
 #include "../../math/InertiaTensors.h"
-#include "../../math/math.h"
+#include "../../math/Math.h"
 #include "../../scene/Model.h"
 
+COMPONENT_POOL_DEFINE(BoxCollider);
+COMPONENT_POOL_DEFINE(AABBCollider);
+COMPONENT_POOL_DEFINE(SphereCollider);
+COMPONENT_POOL_DEFINE(LandscapeCollider);
+COMPONENT_POOL_DEFINE(ComplexCollider);
+
+//three local space vertices per triangle from every batch of the mesh
+local std::vector<Vector3> MeshTriangleVertices(Mesh* mesh){
+	std::vector<Vector3> out;
+	out.reserve(mesh->indexCount);
+	for(Batch& batch : mesh->batchArray){
+		for(u32 i = 0; i + 2 < batch.indexArray.size(); i += 3){
+			out.push_back(batch.vertexArray[batch.indexArray[i+0]].pos);
+			out.push_back(batch.vertexArray[batch.indexArray[i+1]].pos);
+			out.push_back(batch.vertexArray[batch.indexArray[i+2]].pos);
+		}
+	}
+	return out;
+}
+
+////////////////////
+//// Hull Cache ////
+////////////////////
+
+#define CONVEXHULL_CACHE_MAGIC   1280070984 //HULL
+#define CONVEXHULL_CACHE_VERSION 1
+
+//followed by each hull's vertex count, index count, center, vertices, and indices
+struct ConvexHullCacheHeader{
+	u32 magic;
+	u32 version;
+	u32 maxVertices;
+	u32 maxHulls;
+	f32 minVolumeGain;
+	u32 hullCount;
+	u64 meshHash; //of the triangles the hulls were built from, so a cache left over from an edited model is rebuilt
+};
+
+//FNV-1a over the bytes of the vertices
+local u64 HashTriangleVertices(const std::vector<Vector3>& vertices){
+	u64 hash = 14695981039346656037ULL;
+	for(const Vector3& v : vertices){
+		f32 components[3] = {v.x, v.y, v.z};
+		u8* bytes = (u8*)components;
+		forI(sizeof(components)){ hash ^= bytes[i]; hash *= 1099511628211ULL; }
+	}
+	return hash;
+}
+
+#if !DESHI_HEADLESS
+//returns false if the cache is missing, was built with different params or from a different mesh, or is cut short
+local b32 LoadConvexHulls(const std::string& path, const ConvexHullParams& params, u64 meshHash, std::vector<ConvexHull>& hulls){
+	std::vector<char> file = Assets::readFileBinary(path, 0, false);
+	if(file.size() < sizeof(ConvexHullCacheHeader)) return false;
+	const char* data = file.data();
+	u32 cursor = 0;
+	
+	ConvexHullCacheHeader header;
+	memcpy(&header, data+cursor, sizeof(ConvexHullCacheHeader)); cursor += sizeof(ConvexHullCacheHeader);
+	if(header.magic != CONVEXHULL_CACHE_MAGIC || header.version != CONVEXHULL_CACHE_VERSION || header.meshHash != meshHash
+	   || header.maxVertices != params.maxVertices || header.maxHulls != params.maxHulls || header.minVolumeGain != params.minVolumeGain) return false;
+	
+	hulls.resize(header.hullCount);
+	for(ConvexHull& hull : hulls){
+		u32 vertexCount, indexCount;
+		if(cursor + 2*sizeof(u32) + sizeof(Vector3) > file.size()) return false;
+		memcpy(&vertexCount, data+cursor, sizeof(u32));     cursor += sizeof(u32);
+		memcpy(&indexCount,  data+cursor, sizeof(u32));     cursor += sizeof(u32);
+		memcpy(&hull.center, data+cursor, sizeof(Vector3)); cursor += sizeof(Vector3);
+		if(cursor + vertexCount*sizeof(Vector3) + indexCount*sizeof(u32) > file.size()) return false;
+		hull.vertices.resize(vertexCount);
+		hull.indices.resize(indexCount);
+		memcpy(hull.vertices.data(), data+cursor, vertexCount*sizeof(Vector3)); cursor += vertexCount*sizeof(Vector3);
+		memcpy(hull.indices.data(),  data+cursor, indexCount*sizeof(u32));      cursor += indexCount*sizeof(u32);
+		forI(indexCount) if(hull.indices[i] >= vertexCount) return false;
+	}
+	return true;
+}
+
+local void SaveConvexHulls(const std::string& path, const ConvexHullParams& params, u64 meshHash, const std::vector<ConvexHull>& hulls){
+	ConvexHullCacheHeader header{CONVEXHULL_CACHE_MAGIC, CONVEXHULL_CACHE_VERSION, params.maxVertices, params.maxHulls, params.minVolumeGain, (u32)hulls.size(), meshHash};
+	std::vector<char> data((char*)&header, (char*)&header + sizeof(ConvexHullCacheHeader));
+	for(const ConvexHull& hull : hulls){
+		u32 counts[2] = {(u32)hull.vertices.size(), (u32)hull.indices.size()};
+		data.insert(data.end(), (char*)counts, (char*)counts + sizeof(counts));
+		data.insert(data.end(), (char*)&hull.center, (char*)&hull.center + sizeof(Vector3));
+		data.insert(data.end(), (char*)hull.vertices.data(), (char*)(hull.vertices.data() + hull.vertices.size()));
+		data.insert(data.end(), (char*)hull.indices.data(), (char*)(hull.indices.data() + hull.indices.size()));
+	}
+	Assets::writeFileBinary(path, data);
+}
+#endif //!DESHI_HEADLESS
+
+//hulls are only built the first time a model is loaded, after that they come from the .hull file next to it
+//meshes that werent loaded from a model file (and headless builds, which have no assets) build them every time
+local void LoadOrBuildConvexHulls(Mesh* mesh, const std::vector<Vector3>& triangles, const ConvexHullParams& params, std::vector<ConvexHull>& hulls){
+	u64 meshHash = HashTriangleVertices(triangles);
+#if !DESHI_HEADLESS
+	std::string path = Assets::assetPath(mesh->name, AssetType_Model, false);
+	if(path != ""){
+		path = path.substr(0, path.find_last_of('.')) + ".hull";
+		if(LoadConvexHulls(path, params, meshHash, hulls)) return;
+	}
+#endif //!DESHI_HEADLESS
+
+	TIMER_START(t_h);
+	ConvexDecomposition(triangles, params, hulls);
+	LOG("Built ", hulls.size(), " convex hulls for mesh '", mesh->name, "' in ", TIMER_END(t_h), "ms");
+#if !DESHI_HEADLESS
+	if(path != "") SaveConvexHulls(path, params, meshHash, hulls);
+#endif //!DESHI_HEADLESS
+}
+
 //////////////////////
 //// Box Collider ////
 //////////////////////
@@ -47,6 +167,7 @@ std::string BoxCollider::SaveTEXT(){
 					"\n");
 }
 
+#if !DESHI_HEADLESS
 void BoxCollider::LoadDESH(Admin* admin, const char* data, u32& cursor, u32 count){
 	u32 entityID = -1, compID = 0xFFFFFFFF, event = 0xFFFFFFFF;
 	u32 layer = -1;
@@ -66,12 +187,13 @@ void BoxCollider::LoadDESH(Admin* admin, const char* data, u32& cursor, u32 coun
 		memcpy(&tensor,         data+cursor, sizeof(mat3)); cursor += sizeof(mat3);
 		memcpy(&halfDimensions, data+cursor, sizeof(vec3)); cursor += sizeof(vec3);
 		BoxCollider* c = new BoxCollider(halfDimensions, tensor, layer);
-		EntityAt(entityID)->AddComponent(c);
+		admin->entities[entityID]->AddComponent(c);
 		c->SetCompID(compID);
 		c->SetEvent(event);
-		c->layer_index = admin->freeCompLayers[c->layer].add(c);
+		c->inLayer = true;
 	}
 }
+#endif //!DESHI_HEADLESS
 
 ///////////////////////
 //// AABB Collider ////
@@ -168,6 +290,7 @@ std::string AABBCollider::SaveTEXT(){
 					"\n");
 }
 
+#if !DESHI_HEADLESS
 void AABBCollider::LoadDESH(Admin* admin, const char* data, u32& cursor, u32 count){
 	u32 entityID = -1, compID = 0xFFFFFFFF, event = 0xFFFFFFFF;
 	u32 layer = -1;
@@ -187,12 +310,13 @@ void AABBCollider::LoadDESH(Admin* admin, const char* data, u32& cursor, u32 cou
 		memcpy(&tensor, data+cursor,         sizeof(mat3)); cursor += sizeof(mat3);
 		memcpy(&halfDimensions, data+cursor, sizeof(vec3)); cursor += sizeof(vec3);
 		AABBCollider* c = new AABBCollider(halfDimensions, tensor, layer);
-		EntityAt(entityID)->AddComponent(c);
+		admin->entities[entityID]->AddComponent(c);
 		c->SetCompID(compID);
 		c->SetEvent(event);
-		c->layer_index = admin->freeCompLayers[c->layer].add(c);
+		c->inLayer = true;
 	}
 }
+#endif //!DESHI_HEADLESS
 
 /////////////////////////
 //// Sphere Collider ////
@@ -235,6 +359,7 @@ std::string SphereCollider::SaveTEXT(){
 					"\n");
 }
 
+#if !DESHI_HEADLESS
 void SphereCollider::LoadDESH(Admin* admin, const char* data, u32& cursor, u32 count){
 	u32 entityID = -1, compID = 0xFFFFFFFF, event = 0xFFFFFFFF;
 	u32 layer = -1;
@@ -256,10 +381,11 @@ void SphereCollider::LoadDESH(Admin* admin, const char* data, u32& cursor, u32 c
 		SphereCollider* c = new SphereCollider(radius, tensor, layer);
 		c->SetCompID(compID);
 		c->SetEvent(event);
-		EntityAt(entityID)->AddComponent(c);
-		c->layer_index = admin->freeCompLayers[c->layer].add(c);
+		admin->entities[entityID]->AddComponent(c);
+		c->inLayer = true;
 	}
 }
+#endif //!DESHI_HEADLESS
 
 
 ////////////////////////////
@@ -286,6 +412,7 @@ LandscapeCollider::LandscapeCollider(Mesh* mesh, u32 collisionleyer, Event event
 		return;
 	}
 	
+	bvh.Build(MeshTriangleVertices(mesh));
 }
 
 std::string LandscapeCollider::SaveTEXT(){
@@ -300,7 +427,7 @@ std::string LandscapeCollider::SaveTEXT(){
 ///// Complex Collider /////
 ////////////////////////////
 
-ComplexCollider::ComplexCollider(Mesh* mesh, u32 collisionleyer, Event event, b32 nocollide) {
+ComplexCollider::ComplexCollider(Mesh* mesh, u32 collisionleyer, Event event, b32 nocollide, ConvexHullParams hullParams) {
 	admin = g_admin;
 	cpystr(name, "ComplexCollider", DESHI_NAME_SIZE);
 	comptype = ComponentType_Collider;
@@ -308,6 +435,17 @@ ComplexCollider::ComplexCollider(Mesh* mesh, u32 collisionleyer, Event event, b3
 
 
 	this->mesh = mesh;
+	this->boundingRadius = 0;
+	if(mesh){
+		for(Batch& batch : mesh->batchArray){
+			for(Vertex& v : batch.vertexArray){
+				this->boundingRadius = Max(this->boundingRadius, v.pos.mag());
+			}
+		}
+		std::vector<Vector3> triangles = MeshTriangleVertices(mesh);
+		LoadOrBuildConvexHulls(mesh, triangles, hullParams, hulls);
+		if(hulls.empty()) bvh.Build(triangles);
+	}
 }
 
 std::string ComplexCollider::SaveTEXT(){
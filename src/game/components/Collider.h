@@ -5,8 +5,8 @@
 #include "Component.h"
 #include "../../math/VectorMatrix.h"
 #include "../../utils/tuple.h"
-
-#include <set>
+#include "../../geometry/TriangleBVH.h"
+#include "../../geometry/ConvexHull.h"
 
 struct Command;
 struct Mesh;
@@ -19,6 +19,11 @@ global_ const char* ColliderTypeStrings[] = {
 	"None", "Box", "AABB", "Sphere", "Landscape", "Complex"
 };
 
+//which of the physics world's broadphase trees a collider's proxy is in, noCollide colliders are triggers
+enum BroadphaseTreeBits : u32{
+	BroadphaseTree_Dynamic, BroadphaseTree_Static, BroadphaseTree_Trigger
+}; typedef u32 BroadphaseTree;
+
 //TODO(delle,Ph) maybe add offset vec3
 struct Collider : public Component {
 	ColliderType type;
@@ -27,13 +32,20 @@ struct Collider : public Component {
 	b32 noCollide;
 	b32 sentEvent = false;
 	
-	std::set<Collider*> collided;
+	u32 broadphaseProxy = 0xFFFFFFFF; //leaf in the physics system's broadphase trees, 0xFFFFFFFF if not inserted yet
+	BroadphaseTree broadphaseTree = BroadphaseTree_Dynamic; //which tree the proxy is in
+	
+	//the collider's event handle packed as generation << 32 | slot, unlike its address this is never given to another
+	//collider once it is deleted, so the physics world keys pairs it keeps across steps on it
+	u64 Key() const { return ((u64)handle.generation << 32) | handle.index; }
 	
 	virtual void RecalculateTensor(f32 mass) {};
 };
 
 //rotatable box
 struct BoxCollider : public Collider {
+	COMPONENT_POOL(BoxCollider);
+	
 	Vector3 halfDims; //half dimensions, entity's position to the bounding box's locally positive corner
 	
 	BoxCollider(Vector3 halfDimensions, Matrix3& tensor, u32 collisionLayer = 0, Event event = Event_NONE, b32 noCollide = 0);
@@ -46,6 +58,8 @@ struct BoxCollider : public Collider {
 
 //axis-aligned bounding box
 struct AABBCollider : public Collider {
+	COMPONENT_POOL(AABBCollider);
+	
 	Vector3 halfDims; //half dimensions, entity's position to the bounding box's locally positive corner
 	
 	AABBCollider(Mesh* mesh, float mass, u32 collisionLayer = 0, Event event = Event_NONE, b32 noCollide = 0);
@@ -58,6 +72,8 @@ struct AABBCollider : public Collider {
 };
 
 struct SphereCollider : public Collider {
+	COMPONENT_POOL(SphereCollider);
+	
 	float radius;
 	
 	SphereCollider(float radius, Matrix3& tensor, u32 collisionLayer = 0, Event event = Event_NONE, b32 noCollide = 0);
@@ -70,7 +86,10 @@ struct SphereCollider : public Collider {
 
 //collider for terrain
 struct LandscapeCollider : public Collider {
+	COMPONENT_POOL(LandscapeCollider);
+	
 	std::vector<pair<AABBCollider, Vector3>> aabbcols; //aabb colliders and their local positions
+	TriangleBVH bvh; //the mesh's triangles in local space, the narrowphase tests against these
 	
 	LandscapeCollider(Mesh* mesh, u32 collisionleyer = 0, Event event = Event_NONE, b32 noCollide = 0);
 	
@@ -86,9 +105,15 @@ struct ConvexPolyCollider : public Collider {
 
 //collider defined by arbitrary mesh
 struct ComplexCollider : public Collider {
+	COMPONENT_POOL(ComplexCollider);
+	
 	Mesh* mesh;
+	f32 boundingRadius; //unscaled distance from the mesh's origin to its furthest vertex, used for broadphase bounds
+	std::vector<ConvexHull> hulls; //simplified convex pieces of the mesh in local space, what the collider is tested as
+	TriangleBVH bvh;    //the mesh's triangles in local space, only built for flat meshes that have no hulls
 	
-	ComplexCollider(Mesh* mesh, u32 collisionleyer = 0, Event event = Event_NONE, b32 noCollide = 0);
+	//the hulls are loaded from <model>.hull next to the mesh's model, or built and saved there if that is missing or stale
+	ComplexCollider(Mesh* mesh, u32 collisionleyer = 0, Event event = Event_NONE, b32 noCollide = 0, ConvexHullParams hullParams = ConvexHullParams());
 	
 	std::string SaveTEXT() override;
 	static void LoadDESH(Admin* admin, const char* fileData, u32& cursor, u32 countToLoad);
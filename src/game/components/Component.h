@@ -4,6 +4,7 @@
 
 #include "../../defines.h"
 #include "../Event.h"
+#include "../../utils/Pool.h"
 
 #include <vector>
 #include <string>
@@ -45,25 +46,36 @@ enum ComponentTypeBits : u32{
 	ComponentType_Door              = 1 << 12,
 	ComponentType_Player            = 1 << 13,
 	ComponentType_Movement          = 1 << 14,
+	ComponentType_Transform         = 1u << 31, //not a component, only used for declaring system access to Entity::transform
 }; typedef u32 ComponentType;
 global_ const char* ComponentTypeStrings[] = {
 	"None", "MeshComp", "Physics", "Collider", "ColliderBox", "ColliderAABB", "ColliderSphere", "ColliderLandscape", "AudioListener", "AudioSource", "Camera", "Light", "OrbManager", "Door", "Player", "Movement"
 };
 
+//gives a component type its own pool so 'new' and 'delete' of that type allocate from packed,
+//stable memory instead of the heap; put this in the struct and define the pool in its .cpp with
+//COMPONENT_POOL_DEFINE. derived types that dont declare their own pool fall back to the heap
+#define COMPONENT_POOL(type) \
+static Pool<type> pool; \
+static void* operator new(size_t size){ return (size == sizeof(type)) ? pool.Alloc() : ::operator new(size); } \
+static void operator delete(void* ptr, size_t size){ if(size == sizeof(type)) pool.Free(ptr); else ::operator delete(ptr); }
+#define COMPONENT_POOL_DEFINE(type) Pool<type> type::pool
+
 struct Component : public Receiver {
 	Admin* admin;
 	u32 entityID;
 	u32 compID; //this should ONLY be used for saving/loading, not indexing anykind of array for now
 	char name[DESHI_NAME_SIZE];
 	ComponentType comptype;
-	Entity* entity;
+	Entity* entity = nullptr;
 	Sender* sender = nullptr; //sender for outputting events to a list of receivers
 	Event event = Event_NONE; //event to be sent TODO(sushi) implement multiple events being able to be sent
 	ComponentLayer layer = ComponentLayer_NONE;
-	int layer_index; //index in the layer for deletion
+	b32 inLayer = false; //set once the admin adds it to its layer, only those components get updated
+	b32 threadSafe = false; //Update only touches this component, so UpdateLayer may run it on a job thread
 	
 	virtual ~Component() {
-		if(sender) sender->RemoveReceiver(this);
+		if(sender) delete sender;
 	}
 	
 	void ConnectSend(Component* c) {
@@ -79,6 +91,7 @@ struct Component : public Receiver {
 	virtual void Init() {};
 	virtual void Update() {};
 	virtual void ReceiveEvent(Event event) override {};
+	virtual u32 ReceiverType() override { return comptype; };
 	
 	virtual std::string SaveTEXT() { return ""; };
 	
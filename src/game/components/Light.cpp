@@ -2,12 +2,14 @@
 
 #include "../admin.h"
 
+COMPONENT_POOL_DEFINE(Light);
 
 Light::Light(){
 	admin = g_admin;
 	cpystr(name, "Light", DESHI_NAME_SIZE);
 	comptype = ComponentType_Light;
 	layer = ComponentLayer_Physics;
+	threadSafe = true;
 	sender = new Sender();
 }
 
@@ -19,6 +21,7 @@ Light::Light(const Vector3& position, const Vector3& direction, float brightness
 	cpystr(name, "Light", DESHI_NAME_SIZE);
 	comptype = ComponentType_Light;
 	layer = ComponentLayer_Physics;
+	threadSafe = true;
 	sender = new Sender();
 }
 
@@ -62,9 +65,9 @@ void Light::LoadDESH(Admin* admin, const char* data, u32& cursor, u32 count){
 		memcpy(&direction, data+cursor, sizeof(vec3)); cursor += sizeof(vec3);
 		memcpy(&strength,  data+cursor, sizeof(f32));  cursor += sizeof(f32);
 		Light* c = new Light(position, direction, strength);
-		EntityAt(entityID)->AddComponent(c);
+		admin->entities[entityID]->AddComponent(c);
 		c->SetCompID(compID);
 		c->SetEvent(event);
-		c->layer_index = admin->freeCompLayers[c->layer].add(c);
+		c->inLayer = true;
 	}
 }
\ No newline at end of file
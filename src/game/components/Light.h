@@ -6,6 +6,8 @@
 #include "../../math/Vector.h"
 
 struct Light : public Component {
+	COMPONENT_POOL(Light);
+	
 	Vector3 position;
 	Vector3 direction;
 	float brightness;
@@ -5,11 +5,14 @@
 #include "../../scene/Model.h"
 #include "../../scene/Scene.h"
 
+COMPONENT_POOL_DEFINE(MeshComp);
+
 MeshComp::MeshComp() {
 	admin = g_admin;
 	cpystr(name, "MeshComp", DESHI_NAME_SIZE);
 	sender = new Sender();
 	layer = ComponentLayer_Canvas;
+	threadSafe = true;
 	comptype = ComponentType_MeshComp;
 	
 	this->mesh = 0;
@@ -22,6 +25,7 @@ MeshComp::MeshComp(u32 meshID, u32 instanceID) {
 	cpystr(name, "MeshComp", DESHI_NAME_SIZE);
 	sender = new Sender();
 	layer = ComponentLayer_Canvas;
+	threadSafe = true;
 	comptype = ComponentType_MeshComp;
 	
 	
@@ -118,10 +122,10 @@ void MeshComp::LoadDESH(Admin* admin, const char* data, u32& cursor, u32 count){
 		MeshComp* c = new MeshComp(meshID, instanceID);
 		memcpy(&c->mesh_visible,   data+cursor, sizeof(b32)); cursor += sizeof(b32);
 		memcpy(&c->ENTITY_CONTROL, data+cursor, sizeof(b32)); cursor += sizeof(b32);
-		EntityAt(entityID)->AddComponent(c);
+		admin->entities[entityID]->AddComponent(c);
 		c->SetCompID(compID);
 		c->SetEvent(event);
-		c->layer_index = admin->freeCompLayers[c->layer].add(c);
+		c->inLayer = true;
 	}
 }
 
@@ -8,6 +8,8 @@ struct Mesh;
 struct Vector3;
 
 struct MeshComp : public Component {
+	COMPONENT_POOL(MeshComp);
+	
 	Mesh* mesh;
 	u32 instanceID;
 	u32 meshID;
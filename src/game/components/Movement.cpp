@@ -8,6 +8,8 @@
 #include "../../core/window.h"
 #include "../../core/time.h"
 
+COMPONENT_POOL_DEFINE(Movement);
+
 Movement::Movement() {
 	admin = g_admin;
 	layer = ComponentLayer_NONE;
@@ -48,11 +50,11 @@ Movement::Movement(Physics* phys, float gndAccel, float airAccel, float maxWalki
 void Movement::DecideContactState() {
 	bool contactMoving = false;
 	bool contactStationary = false;
-	for (auto c : phys->contacts) {
-		if (c.second == ContactMoving) {
+	for (auto& c : phys->contacts) {
+		if (c.state == ContactMoving) {
 			contactMoving = true;
 		}
-		else if (c.second == ContactStationary) contactStationary = true;
+		else if (c.state == ContactStationary) contactStationary = true;
 	}
 	
 	if (contactMoving)          phys->contactState = ContactMoving;
@@ -67,9 +69,9 @@ void Movement::DecideMovementState() {
 	if (phys->contactState == ContactNONE) { moveState = InAirNoInput; inAir = true; }
 	else {
 		bool bonGround = false;
-		for (auto& p : phys->manifolds) {
-			norm = p.second.norm.normalized();
-			if (!p.second.player) norm = -norm;
+		for (auto& m : phys->manifolds) {
+			norm = m.norm.normalized();
+			if (!m.player) norm = -norm;
 			float ang = DEGREES(asin(norm.dot(Vector3::UP)));
 			if (ang > 45) {
 				bonGround = true;
@@ -125,70 +127,68 @@ void Movement::GrabObject() {
 			//TODO(sushi, Cl) make this a function somewhere, maybe geometry, and make the editor and this call it 
 			vec3 pos = Math::ScreenToWorld(DengInput->mousePos, camera->projMat, camera->viewMat, DengWindow->dimensions);
 			
-			int closeindex = -1;
+			Entity* closest = 0;
 			f32 mint = INFINITY;
 			
 			vec3 p0, p1, p2, normal, intersect;
 			mat4 transform, rotation;
 			f32  t;
-			int  index = 0;
 			bool done = false;
-			for (Entity* e : admin->entities) {
+			for (auto& row : admin->Query<MeshComp>()) {
+				Entity* e = row.entity;
+				MeshComp* mc = row.Get<MeshComp>();
 				transform = e->transform.TransformMatrix();
 				rotation = Matrix4::RotationMatrix(e->transform.rotation);
-				if (MeshComp* mc = e->GetComponent<MeshComp>()) {
-					if (mc->mesh_visible) {
-						Mesh* m = mc->mesh;
-						for (Batch& b : m->batchArray) {
-							for (u32 i = 0; i < b.indexArray.size(); i += 3) {
-								//NOTE sushi: our normal here is now based on whatever the vertices normal is when we load the model
-								//			  so if we end up loading models and combining vertices again, this will break
-								p0 = b.vertexArray[b.indexArray[i + 0]].pos * transform;
-								p1 = b.vertexArray[b.indexArray[i + 1]].pos * transform;
-								p2 = b.vertexArray[b.indexArray[i + 2]].pos * transform;
-								normal = b.vertexArray[b.indexArray[i + 0]].normal * rotation;
+				if (mc->mesh_visible) {
+					Mesh* m = mc->mesh;
+					for (Batch& b : m->batchArray) {
+						for (u32 i = 0; i < b.indexArray.size(); i += 3) {
+							//NOTE sushi: our normal here is now based on whatever the vertices normal is when we load the model
+							//			  so if we end up loading models and combining vertices again, this will break
+							p0 = b.vertexArray[b.indexArray[i + 0]].pos * transform;
+							p1 = b.vertexArray[b.indexArray[i + 1]].pos * transform;
+							p2 = b.vertexArray[b.indexArray[i + 2]].pos * transform;
+							normal = b.vertexArray[b.indexArray[i + 0]].normal * rotation;
+							
+							//early out if triangle is not facing us
+							if (normal.dot(p0 - camera->position) < 0) {
+								//find where on the plane defined by the triangle our raycast intersects
+								intersect = Math::VectorPlaneIntersect(p0, normal, camera->position, pos, t);
 								
-								//early out if triangle is not facing us
-								if (normal.dot(p0 - camera->position) < 0) {
-									//find where on the plane defined by the triangle our raycast intersects
-									intersect = Math::VectorPlaneIntersect(p0, normal, camera->position, pos, t);
+								//early out if intersection is behind us
+								if (t > 0) {
+									//make vectors perpendicular to each edge of the triangle
+									Vector3 perp0 = normal.cross(p1 - p0).yInvert().normalized();
+									Vector3 perp1 = normal.cross(p2 - p1).yInvert().normalized();
+									Vector3 perp2 = normal.cross(p0 - p2).yInvert().normalized();
 									
-									//early out if intersection is behind us
-									if (t > 0) {
-										//make vectors perpendicular to each edge of the triangle
-										Vector3 perp0 = normal.cross(p1 - p0).yInvert().normalized();
-										Vector3 perp1 = normal.cross(p2 - p1).yInvert().normalized();
-										Vector3 perp2 = normal.cross(p0 - p2).yInvert().normalized();
+									//check that the intersection point is within the triangle and its the closest triangle found so far
+									if (
+										perp0.dot(intersect - p0) > 0 &&
+										perp1.dot(intersect - p1) > 0 &&
+										perp2.dot(intersect - p2) > 0) {
 										
-										//check that the intersection point is within the triangle and its the closest triangle found so far
-										if (
-											perp0.dot(intersect - p0) > 0 &&
-											perp1.dot(intersect - p1) > 0 &&
-											perp2.dot(intersect - p2) > 0) {
-											
-											//if its the closest triangle so far we store its index
-											if (t < mint) {
-												closeindex = index;
-												mint = t;
-												done = true;
-												break;
-											}
-											
+										//if its the closest triangle so far we store its index
+										if (t < mint) {
+											closest = e;
+											mint = t;
+											done = true;
+											break;
 										}
+										
 									}
 								}
-								if (done) break;
 							}
 							if (done) break;
 						}
+						if (done) break;
 					}
 				}
 				done = false;
-				index++;
 			}
 			
-			if (closeindex != -1) {
-				grabeephys = admin->entities[closeindex]->GetComponent<Physics>();
+			if (closest) {
+				grabeephys = closest->GetComponent<Physics>();
 				if (t <= maxGrabbingDistance
 					&& grabeephys && !grabeephys->staticPosition) {
 					grabbing = true;
@@ -229,7 +229,7 @@ void Movement::GrabObject() {
 //NOTE sushi:
 //	it's probably important to keep in mind that this function is updated alongside physics components
 //	meaning that its updated inside of PhysicsSystem, so it doesn't update once per frame and updates as many
-//	times as you have physics updating (default 300 times per second)
+//	times as you have physics updating (default 60 times per second)
 void Movement::Update() {
 	
 	DecideContactState();
@@ -320,7 +320,7 @@ void Movement::Update() {
 		if (phys->velocity != Vector3::ZERO) {
 			if (phys->velocity.mag() > 0.12) {
 				for (auto& m : phys->manifolds) {
-					Vector3 norm = m.second.norm.normalized();
+					Vector3 norm = m.norm.normalized();
 					Vector3 vPerpNorm = phys->velocity - phys->velocity.dot(norm) * norm;
 					phys->acceleration += vPerpNorm.normalized() * phys->kineticFricCoef * phys->mass * -9.81 / phys->mass;
 					phys->velocity += phys->acceleration * DengTime->fixedDeltaTime;
@@ -331,7 +331,7 @@ void Movement::Update() {
 	
 	phys->position += phys->velocity * DengTime->fixedDeltaTime;
 	
-	phys->manifolds.clear();
+	phys->manifolds.count = 0;
 	phys->acceleration = Vector3::ZERO;
 	
 	camera->position = Math::lerpv(standpos, crouchpos, timer / ttc);
@@ -381,12 +381,12 @@ void Movement::LoadDESH(Admin* admin, const char* data, u32& cursor, u32 count)
 		memcpy(&jump,              data + cursor, sizeof(bool));    cursor += sizeof(bool);
 		memcpy(&jumpImpulse,       data + cursor, sizeof(float));   cursor += sizeof(bool);
 		
-		Movement* c = new Movement(EntityAt(entityID)->GetComponent<Physics>(), gndAccel, airAccel, maxWalkingSpeed, maxRunningSpeed, maxCrouchingSpeed, jump, jumpImpulse);
-		EntityAt(entityID)->AddComponent(c);
+		Movement* c = new Movement(admin->entities[entityID]->GetComponent<Physics>(), gndAccel, airAccel, maxWalkingSpeed, maxRunningSpeed, maxCrouchingSpeed, jump, jumpImpulse);
+		admin->entities[entityID]->AddComponent(c);
 		c->SetCompID(compID);
 		c->SetEvent(event);
 		c->camera = admin->mainCamera;
-		c->layer_index = admin->freeCompLayers[c->layer].add(c);
+		c->inLayer = true;
 	}
 	
 }
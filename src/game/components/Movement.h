@@ -19,6 +19,8 @@ struct Physics;
 struct Camera;
 
 struct Movement : public Component {
+	COMPONENT_POOL(Movement);
+	
 	Vector3 inputs;
 	Physics* phys;
 	
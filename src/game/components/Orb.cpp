@@ -6,6 +6,8 @@
 #include "../../scene/Model.h"
 #include "../../scene/Scene.h"
 
+COMPONENT_POOL_DEFINE(OrbManager);
+
 OrbManager::OrbManager(){
 	admin = g_admin;
 	cpystr(name, "OrbManager", 63);
@@ -34,7 +36,7 @@ void OrbManager::Init(){
 		MeshComp* mc = new MeshComp(id);
 		orb->mc = mc;
 		mc->ENTITY_CONTROL = false;
-		EntityAt(entityID)->AddComponent(mc);
+		entity->AddComponent(mc);
 		orbs.push_back(orb);
 	}
 }
@@ -33,6 +33,8 @@ struct Orb {
 };
 
 struct OrbManager : public Component {
+	COMPONENT_POOL(OrbManager);
+	
 	int orbcount;
 	Mesh* mesh = nullptr;
 	std::vector<Orb*> orbs;
@@ -1,6 +1,13 @@
 #include "Physics.h"
 
+#if DESHI_HEADLESS
+#include "../../utils/Debug.h"
+extern Admin* g_admin; //defined by the headless executable, which has no admin
+#else
 #include "../admin.h"
+#endif
+
+COMPONENT_POOL_DEFINE(Physics);
 
 Physics::Physics() {
 	admin = g_admin;
@@ -84,26 +91,37 @@ Physics::Physics(Vector3 position, Vector3 rotation, float mass, float elasticit
 }
 
 void Physics::AddInput(Vector3 input) {
+	WakeUp();
 	inputVector += input;
 }
 
 void Physics::AddForce(Physics* creator, Vector3 force) {
-	forces.push_back(force);
-	if(creator) { creator->forces.push_back(-force); }
+	WakeUp();
+	netForce += force;
+	if(creator) { creator->WakeUp(); creator->netForce -= force; }
 }
 
 void Physics::AddFrictionForce(Physics* creator, float frictionCoef, float grav) {
-	forces.push_back(-velocity.normalized() * frictionCoef * mass * grav);
+	netForce += -velocity.normalized() * frictionCoef * mass * grav;
 }
 
 void Physics::AddImpulse(Physics* creator, Vector3 impulse) {
+	WakeUp();
 	velocity += impulse / mass;
-	if (creator) { creator->velocity -= impulse / creator->mass; }
+	if (creator) { creator->WakeUp(); creator->velocity -= impulse / creator->mass; }
 }
 
 void Physics::AddImpulseNomass(Physics* creator, Vector3 impulse) {
+	WakeUp();
 	velocity += impulse;
-	if (creator) { creator->velocity -= impulse; }
+	if (creator) { creator->WakeUp(); creator->velocity -= impulse; }
+}
+
+//only resets the timer when actually asleep, otherwise the contact impulses every tick would keep it awake
+void Physics::WakeUp() {
+	if (!sleeping) return;
+	sleeping = false;
+	sleepTimer = 0;
 }
 
 std::string Physics::SaveTEXT(){
@@ -119,9 +137,11 @@ std::string Physics::SaveTEXT(){
 					"\nstatic_position    ", (staticPosition) ? "true" : "false",
 					"\nstatic_rotation    ", (staticRotation) ? "true" : "false",
 					"\ntwod               ", (twoDphys) ? "true" : "false",
+					"\ncontinuous         ", (continuous) ? "true" : "false",
 					"\n");
 }
 
+#if !DESHI_HEADLESS
 void Physics::LoadDESH(Admin* admin, const char* data, u32& cursor, u32 count){
 	u32 entityID = 0xFFFFFFFF, compID = 0xFFFFFFFF, event = 0xFFFFFFFF;
 	vec3 position{}, rotation{}, velocity{}, accel{}, rotVel{}, rotAccel{};
@@ -151,9 +171,10 @@ void Physics::LoadDESH(Admin* admin, const char* data, u32& cursor, u32 count){
 		memcpy(&staticFricCoef,  data+cursor, sizeof(float)); cursor += sizeof(float);
 		
 		Physics* c = new Physics(position, rotation, velocity, accel, rotVel, rotAccel, elasticity, mass, staticPos, staticRot, twoDphys, kineticFricCoef, staticFricCoef);
-		EntityAt(entityID)->AddComponent(c);
+		admin->entities[entityID]->AddComponent(c);
 		c->SetCompID(compID);
 		c->SetEvent(event);
-		c->layer_index = admin->freeCompLayers[c->layer].add(c);
+		c->inLayer = true;
 	}
-}
\ No newline at end of file
+}
+#endif //!DESHI_HEADLESS
\ No newline at end of file
@@ -5,8 +5,7 @@
 #include "Component.h"
 #include "../../math/Vector.h"
 #include "../../utils/tuple.h"
-
-#include <unordered_map>
+#include "../../utils/Arena.h"
 
 typedef u32 ColliderType;
 struct Physics;
@@ -27,6 +26,8 @@ struct Manifold2 {
 	Vector2 norm;
 };
 
+#define MANIFOLD3_MAX_POINTS 4 //matches CONTACT_MAX_POINTS in PhysicsSolver.h
+
 struct Manifold3 {
 	Collider* a = nullptr;
 	Collider* b = nullptr;
@@ -38,8 +39,9 @@ struct Manifold3 {
 	b32 player = 0;
  
 	int refID = 0;
-	//point then depth
-	std::vector<pair<Vector3, float>> colpoints;
+	Vector3 colpoints[MANIFOLD3_MAX_POINTS];
+	float depth[MANIFOLD3_MAX_POINTS];
+	int nColPoints = 0;
 	
 	Vector3 norm;
 };
@@ -101,10 +103,17 @@ enum ContactState {
 	ContactMoving
 };
 
+struct BodyContact {
+	Physics* other;
+	ContactState state;
+};
+
 struct Physics : public Component {
+	COMPONENT_POOL(Physics);
+	
 	Vector3 position;
 	Vector3 rotation;
-	Vector3 scale;
+	Vector3 scale = Vector3::ONE; //the physics world scales bodies on an entity by its transform instead
 	
 	Vector3 velocity;
 	Vector3 acceleration;
@@ -114,26 +123,37 @@ struct Physics : public Component {
 	float elasticity; //less than 1 in most cases
 	float mass;
 	
-	std::vector<Vector3> forces;
+	Vector3 netForce = Vector3::ZERO; //sum of the forces added since the last tick
 	Vector3 inputVector = Vector3::ZERO;
 	
 	bool staticPosition = false;
 	bool staticRotation = false;
 	//TODO(delle,Ph) separate static movement and rotation
 	bool twoDphys = false;
-	poly* twoDpolygon = nullptr;
+	poly* twoDpolygon = nullptr; //slot in the 2D pass's poly pool, valid until the next physics step
+	bool continuous = false; //always sweep this body for continuous collision, not just when it is fast
+	u32 lodTier = 0;  //integrated every 2^lodTier ticks, set by the physics system from the camera
+	u32 lodTicks = 0; //ticks since the body was last integrated
 	
 	//this is probably temporary, i just need a way to communicate collision normals elsewhere
-	std::unordered_map<Physics*, Manifold3> manifolds;
+	//manifolds and contacts live in the physics system's step arena and stay valid through the next step
+	ArenaArray<Manifold3> manifolds;
 	
 	//NOTE these default values are really only meant for debugging
 	//and can be removed if I forget to remove them
 	//they are the values of wood against wood
 	float kineticFricCoef = 0.3;
 	float staticFricCoef = 0.42;
-	std::unordered_map<Physics*, ContactState> contacts;
+	ArenaArray<BodyContact> contacts;
 	ContactState contactState;
 	
+	//sleeping bodies are skipped by the physics tick until something wakes them
+	b32 sleeping = false;
+	f32 sleepTimer = 0;       //how long the body has been under the sleep velocity thresholds
+	u32 sleepIsland = -1;     //id of the island it fell asleep with, the whole island wakes together
+	Vector3 sleepPosition;    //position and rotation when it fell asleep, used to notice edits
+	Vector3 sleepRotation;
+	
 	Physics();
 	Physics(Vector3 position, Vector3 rotation, Vector3 velocity = Vector3::ZERO, Vector3 acceleration = Vector3::ZERO,
 			Vector3 rotVeloctiy = Vector3::ZERO,Vector3 rotAcceleration = Vector3::ZERO, float elasticity = .2f, 
@@ -157,6 +177,9 @@ struct Physics : public Component {
 	void AddImpulse(Physics* creator, Vector3 impulse);
 	void AddImpulseNomass(Physics* creator, Vector3 impulse);
 	
+	//wakes the body if it is sleeping, its island is woken by the physics system on contact
+	void WakeUp();
+	
 	std::string SaveTEXT() override;
 	static void LoadDESH(Admin* admin, const char* fileData, u32& cursor, u32 countToLoad);
 };
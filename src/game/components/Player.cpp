@@ -3,9 +3,12 @@
 #include "Movement.h"
 #include "../admin.h"
 
+COMPONENT_POOL_DEFINE(Player);
+
 Player::Player() {
 	admin = g_admin;
 	layer = ComponentLayer_Physics;
+	threadSafe = true;
 	comptype = ComponentType_Player;
 	cpystr(name, "Player", DESHI_NAME_SIZE);
 	sender = new Sender();
@@ -14,6 +17,7 @@ Player::Player() {
 Player::Player(Movement* movement) {
 	admin = g_admin;
 	layer = ComponentLayer_Physics;
+	threadSafe = true;
 	comptype = ComponentType_Player;
 	cpystr(name, "Player", DESHI_NAME_SIZE);
 	sender = new Sender();
@@ -24,6 +28,7 @@ Player::Player(Movement* movement) {
 Player::Player(Movement* movement, int health) {
 	admin = g_admin;
 	layer = ComponentLayer_Physics;
+	threadSafe = true;
 	comptype = ComponentType_Player;
 	cpystr(name, "Player", DESHI_NAME_SIZE);
 	sender = new Sender();
@@ -56,12 +61,12 @@ void Player::LoadDESH(Admin* admin, const char* data, u32& cursor, u32 count){
 		memcpy(&event, data + cursor, sizeof(u32)); cursor += sizeof(u32);
 		
 		memcpy(&health, data + cursor, sizeof(int));  cursor += sizeof(int);
-		Player* c = new Player(EntityAt(entityID)->GetComponent<Movement>(), health);
-		EntityAt(entityID)->AddComponent(c);
+		Player* c = new Player(admin->entities[entityID]->GetComponent<Movement>(), health);
+		admin->entities[entityID]->AddComponent(c);
 		c->SetCompID(compID);
 		c->SetEvent(event);
-		c->layer_index = admin->freeCompLayers[c->layer].add(c);
+		c->inLayer = true;
 	}
 	if(count > 0)
-		admin->player = EntityAt(entityID);
+		admin->player = admin->entities[entityID];
 }
\ No newline at end of file
@@ -10,6 +10,8 @@ struct Movement;
 
 //NOTE sushi: probably rename this to something more general, like an actor or something, but I don't like the name actor, so think of a better one :)
 struct Player : public Component {
+	COMPONENT_POOL(Player);
+	
 	int health;
 	
 	Movement* movement;
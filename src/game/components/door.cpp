@@ -2,6 +2,8 @@
 #include "../admin.h"
 #include "../entities/Entity.h"
 
+COMPONENT_POOL_DEFINE(Door);
+
 Door::Door(b32 isOpen){
 	admin = g_admin;
 	cpystr(name, "MeshComp", DESHI_NAME_SIZE);
@@ -38,9 +40,9 @@ void Door::LoadDESH(Admin* admin, const char* data, u32& cursor, u32 count){
 		
 		memcpy(&isOpen, data+cursor, sizeof(b32)); cursor += sizeof(b32);
 		Door* c = new Door(isOpen);
-		EntityAt(entityID)->AddComponent(c);
+		admin->entities[entityID]->AddComponent(c);
 		c->SetCompID(compID);
 		c->SetEvent(event);
-		c->layer_index = admin->freeCompLayers[c->layer].add(c);
+		c->inLayer = true;
 	}
 }
\ No newline at end of file
@@ -5,6 +5,8 @@
 #include "Component.h"
 
 struct Door : public Component{
+	COMPONENT_POOL(Door);
+	
 	b32 isOpen;
 	
 	Door(b32 isOpen = 0);
@@ -76,6 +76,7 @@ void Entity::AddComponent(Component* c) {
     if (c->comptype == ComponentType_Light) {
         DengAdmin->scene.lights.push_back(dyncast(Light, c));
     }
+    if (admin) admin->componentsVersion++;
 }
 
 void Entity::AddComponents(std::vector<Component*> comps) {
@@ -87,15 +88,16 @@ void Entity::AddComponents(std::vector<Component*> comps) {
         c->admin = this->admin;
         c->entity = this;
     }
+    if (admin) admin->componentsVersion++;
 }
 
 void Entity::RemoveComponent(Component* c) {
     if (!c) return;
     forI(components.size()) {
         if (components[i] == c) {
-            admin->freeCompLayers[c->layer].remove_from(c->layer_index);
             delete c;
             components.erase(components.begin() + i);
+            if (admin) admin->componentsVersion++;
             return;
         }
     }
@@ -105,7 +107,6 @@ void Entity::RemoveComponents(std::vector<Component*> comps) {
     while(comps.size()){
         forI(components.size()){
             if(components[i] == comps.back()){
-                admin->freeCompLayers[components[i]->layer].remove_from(components[i]->layer_index);
                 delete components[i];
                 components.erase(components.begin() + i);
                 comps.pop_back();
@@ -113,6 +114,7 @@ void Entity::RemoveComponents(std::vector<Component*> comps) {
             }
         }
     }
+    if (admin) admin->componentsVersion++;
 }
 
 ////////////////////////////
@@ -372,6 +374,9 @@ Entity* Entity::LoadTEXT(Admin* admin, std::string filepath, std::vector<pair<u3
                 else if(kv.first == "twod"){ 
                     phys->twoDphys = Assets::parse_bool(kv.second, filepath.c_str(), line_number);
                 }
+                else if(kv.first == "continuous"){ 
+                    phys->continuous = Assets::parse_bool(kv.second, filepath.c_str(), line_number);
+                }
                 else{ InvalidHeaderKeyError("physics"); }
             }break;
             case(Header::PLAYER):{
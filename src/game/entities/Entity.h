@@ -28,9 +28,20 @@ global_ const char* EntityTypeStrings[] = {
 	"Anonymous", "Player", "StaticMesh", "Trigger"
 };
 
+//reference to an entity that can outlive it, resolve it with Admin::GetEntity
+//the generation is bumped when the entity is deleted so old handles resolve to nullptr
+struct EntityHandle {
+	u32 index      = -1; //slot in the admin's entitySlots
+	u32 generation = 0;
+	
+	bool operator==(const EntityHandle& rhs) const { return index == rhs.index && generation == rhs.generation; }
+	bool operator!=(const EntityHandle& rhs) const { return !(*this == rhs); }
+};
+
 struct Entity {
 	Admin* admin; //reference to owning admin
-	u32 id;
+	u32 id; //index in the admin's entities array, changes when other entities are deleted
+	EntityHandle handle;
 	char name[DESHI_NAME_SIZE];
 	EntityType type = EntityType_Anonymous;
 	Transform transform;
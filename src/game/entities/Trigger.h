@@ -9,6 +9,8 @@ struct Physics;
 struct Collider;
 struct Mesh;
 
+//its collider is noCollide, so the physics world only tests it for overlap in the trigger stage and reports
+//bodies entering, staying in, and leaving it in PhysicsWorld::triggerEvents (PhysicsSystem::frameTriggerEvents for the game)
 struct Trigger : public Entity {
 	
 	Physics* physics;
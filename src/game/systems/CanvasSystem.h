@@ -2,11 +2,13 @@
 #ifndef SYSTEM_CANVAS_H
 #define SYSTEM_CANVAS_H
 #include "../../defines.h"
+#include "SystemScheduler.h"
 
 struct Admin;
 
 struct CanvasSystem {
 	Admin* admin;
+	SystemAccess access{0, 0, false};
 	
 	void Init(Admin* admin);
 	void Update();
@@ -0,0 +1,469 @@
+#include "PhysicsConvex.h"
+#include "../../scene/Model.h"
+#include "../../geometry/ConvexHull.h"
+
+#include <float.h>
+
+#define GJK_MAX_ITERATIONS 64
+#define GJK_TOLERANCE      1e-5f
+#define EPA_MAX_ITERATIONS 64
+#define EPA_MAX_VERTICES   (EPA_MAX_ITERATIONS + 4)
+#define EPA_MAX_FACES      (2*EPA_MAX_VERTICES)
+#define EPA_TOLERANCE      1e-4f
+
+//Vector3::cross is left handed (its y is negated), which isnt perpendicular to the inputs
+local inline Vector3 Cross(Vector3 a, Vector3 b){
+	return Vector3(a.y*b.z - a.z*b.y, a.z*b.x - a.x*b.z, a.x*b.y - a.y*b.x);
+}
+
+/////////////////
+//// support ////
+/////////////////
+
+ConvexShape ConvexShape::FromSphere(Vector3 center, f32 radius){
+	ConvexShape shape{};
+	shape.type   = ConvexShape_Sphere;
+	shape.center = center;
+	shape.radius = radius;
+	return shape;
+}
+
+ConvexShape ConvexShape::FromAABB(Vector3 center, Vector3 halfDims){
+	ConvexShape shape{};
+	shape.type     = ConvexShape_AABB;
+	shape.center   = center;
+	shape.halfDims = halfDims;
+	return shape;
+}
+
+ConvexShape ConvexShape::FromBox(Vector3 center, Vector3 rotation, Vector3 halfDims){
+	ConvexShape shape{};
+	shape.type      = ConvexShape_Box;
+	shape.center    = center;
+	shape.halfDims  = halfDims;
+	shape.transform = Matrix4::TransformationMatrix(center, rotation, Vector3::ONE);
+	return shape;
+}
+
+ConvexShape ConvexShape::FromMesh(Mesh* mesh, Vector3 position, Vector3 rotation, Vector3 scale){
+	ConvexShape shape{};
+	shape.type      = ConvexShape_Mesh;
+	shape.center    = position;
+	shape.transform = Matrix4::TransformationMatrix(position, rotation, scale);
+	shape.mesh      = mesh;
+	return shape;
+}
+
+ConvexShape ConvexShape::FromTriangle(Vector3 p0, Vector3 p1, Vector3 p2){
+	ConvexShape shape{};
+	shape.type        = ConvexShape_Triangle;
+	shape.center      = (p0 + p1 + p2) / 3.f;
+	shape.vertices[0] = p0;
+	shape.vertices[1] = p1;
+	shape.vertices[2] = p2;
+	return shape;
+}
+
+ConvexShape ConvexShape::FromHull(const ConvexHull& hull, Vector3 position, Vector3 rotation, Vector3 scale){
+	ConvexShape shape{};
+	shape.type       = ConvexShape_Hull;
+	shape.transform  = Matrix4::TransformationMatrix(position, rotation, scale);
+	shape.center     = hull.center * shape.transform;
+	shape.points     = hull.vertices.data();
+	shape.pointCount = hull.vertices.size();
+	return shape;
+}
+
+//direction in the space of the transform's rows, so that support(local direction) * transform is the world support
+local inline Vector3 LocalDirection(Matrix4& m, Vector3 d){
+	return Vector3(m.data[0]*d.x + m.data[1]*d.y + m.data[2]*d.z,
+				   m.data[4]*d.x + m.data[5]*d.y + m.data[6]*d.z,
+				   m.data[8]*d.x + m.data[9]*d.y + m.data[10]*d.z);
+}
+
+//furthest vertex of the mesh along d, which is the support of its convex hull
+//NOTE render meshes can be concave, so this cant hill climb over Triangle::nbrs since that stops at a local maximum
+local Vector3 MeshSupport(Mesh* mesh, Vector3 d){
+	Vector3 best = Vector3::ZERO;
+	f32 bestDot = -FLT_MAX;
+	for(Batch& batch : mesh->batchArray){
+		for(Vertex& v : batch.vertexArray){
+			f32 dot = v.pos.dot(d);
+			if(dot > bestDot){ bestDot = dot; best = v.pos; }
+		}
+	}
+	return best;
+}
+
+Vector3 ConvexShape::Support(Vector3 d){
+	switch(type){
+		case ConvexShape_Sphere:{
+			f32 mag = d.mag();
+			return (mag > 0) ? center + d * (radius / mag) : center;
+		}
+		case ConvexShape_AABB:{
+			return center + Vector3((d.x >= 0) ? halfDims.x : -halfDims.x,
+									(d.y >= 0) ? halfDims.y : -halfDims.y,
+									(d.z >= 0) ? halfDims.z : -halfDims.z);
+		}
+		case ConvexShape_Box:{
+			Vector3 l = LocalDirection(transform, d);
+			return Vector3((l.x >= 0) ? halfDims.x : -halfDims.x,
+						   (l.y >= 0) ? halfDims.y : -halfDims.y,
+						   (l.z >= 0) ? halfDims.z : -halfDims.z) * transform;
+		}
+		case ConvexShape_Mesh:{
+			if(!mesh) return center;
+			return MeshSupport(mesh, LocalDirection(transform, d)) * transform;
+		}
+		case ConvexShape_Triangle:{
+			f32 d0 = vertices[0].dot(d), d1 = vertices[1].dot(d), d2 = vertices[2].dot(d);
+			return (d0 >= d1 && d0 >= d2) ? vertices[0] : (d1 >= d2) ? vertices[1] : vertices[2];
+		}
+		case ConvexShape_Hull:{
+			if(!pointCount) return center;
+			Vector3 l = LocalDirection(transform, d);
+			u32 best = 0;
+			f32 bestDot = points[0].dot(l);
+			for(u32 i = 1; i < pointCount; ++i){
+				f32 dot = points[i].dot(l);
+				if(dot > bestDot){ bestDot = dot; best = i; }
+			}
+			return points[best] * transform;
+		}
+	}
+	return center;
+}
+
+void ConvexShape::Translate(Vector3 offset){
+	center += offset;
+	transform.data[12] += offset.x;
+	transform.data[13] += offset.y;
+	transform.data[14] += offset.z;
+	vertices[0] += offset;
+	vertices[1] += offset;
+	vertices[2] += offset;
+}
+
+local inline ConvexVertex MinkowskiSupport(ConvexShape& a, ConvexShape& b, Vector3 d){
+	ConvexVertex v;
+	v.a = a.Support(d);
+	v.b = b.Support(-d);
+	v.point = v.a - v.b;
+	return v;
+}
+
+/////////////
+//// GJK ////
+/////////////
+
+//closest point to the origin on the simplex, reduces the simplex to the feature it lies on and fills the
+//barycentric weights of the remaining vertices so the closest points on a and b can be rebuilt
+local Vector3 ClosestOnSegment(GJKSimplex& s, f32* w){
+	Vector3 a = s.vertices[0].point, b = s.vertices[1].point;
+	Vector3 ab = b - a;
+	f32 t = -a.dot(ab);
+	if(t <= 0){ s.count = 1; w[0] = 1; return a; }
+	f32 denom = ab.dot(ab);
+	if(t >= denom){ s.vertices[0] = s.vertices[1]; s.count = 1; w[0] = 1; return b; }
+	t /= denom;
+	w[0] = 1-t; w[1] = t;
+	return a + ab * t;
+}
+
+//Ericson, Real-Time Collision Detection 5.1.5
+local Vector3 ClosestOnTriangle(GJKSimplex& s, f32* w){
+	ConvexVertex va = s.vertices[0], vb = s.vertices[1], vc = s.vertices[2];
+	Vector3 a = va.point, b = vb.point, c = vc.point;
+	Vector3 ab = b - a, ac = c - a, ap = -a;
+	f32 d1 = ab.dot(ap), d2 = ac.dot(ap);
+	if(d1 <= 0 && d2 <= 0){ s.count = 1; w[0] = 1; return a; }
+	
+	Vector3 bp = -b;
+	f32 d3 = ab.dot(bp), d4 = ac.dot(bp);
+	if(d3 >= 0 && d4 <= d3){ s.vertices[0] = vb; s.count = 1; w[0] = 1; return b; }
+	
+	f32 vc_ = d1*d4 - d3*d2;
+	if(vc_ <= 0 && d1 >= 0 && d3 <= 0){
+		f32 t = d1 / (d1 - d3);
+		s.count = 2; w[0] = 1-t; w[1] = t;
+		return a + ab * t;
+	}
+	
+	Vector3 cp = -c;
+	f32 d5 = ab.dot(cp), d6 = ac.dot(cp);
+	if(d6 >= 0 && d5 <= d6){ s.vertices[0] = vc; s.count = 1; w[0] = 1; return c; }
+	
+	f32 vb_ = d5*d2 - d1*d6;
+	if(vb_ <= 0 && d2 >= 0 && d6 <= 0){
+		f32 t = d2 / (d2 - d6);
+		s.vertices[1] = vc; s.count = 2; w[0] = 1-t; w[1] = t;
+		return a + ac * t;
+	}
+	
+	f32 va_ = d3*d6 - d5*d4;
+	if(va_ <= 0 && (d4 - d3) >= 0 && (d5 - d6) >= 0){
+		f32 t = (d4 - d3) / ((d4 - d3) + (d5 - d6));
+		s.vertices[0] = vb; s.vertices[1] = vc; s.count = 2; w[0] = 1-t; w[1] = t;
+		return b + (c - b) * t;
+	}
+	
+	f32 denom = 1.f / (va_ + vb_ + vc_);
+	f32 v = vb_ * denom, u = vc_ * denom;
+	w[0] = 1-v-u; w[1] = v; w[2] = u;
+	return a + ab * v + ac * u;
+}
+
+local inline b32 OriginOutsidePlane(Vector3 a, Vector3 b, Vector3 c, Vector3 d){
+	Vector3 n = Cross(b - a, c - a);
+	f32 signOrigin = (-a).dot(n);
+	f32 signD = (d - a).dot(n);
+	return signOrigin * signD < 0;
+}
+
+local Vector3 ClosestOnTetrahedron(GJKSimplex& s, f32* w, b32& inside){
+	ConvexVertex v[4] = {s.vertices[0], s.vertices[1], s.vertices[2], s.vertices[3]};
+	const u32 faces[4][4] = {{0,1,2,3}, {0,2,3,1}, {0,3,1,2}, {1,3,2,0}};
+	
+	inside = true;
+	f32 bestDist = FLT_MAX;
+	Vector3 best = Vector3::ZERO;
+	GJKSimplex bestSimplex = s;
+	f32 bestW[3] = {};
+	forI(4){
+		const u32* f = faces[i];
+		if(!OriginOutsidePlane(v[f[0]].point, v[f[1]].point, v[f[2]].point, v[f[3]].point)) continue;
+		inside = false;
+		
+		GJKSimplex face;
+		face.vertices[0] = v[f[0]]; face.vertices[1] = v[f[1]]; face.vertices[2] = v[f[2]];
+		face.count = 3;
+		f32 faceW[3];
+		Vector3 p = ClosestOnTriangle(face, faceW);
+		f32 dist = p.dot(p);
+		if(dist < bestDist){
+			bestDist = dist;
+			best = p;
+			bestSimplex = face;
+			memcpy(bestW, faceW, sizeof(bestW));
+		}
+	}
+	if(inside) return Vector3::ZERO;
+	
+	s = bestSimplex;
+	memcpy(w, bestW, sizeof(bestW));
+	return best;
+}
+
+f32 GJKDistance(ConvexShape& a, ConvexShape& b, GJKSimplex& simplex, Vector3* closestA, Vector3* closestB){
+	Vector3 d = b.center - a.center;
+	if(d.dot(d) < GJK_TOLERANCE) d = Vector3::RIGHT;
+	simplex.vertices[0] = MinkowskiSupport(a, b, -d);
+	simplex.count = 1;
+	
+	f32 w[4] = {1, 0, 0, 0};
+	Vector3 v = simplex.vertices[0].point;
+	for(u32 iteration = 0; iteration < GJK_MAX_ITERATIONS; ++iteration){
+		f32 vv = v.dot(v);
+		if(vv < GJK_TOLERANCE * GJK_TOLERANCE) return 0;
+		
+		//stop once the new support point doesnt get meaningfully closer to the origin than v
+		ConvexVertex next = MinkowskiSupport(a, b, -v);
+		if(vv - v.dot(next.point) <= GJK_TOLERANCE * vv) break;
+		b32 duplicate = false;
+		forI(simplex.count) if(simplex.vertices[i].point == next.point) duplicate = true;
+		if(duplicate) break;
+		simplex.vertices[simplex.count++] = next;
+		
+		switch(simplex.count){
+			case 2: v = ClosestOnSegment(simplex, w); break;
+			case 3: v = ClosestOnTriangle(simplex, w); break;
+			case 4:{
+				b32 inside;
+				v = ClosestOnTetrahedron(simplex, w, inside);
+				if(inside) return 0;
+			}break;
+		}
+	}
+	
+	if(closestA || closestB){
+		Vector3 pa = Vector3::ZERO, pb = Vector3::ZERO;
+		forI(simplex.count){
+			pa += simplex.vertices[i].a * w[i];
+			pb += simplex.vertices[i].b * w[i];
+		}
+		if(closestA) *closestA = pa;
+		if(closestB) *closestB = pb;
+	}
+	return sqrtf(v.dot(v));
+}
+
+/////////////
+//// EPA ////
+/////////////
+
+struct EPAFace{
+	u32 v[3];
+	Vector3 normal;
+	f32 distance;
+};
+
+local inline b32 MakeFace(EPAFace& face, ConvexVertex* vertices, u32 a, u32 b, u32 c){
+	face.v[0] = a; face.v[1] = b; face.v[2] = c;
+	Vector3 n = Cross(vertices[b].point - vertices[a].point, vertices[c].point - vertices[a].point);
+	f32 mag = n.mag();
+	if(mag < 1e-12f) return false;
+	face.normal   = n / mag;
+	face.distance = face.normal.dot(vertices[a].point);
+	return true;
+}
+
+//grows the GJK simplex into a tetrahedron, touching shapes can end GJK with fewer than four points
+local b32 CompleteTetrahedron(ConvexShape& a, ConvexShape& b, GJKSimplex& s){
+	const Vector3 axes[6] = {Vector3::RIGHT, Vector3::LEFT, Vector3::UP, Vector3::DOWN, Vector3::FORWARD, Vector3::BACK};
+	if(s.count == 1){
+		forI(6){
+			ConvexVertex v = MinkowskiSupport(a, b, axes[i]);
+			if((v.point - s.vertices[0].point).mag() > GJK_TOLERANCE){ s.vertices[s.count++] = v; break; }
+		}
+	}
+	if(s.count == 2){
+		Vector3 line = s.vertices[1].point - s.vertices[0].point;
+		forI(6){
+			Vector3 dir = Cross(line, axes[i]);
+			if(dir.mag() < GJK_TOLERANCE) continue;
+			ConvexVertex v = MinkowskiSupport(a, b, dir);
+			if(Cross(v.point - s.vertices[0].point, line).mag() > GJK_TOLERANCE){ s.vertices[s.count++] = v; break; }
+		}
+	}
+	if(s.count == 3){
+		Vector3 n = Cross(s.vertices[1].point - s.vertices[0].point, s.vertices[2].point - s.vertices[0].point);
+		ConvexVertex v = MinkowskiSupport(a, b, n);
+		if(fabs((v.point - s.vertices[0].point).dot(n)) <= GJK_TOLERANCE) v = MinkowskiSupport(a, b, -n);
+		if(fabs((v.point - s.vertices[0].point).dot(n)) > GJK_TOLERANCE) s.vertices[s.count++] = v;
+	}
+	return s.count == 4;
+}
+
+b32 EPAPenetration(ConvexShape& a, ConvexShape& b, GJKSimplex& simplex, ConvexContact& out){
+	if(!CompleteTetrahedron(a, b, simplex)) return false;
+	
+	ConvexVertex vertices[EPA_MAX_VERTICES];
+	EPAFace faces[EPA_MAX_FACES];
+	u32 vertexCount = 4, faceCount = 0;
+	forI(4) vertices[i] = simplex.vertices[i];
+	
+	//wind the tetrahedron's faces outward from its centroid
+	Vector3 centroid = (vertices[0].point + vertices[1].point + vertices[2].point + vertices[3].point) / 4.f;
+	const u32 tetra[4][3] = {{0,1,2}, {0,3,1}, {0,2,3}, {1,3,2}};
+	forI(4){
+		EPAFace face;
+		if(!MakeFace(face, vertices, tetra[i][0], tetra[i][1], tetra[i][2])) return false;
+		if(face.normal.dot(vertices[tetra[i][0]].point - centroid) < 0){
+			MakeFace(face, vertices, tetra[i][0], tetra[i][2], tetra[i][1]);
+		}
+		faces[faceCount++] = face;
+	}
+	
+	u32 closest = 0;
+	for(u32 iteration = 0; iteration < EPA_MAX_ITERATIONS; ++iteration){
+		closest = 0;
+		forI(faceCount) if(faces[i].distance < faces[closest].distance) closest = i;
+		
+		ConvexVertex next = MinkowskiSupport(a, b, faces[closest].normal);
+		if(next.point.dot(faces[closest].normal) - faces[closest].distance < EPA_TOLERANCE) break;
+		if(vertexCount == EPA_MAX_VERTICES) break;
+		u32 index = vertexCount++;
+		vertices[index] = next;
+		
+		//remove the faces the new point can see and keep the edges on their boundary
+		u32 edges[EPA_MAX_FACES*3][2];
+		u32 edgeCount = 0;
+		for(u32 f = 0; f < faceCount;){
+			if(faces[f].normal.dot(next.point - vertices[faces[f].v[0]].point) <= 0){ ++f; continue; }
+			
+			forI(3){
+				u32 e0 = faces[f].v[i], e1 = faces[f].v[(i+1)%3];
+				//an edge shared by two removed faces is inside the hole, it shows up reversed the second time
+				b32 shared = false;
+				for(u32 e = 0; e < edgeCount; ++e){
+					if(edges[e][0] == e1 && edges[e][1] == e0){
+						edges[e][0] = edges[edgeCount-1][0];
+						edges[e][1] = edges[edgeCount-1][1];
+						edgeCount--;
+						shared = true;
+						break;
+					}
+				}
+				if(!shared){ edges[edgeCount][0] = e0; edges[edgeCount][1] = e1; edgeCount++; }
+			}
+			faces[f] = faces[--faceCount];
+		}
+		
+		//patch the hole with faces from the boundary edges to the new point
+		for(u32 e = 0; e < edgeCount; ++e){
+			if(faceCount == EPA_MAX_FACES) break;
+			EPAFace face;
+			if(MakeFace(face, vertices, edges[e][0], edges[e][1], index)) faces[faceCount++] = face;
+		}
+		if(faceCount == 0) return false;
+	}
+	
+	//project the origin onto the closest face and carry its barycentric weights over to the shapes
+	//running out of iterations leaves the faces changed since closest was picked
+	closest = 0;
+	forI(faceCount) if(faces[i].distance < faces[closest].distance) closest = i;
+	EPAFace& face = faces[closest];
+	ConvexVertex& va = vertices[face.v[0]];
+	ConvexVertex& vb = vertices[face.v[1]];
+	ConvexVertex& vc = vertices[face.v[2]];
+	Vector3 p  = face.normal * face.distance;
+	Vector3 v0 = vb.point - va.point, v1 = vc.point - va.point, v2 = p - va.point;
+	f32 d00 = v0.dot(v0), d01 = v0.dot(v1), d11 = v1.dot(v1), d20 = v2.dot(v0), d21 = v2.dot(v1);
+	f32 denom = d00*d11 - d01*d01;
+	f32 u = 1.f/3.f, v = 1.f/3.f;
+	if(fabs(denom) > 1e-12f){
+		u = (d11*d20 - d01*d21) / denom;
+		v = (d00*d21 - d01*d20) / denom;
+	}
+	Vector3 pointA = va.a * (1-u-v) + vb.a * u + vc.a * v;
+	
+	out.normal = face.normal;
+	out.depth  = face.distance;
+	out.point  = pointA - out.normal * (out.depth / 2);
+	return out.depth > 0;
+}
+
+b32 ConvexCollision(ConvexShape& a, ConvexShape& b, ConvexContact& out){
+	GJKSimplex simplex;
+	if(GJKDistance(a, b, simplex) > 0) return false;
+	return EPAPenetration(a, b, simplex, out);
+}
+
+//////////////////////////////
+//// continuous collision ////
+//////////////////////////////
+
+f32 ConvexTimeOfImpact(ConvexShape& a, Vector3 motionA, ConvexShape& b, Vector3 motionB, f32 tolerance, u32 maxIterations){
+	//b is held still and a moves by the relative motion, which reaches contact at the same fraction
+	Vector3 motion = motionA - motionB;
+	ConvexShape moved = a;
+	GJKSimplex simplex;
+	f32 t = 0;
+	for(u32 iteration = 0; iteration < maxIterations; ++iteration){
+		Vector3 closestA, closestB;
+		f32 distance = GJKDistance(moved, b, simplex, &closestA, &closestB);
+		if(distance <= tolerance) return (iteration == 0) ? 1.f : t; //touching at the start is left to the discrete test
+		
+		//nothing of a can cross the plane between the closest points before moving distance along its normal,
+		//so advancing by distance over the closing speed never steps past the impact
+		f32 closing = motion.dot((closestB - closestA) / distance);
+		if(closing <= 0) return 1;
+		t += (distance - tolerance / 2) / closing;
+		if(t >= 1) return 1;
+		
+		moved = a;
+		moved.Translate(motion * t);
+	}
+	return t;
+}
@@ -0,0 +1,75 @@
+#pragma once
+#ifndef SYSTEM_PHYSICS_CONVEX_H
+#define SYSTEM_PHYSICS_CONVEX_H
+
+#include "../../defines.h"
+#include "../../math/VectorMatrix.h"
+
+struct Mesh;
+struct ConvexHull;
+
+enum ConvexShapeTypeBits : u32{
+	ConvexShape_Sphere, ConvexShape_AABB, ConvexShape_Box, ConvexShape_Mesh, ConvexShape_Triangle, ConvexShape_Hull
+}; typedef u32 ConvexShapeType;
+
+//world space convex shape described only by its support function, which is all GJK and EPA need
+struct ConvexShape{
+	ConvexShapeType type;
+	Vector3 center;
+	Vector3 halfDims;    //aabb and box, already scaled
+	f32 radius;          //sphere
+	Matrix4 transform;   //box, mesh, and hull, local to world
+	Mesh* mesh;
+	Vector3 vertices[3]; //triangle
+	const Vector3* points; //hull vertices in local space, owned by the hull
+	u32 pointCount;
+	
+	static ConvexShape FromSphere(Vector3 center, f32 radius);
+	static ConvexShape FromAABB(Vector3 center, Vector3 halfDims);
+	static ConvexShape FromBox(Vector3 center, Vector3 rotation, Vector3 halfDims);
+	static ConvexShape FromMesh(Mesh* mesh, Vector3 position, Vector3 rotation, Vector3 scale);
+	static ConvexShape FromTriangle(Vector3 p0, Vector3 p1, Vector3 p2);
+	static ConvexShape FromHull(const ConvexHull& hull, Vector3 position, Vector3 rotation, Vector3 scale);
+	
+	//furthest point of the shape along direction, which doesnt need to be normalized
+	//meshes and hulls scan their vertices, so a concave mesh is treated as its convex hull
+	Vector3 Support(Vector3 direction);
+	
+	void Translate(Vector3 offset);
+};
+
+//point of the minkowski difference a - b along with the points of a and b it came from
+struct ConvexVertex{
+	Vector3 point;
+	Vector3 a;
+	Vector3 b;
+};
+
+struct GJKSimplex{
+	ConvexVertex vertices[4];
+	u32 count;
+};
+
+//penetration found by EPA, moving b by normal * depth separates the shapes
+struct ConvexContact{
+	Vector3 normal; //from a to b
+	f32 depth;
+	Vector3 point;  //halfway between the deepest points of the two shapes
+};
+
+//GJK distance between two convex shapes, returns 0 if they intersect and leaves the simplex that
+//enclosed the origin for EPA, otherwise closestA and closestB are set to the closest points
+f32 GJKDistance(ConvexShape& a, ConvexShape& b, GJKSimplex& simplex, Vector3* closestA = 0, Vector3* closestB = 0);
+
+//expands the simplex GJK ended with into the polytope face closest to the origin
+//returns false if the shapes were only touching or the polytope degenerated
+b32 EPAPenetration(ConvexShape& a, ConvexShape& b, GJKSimplex& simplex, ConvexContact& out);
+
+//GJK followed by EPA when the shapes intersect
+b32 ConvexCollision(ConvexShape& a, ConvexShape& b, ConvexContact& out);
+
+//conservative advancement of a and b translating by their motions (without rotating), returns the fraction of
+//the motion where they first come within tolerance of each other, or 1 if they dont or already were at the start
+f32 ConvexTimeOfImpact(ConvexShape& a, Vector3 motionA, ConvexShape& b, Vector3 motionB, f32 tolerance, u32 maxIterations);
+
+#endif //SYSTEM_PHYSICS_CONVEX_H
@@ -0,0 +1,161 @@
+#include "PhysicsIntegrator.h"
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#define PHYSICS_INTEGRATOR_AVX 1
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define PHYSICS_INTEGRATOR_SSE 1
+#endif
+
+void PhysicsBodiesSoA::Resize(u32 _count){
+	count = _count;
+	u32 padded = (count + PHYSICS_SIMD_WIDTH-1) / PHYSICS_SIMD_WIDTH * PHYSICS_SIMD_WIDTH;
+	for(std::vector<f32>* v : {&px, &py, &pz, &vx, &vy, &vz, &ax, &ay, &az, &fx, &fy, &fz, &invMass, &movable}){
+		v->resize(padded);
+		for(u32 i = count; i < padded; ++i) (*v)[i] = 0;
+	}
+}
+
+void PhysicsBodiesSoA::Set(u32 i, vec3 position, vec3 velocity, vec3 acceleration, vec3 force, f32 mass, b32 staticPosition){
+	px[i] = position.x;     py[i] = position.y;     pz[i] = position.z;
+	vx[i] = velocity.x;     vy[i] = velocity.y;     vz[i] = velocity.z;
+	ax[i] = acceleration.x; ay[i] = acceleration.y; az[i] = acceleration.z;
+	fx[i] = force.x;        fy[i] = force.y;        fz[i] = force.z;
+	invMass[i] = 1.f / mass;
+	movable[i] = (staticPosition) ? 0.f : 1.f;
+}
+
+void IntegrateBodiesScalar(PhysicsBodiesSoA& b, PhysicsIntegrateParams& p){
+	forI(b.count){
+		vec3 position(b.px[i], b.py[i], b.pz[i]);
+		vec3 velocity(b.vx[i], b.vy[i], b.vz[i]);
+		vec3 acceleration(b.ax[i], b.ay[i], b.az[i]);
+		vec3 force(b.fx[i], b.fy[i], b.fz[i]);
+
+		acceleration += vec3(0, -p.gravity, 0);
+		acceleration += force * b.invMass[i] - velocity.normalized() * p.airFriction;
+		if(b.movable[i] == 0) continue;
+
+		velocity += acceleration * p.deltaTime;
+		f32 velMag = velocity.mag();
+		if(velMag > p.maxVelocity){
+			velocity /= velMag;
+			velocity *= p.maxVelocity;
+		}else if(velMag < p.minVelocity){
+			velocity = vec3::ZERO;
+		}
+		position += velocity * p.deltaTime;
+
+		b.px[i] = position.x; b.py[i] = position.y; b.pz[i] = position.z;
+		b.vx[i] = velocity.x; b.vy[i] = velocity.y; b.vz[i] = velocity.z;
+	}
+}
+
+#if PHYSICS_INTEGRATOR_AVX
+local void IntegrateLanesAVX(PhysicsBodiesSoA& b, PhysicsIntegrateParams& p, u32 i){
+	__m256 zero = _mm256_setzero_ps();
+	__m256 dt   = _mm256_set1_ps(p.deltaTime);
+	__m256 px = _mm256_loadu_ps(&b.px[i]), py = _mm256_loadu_ps(&b.py[i]), pz = _mm256_loadu_ps(&b.pz[i]);
+	__m256 vx = _mm256_loadu_ps(&b.vx[i]), vy = _mm256_loadu_ps(&b.vy[i]), vz = _mm256_loadu_ps(&b.vz[i]);
+	__m256 ax = _mm256_loadu_ps(&b.ax[i]), ay = _mm256_loadu_ps(&b.ay[i]), az = _mm256_loadu_ps(&b.az[i]);
+	__m256 invMass = _mm256_loadu_ps(&b.invMass[i]);
+
+	//air friction opposes velocity, Vector3::normalized leaves velocities within its .001 epsilon of zero unscaled
+	__m256 absMask  = _mm256_castsi256_ps(_mm256_set1_epi32(0x7FFFFFFF));
+	__m256 epsilon  = _mm256_set1_ps(.001f);
+	__m256 moving   = _mm256_or_ps(_mm256_or_ps(_mm256_cmp_ps(_mm256_and_ps(vx, absMask), epsilon, _CMP_GE_OQ),
+	                                            _mm256_cmp_ps(_mm256_and_ps(vy, absMask), epsilon, _CMP_GE_OQ)),
+	                               _mm256_cmp_ps(_mm256_and_ps(vz, absMask), epsilon, _CMP_GE_OQ));
+	__m256 speed    = _mm256_sqrt_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(vx, vx), _mm256_mul_ps(vy, vy)), _mm256_mul_ps(vz, vz)));
+	__m256 airFric  = _mm256_set1_ps(p.airFriction);
+	__m256 friction = _mm256_blendv_ps(airFric, _mm256_div_ps(airFric, speed), moving);
+	ax = _mm256_add_ps(ax, _mm256_sub_ps(_mm256_mul_ps(_mm256_loadu_ps(&b.fx[i]), invMass), _mm256_mul_ps(vx, friction)));
+	ay = _mm256_add_ps(_mm256_sub_ps(ay, _mm256_set1_ps(p.gravity)), _mm256_sub_ps(_mm256_mul_ps(_mm256_loadu_ps(&b.fy[i]), invMass), _mm256_mul_ps(vy, friction)));
+	az = _mm256_add_ps(az, _mm256_sub_ps(_mm256_mul_ps(_mm256_loadu_ps(&b.fz[i]), invMass), _mm256_mul_ps(vz, friction)));
+
+	__m256 nvx = _mm256_add_ps(vx, _mm256_mul_ps(ax, dt));
+	__m256 nvy = _mm256_add_ps(vy, _mm256_mul_ps(ay, dt));
+	__m256 nvz = _mm256_add_ps(vz, _mm256_mul_ps(az, dt));
+
+	//clamp to max velocity, zero below min velocity
+	__m256 maxVel = _mm256_set1_ps(p.maxVelocity);
+	__m256 velMag = _mm256_sqrt_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(nvx, nvx), _mm256_mul_ps(nvy, nvy)), _mm256_mul_ps(nvz, nvz)));
+	__m256 scale  = _mm256_blendv_ps(_mm256_set1_ps(1.f), _mm256_div_ps(maxVel, velMag), _mm256_cmp_ps(velMag, maxVel, _CMP_GT_OQ));
+	scale = _mm256_andnot_ps(_mm256_cmp_ps(velMag, _mm256_set1_ps(p.minVelocity), _CMP_LT_OQ), scale);
+	nvx = _mm256_mul_ps(nvx, scale);
+	nvy = _mm256_mul_ps(nvy, scale);
+	nvz = _mm256_mul_ps(nvz, scale);
+
+	//static bodies keep their velocity and position
+	__m256 movable = _mm256_cmp_ps(_mm256_loadu_ps(&b.movable[i]), zero, _CMP_NEQ_OQ);
+	_mm256_storeu_ps(&b.vx[i], _mm256_blendv_ps(vx, nvx, movable));
+	_mm256_storeu_ps(&b.vy[i], _mm256_blendv_ps(vy, nvy, movable));
+	_mm256_storeu_ps(&b.vz[i], _mm256_blendv_ps(vz, nvz, movable));
+	_mm256_storeu_ps(&b.px[i], _mm256_blendv_ps(px, _mm256_add_ps(px, _mm256_mul_ps(nvx, dt)), movable));
+	_mm256_storeu_ps(&b.py[i], _mm256_blendv_ps(py, _mm256_add_ps(py, _mm256_mul_ps(nvy, dt)), movable));
+	_mm256_storeu_ps(&b.pz[i], _mm256_blendv_ps(pz, _mm256_add_ps(pz, _mm256_mul_ps(nvz, dt)), movable));
+}
+#endif //PHYSICS_INTEGRATOR_AVX
+
+#if PHYSICS_INTEGRATOR_SSE
+//SSE2 has no blendv, so selects are done with and/andnot/or
+local inline __m128 SelectSSE(__m128 mask, __m128 a, __m128 b){ return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b)); }
+
+local void IntegrateLanesSSE(PhysicsBodiesSoA& b, PhysicsIntegrateParams& p, u32 i){
+	__m128 zero = _mm_setzero_ps();
+	__m128 dt   = _mm_set1_ps(p.deltaTime);
+	__m128 px = _mm_loadu_ps(&b.px[i]), py = _mm_loadu_ps(&b.py[i]), pz = _mm_loadu_ps(&b.pz[i]);
+	__m128 vx = _mm_loadu_ps(&b.vx[i]), vy = _mm_loadu_ps(&b.vy[i]), vz = _mm_loadu_ps(&b.vz[i]);
+	__m128 ax = _mm_loadu_ps(&b.ax[i]), ay = _mm_loadu_ps(&b.ay[i]), az = _mm_loadu_ps(&b.az[i]);
+	__m128 invMass = _mm_loadu_ps(&b.invMass[i]);
+
+	//air friction opposes velocity, Vector3::normalized leaves velocities within its .001 epsilon of zero unscaled
+	__m128 absMask  = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+	__m128 epsilon  = _mm_set1_ps(.001f);
+	__m128 moving   = _mm_or_ps(_mm_or_ps(_mm_cmpge_ps(_mm_and_ps(vx, absMask), epsilon),
+	                                      _mm_cmpge_ps(_mm_and_ps(vy, absMask), epsilon)),
+	                            _mm_cmpge_ps(_mm_and_ps(vz, absMask), epsilon));
+	__m128 speed    = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(vx, vx), _mm_mul_ps(vy, vy)), _mm_mul_ps(vz, vz)));
+	__m128 airFric  = _mm_set1_ps(p.airFriction);
+	__m128 friction = SelectSSE(moving, _mm_div_ps(airFric, speed), airFric);
+	ax = _mm_add_ps(ax, _mm_sub_ps(_mm_mul_ps(_mm_loadu_ps(&b.fx[i]), invMass), _mm_mul_ps(vx, friction)));
+	ay = _mm_add_ps(_mm_sub_ps(ay, _mm_set1_ps(p.gravity)), _mm_sub_ps(_mm_mul_ps(_mm_loadu_ps(&b.fy[i]), invMass), _mm_mul_ps(vy, friction)));
+	az = _mm_add_ps(az, _mm_sub_ps(_mm_mul_ps(_mm_loadu_ps(&b.fz[i]), invMass), _mm_mul_ps(vz, friction)));
+
+	__m128 nvx = _mm_add_ps(vx, _mm_mul_ps(ax, dt));
+	__m128 nvy = _mm_add_ps(vy, _mm_mul_ps(ay, dt));
+	__m128 nvz = _mm_add_ps(vz, _mm_mul_ps(az, dt));
+
+	//clamp to max velocity, zero below min velocity
+	__m128 maxVel = _mm_set1_ps(p.maxVelocity);
+	__m128 velMag = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(nvx, nvx), _mm_mul_ps(nvy, nvy)), _mm_mul_ps(nvz, nvz)));
+	__m128 scale  = SelectSSE(_mm_cmpgt_ps(velMag, maxVel), _mm_div_ps(maxVel, velMag), _mm_set1_ps(1.f));
+	scale = _mm_andnot_ps(_mm_cmplt_ps(velMag, _mm_set1_ps(p.minVelocity)), scale);
+	nvx = _mm_mul_ps(nvx, scale);
+	nvy = _mm_mul_ps(nvy, scale);
+	nvz = _mm_mul_ps(nvz, scale);
+
+	//static bodies keep their velocity and position
+	__m128 movable = _mm_cmpneq_ps(_mm_loadu_ps(&b.movable[i]), zero);
+	_mm_storeu_ps(&b.vx[i], SelectSSE(movable, nvx, vx));
+	_mm_storeu_ps(&b.vy[i], SelectSSE(movable, nvy, vy));
+	_mm_storeu_ps(&b.vz[i], SelectSSE(movable, nvz, vz));
+	_mm_storeu_ps(&b.px[i], SelectSSE(movable, _mm_add_ps(px, _mm_mul_ps(nvx, dt)), px));
+	_mm_storeu_ps(&b.py[i], SelectSSE(movable, _mm_add_ps(py, _mm_mul_ps(nvy, dt)), py));
+	_mm_storeu_ps(&b.pz[i], SelectSSE(movable, _mm_add_ps(pz, _mm_mul_ps(nvz, dt)), pz));
+}
+#endif //PHYSICS_INTEGRATOR_SSE
+
+void IntegrateBodiesSIMD(PhysicsBodiesSoA& b, PhysicsIntegrateParams& p){
+#if PHYSICS_INTEGRATOR_AVX
+	for(u32 i = 0; i < b.count; i += PHYSICS_SIMD_WIDTH) IntegrateLanesAVX(b, p, i);
+#elif PHYSICS_INTEGRATOR_SSE
+	for(u32 i = 0; i < b.count; i += PHYSICS_SIMD_WIDTH){
+		IntegrateLanesSSE(b, p, i);
+		IntegrateLanesSSE(b, p, i+4);
+	}
+#else
+	IntegrateBodiesScalar(b, p);
+#endif
+}
@@ -0,0 +1,46 @@
+#pragma once
+#ifndef SYSTEM_PHYSICS_INTEGRATOR_H
+#define SYSTEM_PHYSICS_INTEGRATOR_H
+
+#include "../../defines.h"
+#include "../../math/Vector.h"
+
+#include <vector>
+
+//bodies are integrated this many at a time, arrays are padded to a multiple of it
+#define PHYSICS_SIMD_WIDTH 8
+
+//structure-of-arrays copy of the linear state of the bodies being integrated this tick
+//PhysicsSystem gathers into this, runs an integrate function over it, then scatters the results back
+struct PhysicsBodiesSoA{
+	u32 count = 0; //real bodies, the padding after them is zeroed
+	std::vector<f32> px, py, pz;
+	std::vector<f32> vx, vy, vz;
+	std::vector<f32> ax, ay, az; //acceleration carried into the tick
+	std::vector<f32> fx, fy, fz; //sum of forces from PhysicsTickForces
+	std::vector<f32> invMass;
+	std::vector<f32> movable;    //1 if the body doesnt have staticPosition, 0 otherwise
+
+	//sets count and sizes the arrays to fit it with padding
+	void Resize(u32 count);
+
+	//copies a body into slot i
+	void Set(u32 i, vec3 position, vec3 velocity, vec3 acceleration, vec3 force, f32 mass, b32 staticPosition);
+};
+
+struct PhysicsIntegrateParams{
+	f32 deltaTime;
+	f32 gravity;
+	f32 airFriction; //acceleration opposing velocity, frictionAir * 9.807
+	f32 minVelocity;
+	f32 maxVelocity;
+};
+
+//euler integration of gravity, air friction, the force sums, and velocity clamping, the same math as
+//PhysicsTickLinear but one body at a time through Vector3; used as the reference for the SIMD version
+void IntegrateBodiesScalar(PhysicsBodiesSoA& bodies, PhysicsIntegrateParams& params);
+
+//the same integration PHYSICS_SIMD_WIDTH bodies at a time with AVX (or two SSE halves without it)
+void IntegrateBodiesSIMD(PhysicsBodiesSoA& bodies, PhysicsIntegrateParams& params);
+
+#endif //SYSTEM_PHYSICS_INTEGRATOR_H
@@ -0,0 +1,231 @@
+#include "PhysicsPrimitives.h"
+
+#include <cmath>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#define PHYSICS_PRIMITIVES_AVX 1
+#define PRIMITIVE_LANES 8 //lanes a kernel tests at once
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define PHYSICS_PRIMITIVES_SSE 1
+#define PRIMITIVE_LANES 4
+#elif defined(__aarch64__) || defined(_M_ARM64) //32-bit NEON has no vector sqrt, so it uses the scalar kernels
+#include <arm_neon.h>
+#define PHYSICS_PRIMITIVES_NEON 1
+#define PRIMITIVE_LANES 4
+#endif
+
+void PrimitiveLanes::AddSphere(Vector3 center, f32 _radius, u32 _id){
+	x[count] = center.x; y[count] = center.y; z[count] = center.z;
+	radius[count] = _radius;
+	id[count] = _id;
+	count++;
+}
+
+void PrimitiveLanes::AddAABB(Vector3 min, Vector3 max, u32 _id){
+	minX[count] = min.x; minY[count] = min.y; minZ[count] = min.z;
+	maxX[count] = max.x; maxY[count] = max.y; maxZ[count] = max.z;
+	id[count] = _id;
+	count++;
+}
+
+void PrimitiveLanes::Pad(){
+#ifdef PRIMITIVE_LANES
+	u32 end = (count + PRIMITIVE_LANES-1) / PRIMITIVE_LANES * PRIMITIVE_LANES;
+#else
+	u32 end = count; //the scalar kernels only read the lanes in use
+#endif
+	for(u32 i = count; i < end; ++i){
+		x[i] = y[i] = z[i] = radius[i] = 0;
+		minX[i] = minY[i] = minZ[i] = maxX[i] = maxY[i] = maxZ[i] = 0;
+	}
+}
+
+//bits of the lanes that hold a collider
+local inline u32 LaneMask(PrimitiveLanes& l){
+	return (1u << l.count) - 1;
+}
+
+////////////////
+//// scalar ////
+////////////////
+
+//SphereSphereCollision: the sum of the radii is greater than the distance between the centers
+u32 SphereVsSpheresScalar(Vector3 center, f32 radius, PrimitiveLanes& l){
+	u32 mask = 0;
+	forI(l.count){
+		f32 dx = l.x[i] - center.x, dy = l.y[i] - center.y, dz = l.z[i] - center.z;
+		if(radius + l.radius[i] > sqrtf(dx * dx + dy * dy + dz * dz)) mask |= 1 << i;
+	}
+	return mask;
+}
+
+//AABBSphereCollision: the closest point of the AABB is less than the radius from the sphere's center
+u32 SphereVsAABBsScalar(Vector3 center, f32 radius, PrimitiveLanes& l){
+	u32 mask = 0;
+	forI(l.count){
+		f32 dx = center.x - fmaxf(l.minX[i], fminf(center.x, l.maxX[i]));
+		f32 dy = center.y - fmaxf(l.minY[i], fminf(center.y, l.maxY[i]));
+		f32 dz = center.z - fmaxf(l.minZ[i], fminf(center.z, l.maxZ[i]));
+		if(sqrtf(dx * dx + dy * dy + dz * dz) < radius) mask |= 1 << i;
+	}
+	return mask;
+}
+
+u32 AABBVsSpheresScalar(Vector3 min, Vector3 max, PrimitiveLanes& l){
+	u32 mask = 0;
+	forI(l.count){
+		f32 dx = l.x[i] - fmaxf(min.x, fminf(l.x[i], max.x));
+		f32 dy = l.y[i] - fmaxf(min.y, fminf(l.y[i], max.y));
+		f32 dz = l.z[i] - fmaxf(min.z, fminf(l.z[i], max.z));
+		if(sqrtf(dx * dx + dy * dy + dz * dz) < l.radius[i]) mask |= 1 << i;
+	}
+	return mask;
+}
+
+//AABBAABBCollision: the boxes overlap or touch on every axis
+u32 AABBVsAABBsScalar(Vector3 min, Vector3 max, PrimitiveLanes& l){
+	u32 mask = 0;
+	forI(l.count){
+		if(min.x <= l.maxX[i] && max.x >= l.minX[i] &&
+		   min.y <= l.maxY[i] && max.y >= l.minY[i] &&
+		   min.z <= l.maxZ[i] && max.z >= l.minZ[i]) mask |= 1 << i;
+	}
+	return mask;
+}
+
+//////////////
+//// SIMD ////
+//////////////
+
+//the kernels are written once over these wrappers, which each test PRIMITIVE_LANES lanes
+#if PHYSICS_PRIMITIVES_AVX
+typedef __m256 LanesF32;
+typedef __m256 LanesMask;
+local inline LanesF32  LoadLanes(const f32* p){ return _mm256_load_ps(p); }
+local inline LanesF32  SetLanes(f32 v){ return _mm256_set1_ps(v); }
+local inline LanesF32  AddLanes(LanesF32 a, LanesF32 b){ return _mm256_add_ps(a, b); }
+local inline LanesF32  SubLanes(LanesF32 a, LanesF32 b){ return _mm256_sub_ps(a, b); }
+local inline LanesF32  MulLanes(LanesF32 a, LanesF32 b){ return _mm256_mul_ps(a, b); }
+local inline LanesF32  MinLanes(LanesF32 a, LanesF32 b){ return _mm256_min_ps(a, b); }
+local inline LanesF32  MaxLanes(LanesF32 a, LanesF32 b){ return _mm256_max_ps(a, b); }
+local inline LanesF32  SqrtLanes(LanesF32 a){ return _mm256_sqrt_ps(a); }
+local inline LanesMask LessLanes(LanesF32 a, LanesF32 b){ return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+local inline LanesMask LessEqualLanes(LanesF32 a, LanesF32 b){ return _mm256_cmp_ps(a, b, _CMP_LE_OQ); }
+local inline LanesMask AndLanes(LanesMask a, LanesMask b){ return _mm256_and_ps(a, b); }
+local inline u32       MaskBits(LanesMask m){ return (u32)_mm256_movemask_ps(m); }
+#elif PHYSICS_PRIMITIVES_SSE
+typedef __m128 LanesF32;
+typedef __m128 LanesMask;
+local inline LanesF32  LoadLanes(const f32* p){ return _mm_load_ps(p); }
+local inline LanesF32  SetLanes(f32 v){ return _mm_set1_ps(v); }
+local inline LanesF32  AddLanes(LanesF32 a, LanesF32 b){ return _mm_add_ps(a, b); }
+local inline LanesF32  SubLanes(LanesF32 a, LanesF32 b){ return _mm_sub_ps(a, b); }
+local inline LanesF32  MulLanes(LanesF32 a, LanesF32 b){ return _mm_mul_ps(a, b); }
+local inline LanesF32  MinLanes(LanesF32 a, LanesF32 b){ return _mm_min_ps(a, b); }
+local inline LanesF32  MaxLanes(LanesF32 a, LanesF32 b){ return _mm_max_ps(a, b); }
+local inline LanesF32  SqrtLanes(LanesF32 a){ return _mm_sqrt_ps(a); }
+local inline LanesMask LessLanes(LanesF32 a, LanesF32 b){ return _mm_cmplt_ps(a, b); }
+local inline LanesMask LessEqualLanes(LanesF32 a, LanesF32 b){ return _mm_cmple_ps(a, b); }
+local inline LanesMask AndLanes(LanesMask a, LanesMask b){ return _mm_and_ps(a, b); }
+local inline u32       MaskBits(LanesMask m){ return (u32)_mm_movemask_ps(m); }
+#elif PHYSICS_PRIMITIVES_NEON
+typedef float32x4_t LanesF32;
+typedef uint32x4_t  LanesMask;
+local inline LanesF32  LoadLanes(const f32* p){ return vld1q_f32(p); }
+local inline LanesF32  SetLanes(f32 v){ return vdupq_n_f32(v); }
+local inline LanesF32  AddLanes(LanesF32 a, LanesF32 b){ return vaddq_f32(a, b); }
+local inline LanesF32  SubLanes(LanesF32 a, LanesF32 b){ return vsubq_f32(a, b); }
+local inline LanesF32  MulLanes(LanesF32 a, LanesF32 b){ return vmulq_f32(a, b); }
+local inline LanesF32  MinLanes(LanesF32 a, LanesF32 b){ return vminq_f32(a, b); }
+local inline LanesF32  MaxLanes(LanesF32 a, LanesF32 b){ return vmaxq_f32(a, b); }
+local inline LanesF32  SqrtLanes(LanesF32 a){ return vsqrtq_f32(a); }
+local inline LanesMask LessLanes(LanesF32 a, LanesF32 b){ return vcltq_f32(a, b); }
+local inline LanesMask LessEqualLanes(LanesF32 a, LanesF32 b){ return vcleq_f32(a, b); }
+local inline LanesMask AndLanes(LanesMask a, LanesMask b){ return vandq_u32(a, b); }
+local inline u32       MaskBits(LanesMask m){
+	const u32 bits[4] = {1, 2, 4, 8};
+	return vaddvq_u32(vandq_u32(m, vld1q_u32(bits)));
+}
+#endif
+
+#ifdef PRIMITIVE_LANES
+//the products are summed in the same order as Vector3::mag
+local inline LanesF32 LengthLanes(LanesF32 x, LanesF32 y, LanesF32 z){
+	return SqrtLanes(AddLanes(AddLanes(MulLanes(x, x), MulLanes(y, y)), MulLanes(z, z)));
+}
+
+//fminf/fmaxf clamp of the point between the box's min and max, the lanes arent NaN so min/max match them
+local inline LanesF32 ClampLanes(LanesF32 point, LanesF32 min, LanesF32 max){
+	return MaxLanes(min, MinLanes(point, max));
+}
+
+local inline u32 SphereVsSpheresLanes(Vector3 c, f32 r, PrimitiveLanes& l, u32 i){
+	LanesF32 dx = SubLanes(LoadLanes(&l.x[i]), SetLanes(c.x));
+	LanesF32 dy = SubLanes(LoadLanes(&l.y[i]), SetLanes(c.y));
+	LanesF32 dz = SubLanes(LoadLanes(&l.z[i]), SetLanes(c.z));
+	return MaskBits(LessLanes(LengthLanes(dx, dy, dz), AddLanes(SetLanes(r), LoadLanes(&l.radius[i]))));
+}
+
+local inline u32 SphereVsAABBsLanes(Vector3 c, f32 r, PrimitiveLanes& l, u32 i){
+	LanesF32 cx = SetLanes(c.x), cy = SetLanes(c.y), cz = SetLanes(c.z);
+	LanesF32 dx = SubLanes(cx, ClampLanes(cx, LoadLanes(&l.minX[i]), LoadLanes(&l.maxX[i])));
+	LanesF32 dy = SubLanes(cy, ClampLanes(cy, LoadLanes(&l.minY[i]), LoadLanes(&l.maxY[i])));
+	LanesF32 dz = SubLanes(cz, ClampLanes(cz, LoadLanes(&l.minZ[i]), LoadLanes(&l.maxZ[i])));
+	return MaskBits(LessLanes(LengthLanes(dx, dy, dz), SetLanes(r)));
+}
+
+local inline u32 AABBVsSpheresLanes(Vector3 min, Vector3 max, PrimitiveLanes& l, u32 i){
+	LanesF32 x = LoadLanes(&l.x[i]), y = LoadLanes(&l.y[i]), z = LoadLanes(&l.z[i]);
+	LanesF32 dx = SubLanes(x, ClampLanes(x, SetLanes(min.x), SetLanes(max.x)));
+	LanesF32 dy = SubLanes(y, ClampLanes(y, SetLanes(min.y), SetLanes(max.y)));
+	LanesF32 dz = SubLanes(z, ClampLanes(z, SetLanes(min.z), SetLanes(max.z)));
+	return MaskBits(LessLanes(LengthLanes(dx, dy, dz), LoadLanes(&l.radius[i])));
+}
+
+local inline u32 AABBVsAABBsLanes(Vector3 min, Vector3 max, PrimitiveLanes& l, u32 i){
+	LanesMask overlap =          AndLanes(LessEqualLanes(SetLanes(min.x), LoadLanes(&l.maxX[i])), LessEqualLanes(LoadLanes(&l.minX[i]), SetLanes(max.x)));
+	overlap = AndLanes(overlap, AndLanes(LessEqualLanes(SetLanes(min.y), LoadLanes(&l.maxY[i])), LessEqualLanes(LoadLanes(&l.minY[i]), SetLanes(max.y))));
+	overlap = AndLanes(overlap, AndLanes(LessEqualLanes(SetLanes(min.z), LoadLanes(&l.maxZ[i])), LessEqualLanes(LoadLanes(&l.minZ[i]), SetLanes(max.z))));
+	return MaskBits(overlap);
+}
+
+//runs a lanes kernel over every group of PRIMITIVE_LANES that has a collider in it
+#define PRIMITIVE_KERNEL(kernel, a, b, l)                                                                       \
+u32 mask = 0;                                                                                                   \
+for(u32 i = 0; i < l.count; i += PRIMITIVE_LANES) mask |= kernel(a, b, l, i) << i;                              \
+return mask & LaneMask(l)
+#endif //PRIMITIVE_LANES
+
+u32 SphereVsSpheresSIMD(Vector3 center, f32 radius, PrimitiveLanes& spheres){
+#ifdef PRIMITIVE_LANES
+	PRIMITIVE_KERNEL(SphereVsSpheresLanes, center, radius, spheres);
+#else
+	return SphereVsSpheresScalar(center, radius, spheres);
+#endif
+}
+
+u32 SphereVsAABBsSIMD(Vector3 center, f32 radius, PrimitiveLanes& aabbs){
+#ifdef PRIMITIVE_LANES
+	PRIMITIVE_KERNEL(SphereVsAABBsLanes, center, radius, aabbs);
+#else
+	return SphereVsAABBsScalar(center, radius, aabbs);
+#endif
+}
+
+u32 AABBVsSpheresSIMD(Vector3 min, Vector3 max, PrimitiveLanes& spheres){
+#ifdef PRIMITIVE_LANES
+	PRIMITIVE_KERNEL(AABBVsSpheresLanes, min, max, spheres);
+#else
+	return AABBVsSpheresScalar(min, max, spheres);
+#endif
+}
+
+u32 AABBVsAABBsSIMD(Vector3 min, Vector3 max, PrimitiveLanes& aabbs){
+#ifdef PRIMITIVE_LANES
+	PRIMITIVE_KERNEL(AABBVsAABBsLanes, min, max, aabbs);
+#else
+	return AABBVsAABBsScalar(min, max, aabbs);
+#endif
+}
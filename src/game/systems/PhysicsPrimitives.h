@@ -0,0 +1,53 @@
+#pragma once
+#ifndef SYSTEM_PHYSICS_PRIMITIVES_H
+#define SYSTEM_PHYSICS_PRIMITIVES_H
+
+#include "../../defines.h"
+#include "../../math/Vector.h"
+#include "PhysicsIntegrator.h"
+
+//bodies with fewer candidates than this are tested pair by pair, since filling the lanes would cost more than it saves
+#define PRIMITIVE_MIN_CANDIDATES 4
+
+//structure-of-arrays block of up to PHYSICS_SIMD_WIDTH spheres or AABBs that one collider is tested against at once
+//the narrowphase fills one with the sphere and AABB candidates of a body, runs a kernel over it, and only generates
+//contacts for the lanes the kernel reports as hits
+struct PrimitiveLanes{
+	u32 count = 0;
+	alignas(32) f32 x[PHYSICS_SIMD_WIDTH]; //sphere centers
+	alignas(32) f32 y[PHYSICS_SIMD_WIDTH];
+	alignas(32) f32 z[PHYSICS_SIMD_WIDTH];
+	alignas(32) f32 radius[PHYSICS_SIMD_WIDTH];
+	alignas(32) f32 minX[PHYSICS_SIMD_WIDTH]; //AABB corners
+	alignas(32) f32 minY[PHYSICS_SIMD_WIDTH];
+	alignas(32) f32 minZ[PHYSICS_SIMD_WIDTH];
+	alignas(32) f32 maxX[PHYSICS_SIMD_WIDTH];
+	alignas(32) f32 maxY[PHYSICS_SIMD_WIDTH];
+	alignas(32) f32 maxZ[PHYSICS_SIMD_WIDTH];
+	u32 id[PHYSICS_SIMD_WIDTH]; //the caller's handle for each lane
+	
+	//a block only holds one kind, since a kernel only reads the arrays of that kind
+	void AddSphere(Vector3 center, f32 radius, u32 id);
+	void AddAABB(Vector3 min, Vector3 max, u32 id);
+	
+	//zeroes the lanes past count that the kernels read, so they never test garbage
+	void Pad();
+};
+
+//each kernel returns a mask with bit n set if lane n overlaps the one collider, using exactly the math of the scalar
+//narrowphase tests in PhysicsWorld.cpp so a lane is a hit if and only if its pair test would find an overlap
+//AABBs are given by their corners, which have to be center -/+ scaled half dims like the pair tests compute them
+//the scalar versions are the reference and what the SIMD versions fall back to without SSE2 or 64-bit NEON
+u32 SphereVsSpheresScalar(Vector3 center, f32 radius, PrimitiveLanes& spheres);
+u32 SphereVsAABBsScalar(Vector3 center, f32 radius, PrimitiveLanes& aabbs);
+u32 AABBVsSpheresScalar(Vector3 min, Vector3 max, PrimitiveLanes& spheres);
+u32 AABBVsAABBsScalar(Vector3 min, Vector3 max, PrimitiveLanes& aabbs);
+
+//AVX tests all the lanes at once, SSE2 and NEON test them as two halves
+//NOTE builds for arm need -ffp-contract=off so the sums arent fused differently than the scalar ones
+u32 SphereVsSpheresSIMD(Vector3 center, f32 radius, PrimitiveLanes& spheres);
+u32 SphereVsAABBsSIMD(Vector3 center, f32 radius, PrimitiveLanes& aabbs);
+u32 AABBVsSpheresSIMD(Vector3 min, Vector3 max, PrimitiveLanes& spheres);
+u32 AABBVsAABBsSIMD(Vector3 min, Vector3 max, PrimitiveLanes& aabbs);
+
+#endif //SYSTEM_PHYSICS_PRIMITIVES_H
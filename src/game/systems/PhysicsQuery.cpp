@@ -0,0 +1,49 @@
+#include "PhysicsQuery.h"
+#include "../../geometry/AABBTree.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define PHYSICS_QUERY_SSE 1
+#endif
+
+void RayPacket::Set(u32 lane, Vector3 origin, Vector3 direction, f32 maxDistance){
+	ox[lane] = origin.x; oy[lane] = origin.y; oz[lane] = origin.z;
+	ix[lane] = 1.f / direction.x; iy[lane] = 1.f / direction.y; iz[lane] = 1.f / direction.z;
+	maxT[lane] = maxDistance;
+}
+
+void RayPacket::Clear(u32 lane){
+	ox[lane] = oy[lane] = oz[lane] = 0;
+	ix[lane] = iy[lane] = iz[lane] = 1;
+	maxT[lane] = -1;
+}
+
+u32 RayPacketAABBScalar(const RayPacket& r, const AABB& aabb){
+	u32 mask = 0;
+	forI(RAY_PACKET_WIDTH){
+		f32 x0 = (aabb.min.x - r.ox[i]) * r.ix[i], x1 = (aabb.max.x - r.ox[i]) * r.ix[i];
+		f32 y0 = (aabb.min.y - r.oy[i]) * r.iy[i], y1 = (aabb.max.y - r.oy[i]) * r.iy[i];
+		f32 z0 = (aabb.min.z - r.oz[i]) * r.iz[i], z1 = (aabb.max.z - r.oz[i]) * r.iz[i];
+		f32 enter = Max(Max(Min(x0, x1), Min(y0, y1)), Max(Min(z0, z1), 0.f));
+		f32 exit  = Min(Min(Max(x0, x1), Max(y0, y1)), Min(Max(z0, z1), r.maxT[i]));
+		if(enter <= exit) mask |= 1 << i;
+	}
+	return mask;
+}
+
+u32 RayPacketAABBSIMD(const RayPacket& r, const AABB& aabb){
+#if PHYSICS_QUERY_SSE
+	__m128 ix = _mm_loadu_ps(r.ix), iy = _mm_loadu_ps(r.iy), iz = _mm_loadu_ps(r.iz);
+	__m128 x0 = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(aabb.min.x), _mm_loadu_ps(r.ox)), ix);
+	__m128 x1 = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(aabb.max.x), _mm_loadu_ps(r.ox)), ix);
+	__m128 y0 = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(aabb.min.y), _mm_loadu_ps(r.oy)), iy);
+	__m128 y1 = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(aabb.max.y), _mm_loadu_ps(r.oy)), iy);
+	__m128 z0 = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(aabb.min.z), _mm_loadu_ps(r.oz)), iz);
+	__m128 z1 = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(aabb.max.z), _mm_loadu_ps(r.oz)), iz);
+	__m128 enter = _mm_max_ps(_mm_max_ps(_mm_min_ps(x0, x1), _mm_min_ps(y0, y1)), _mm_max_ps(_mm_min_ps(z0, z1), _mm_setzero_ps()));
+	__m128 exit  = _mm_min_ps(_mm_min_ps(_mm_max_ps(x0, x1), _mm_max_ps(y0, y1)), _mm_min_ps(_mm_max_ps(z0, z1), _mm_loadu_ps(r.maxT)));
+	return _mm_movemask_ps(_mm_cmple_ps(enter, exit));
+#else
+	return RayPacketAABBScalar(r, aabb);
+#endif
+}
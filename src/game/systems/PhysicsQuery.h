@@ -0,0 +1,52 @@
+#pragma once
+#ifndef SYSTEM_PHYSICS_QUERY_H
+#define SYSTEM_PHYSICS_QUERY_H
+
+#include "../../defines.h"
+#include "../../math/Vector.h"
+
+struct AABB;
+struct Entity;
+struct Collider;
+
+//rays are tested against broadphase nodes this many at a time
+#define RAY_PACKET_WIDTH 4
+
+//collision layers a query looks at, bit n is collisionLayer n
+#define QUERY_ALL_LAYERS 0xFFFFFFFF
+
+struct PhysicsRay{
+	Vector3 origin;
+	Vector3 direction; //normalized
+	f32 maxDistance;
+	u32 layerMask = QUERY_ALL_LAYERS;
+	b32 hitTriggers = false; //whether noCollide colliders can be hit
+};
+
+struct RaycastHit{
+	Entity* entity;     //0 if nothing was hit
+	Collider* collider;
+	Vector3 point;
+	Vector3 normal;     //surface normal at the point, facing back along the query
+	f32 distance;
+};
+
+//structure-of-arrays copy of up to RAY_PACKET_WIDTH rays so a node's aabb is tested against all of them at once
+//lanes without a ray have a negative maxT, which never enters anything
+struct RayPacket{
+	f32 ox[RAY_PACKET_WIDTH], oy[RAY_PACKET_WIDTH], oz[RAY_PACKET_WIDTH];
+	f32 ix[RAY_PACKET_WIDTH], iy[RAY_PACKET_WIDTH], iz[RAY_PACKET_WIDTH]; //reciprocal of the direction
+	f32 maxT[RAY_PACKET_WIDTH]; //distance to the closest hit so far, nodes further than it are skipped
+	
+	void Set(u32 lane, Vector3 origin, Vector3 direction, f32 maxDistance);
+	void Clear(u32 lane);
+};
+
+//bitmask of the lanes whose ray enters the aabb before its maxT, slab test one ray at a time
+//used as the reference for the SIMD version
+u32 RayPacketAABBScalar(const RayPacket& rays, const AABB& aabb);
+
+//the same slab test for every lane at once with SSE
+u32 RayPacketAABBSIMD(const RayPacket& rays, const AABB& aabb);
+
+#endif //SYSTEM_PHYSICS_QUERY_H
@@ -0,0 +1,191 @@
+#include "PhysicsSolver.h"
+#include "../components/Physics.h"
+#include "../components/Collider.h"
+
+#include <utility>
+#include <functional>
+
+//orthonormal tangents for a unit normal, picked the same way every step so tangent impulses stay meaningful
+local void ContactTangents(Vector3 normal, Vector3& t0, Vector3& t1){
+	if(fabs(normal.x) >= 0.57735f){
+		t0 = Vector3(normal.y, -normal.x, 0).normalized();
+	}else{
+		t0 = Vector3(0, normal.z, -normal.y).normalized();
+	}
+	//written out since Vector3::cross is left handed and wouldnt be perpendicular
+	t1 = Vector3(normal.y*t0.z - normal.z*t0.y, normal.z*t0.x - normal.x*t0.z, normal.x*t0.y - normal.y*t0.x);
+}
+
+local inline f32 InverseMass(Physics* p){
+	return (p->staticPosition || p->mass <= 0) ? 0 : 1.f / p->mass;
+}
+
+void ContactCache::BeginStep(){
+	stamp++;
+}
+
+ContactManifold* ContactCache::Update(Collider* colliderA, Physics* a, Collider* colliderB, Physics* b, Vector3 normal,
+									  Vector3* points, f32* depths, u32 pointCount){
+	pointCount = Min(pointCount, (u32)CONTACT_MAX_POINTS);
+	
+	if(2*(manifolds.size() + 1) > lookup.size()) Rehash(Max(64u, 2*(u32)lookup.size()));
+	u32& slot = Slot(ContactKey{colliderA->Key(), colliderB->Key()});
+	ContactManifold* m;
+	ContactManifold old;
+	b32 existed = slot != CONTACT_CACHE_EMPTY;
+	if(existed){
+		m = &manifolds[slot];
+		old = *m;
+		
+		//flip the pair to match the manifold so its old points line up with the new ones
+		if(m->keyA != colliderA->Key()){
+			std::swap(colliderA, colliderB);
+			std::swap(a, b);
+			normal = -normal;
+		}
+	}else{
+		slot = manifolds.size();
+		manifolds.push_back(ContactManifold{});
+		m = &manifolds.back();
+		old.pointCount = 0;
+	}
+	
+	m->colliderA   = colliderA;
+	m->colliderB   = colliderB;
+	m->keyA        = colliderA->Key();
+	m->keyB        = colliderB->Key();
+	m->a           = a;
+	m->b           = b;
+	m->normal      = normal;
+	m->friction    = sqrtf(a->kineticFricCoef * b->kineticFricCoef);
+	m->restitution = (a->elasticity + b->elasticity) / 2;
+	m->stamp       = stamp;
+	m->pointCount  = pointCount;
+	ContactTangents(normal, m->tangent[0], m->tangent[1]);
+	
+	//a point keeps the impulses of the closest old point if neither body moved it far, a turned normal drops them all
+	b32 keepImpulses = existed && old.normal.dot(normal) > .99f;
+	forI(pointCount){
+		ContactPoint& p = m->points[i];
+		p.position = points[i];
+		p.depth    = depths[i];
+		p.localA   = points[i] - a->position;
+		p.localB   = points[i] - b->position;
+		p.normalImpulse     = 0;
+		p.tangentImpulse[0] = 0;
+		p.tangentImpulse[1] = 0;
+		if(!keepImpulses) continue;
+		
+		f32 closest = matchDistance * matchDistance;
+		for(u32 j = 0; j < old.pointCount; ++j){
+			f32 dist = (old.points[j].localA - p.localA).dot(old.points[j].localA - p.localA);
+			if(dist < closest){
+				closest = dist;
+				p.normalImpulse     = old.points[j].normalImpulse;
+				p.tangentImpulse[0] = old.points[j].tangentImpulse[0];
+				p.tangentImpulse[1] = old.points[j].tangentImpulse[1];
+			}
+		}
+	}
+	return m;
+}
+
+void ContactCache::EndStep(){
+	u32 count = manifolds.size();
+	for(u32 i = 0; i < manifolds.size();){
+		if(manifolds[i].stamp == stamp){ ++i; continue; }
+		
+		//swap-remove, the lookup is rebuilt afterwards so the moved manifold's index is fixed there
+		if(i != manifolds.size()-1) manifolds[i] = manifolds.back();
+		manifolds.pop_back();
+	}
+	if(manifolds.size() != count) Rehash(lookup.size());
+}
+
+void ContactCache::Clear(){
+	lookup.clear();
+	manifolds.clear();
+}
+
+u32& ContactCache::Slot(const ContactKey& key){
+	u32 mask = lookup.size() - 1;
+	for(u32 i = ContactKeyHash()(key) & mask; ; i = (i + 1) & mask){
+		u32& slot = lookup[i];
+		if(slot == CONTACT_CACHE_EMPTY || key == ContactKey{manifolds[slot].keyA, manifolds[slot].keyB}) return slot;
+	}
+}
+
+void ContactCache::Rehash(u32 size){
+	lookup.assign(size, CONTACT_CACHE_EMPTY);
+	forI(manifolds.size()) Slot(ContactKey{manifolds[i].keyA, manifolds[i].keyB}) = i;
+}
+
+local inline void ApplyImpulse(ContactManifold& m, f32 invA, f32 invB, Vector3 impulse){
+	m.a->velocity -= impulse * invA;
+	m.b->velocity += impulse * invB;
+}
+
+void SolveContacts(ContactCache& cache, ContactSolverParams& params){
+	//prestep: effective masses, restitution targets, and warm starting with last step's impulses
+	//only points that start with no impulse bounce, a resting point carrying one would re-bounce off the warm start
+	for(ContactManifold& m : cache.manifolds){
+		f32 invA = InverseMass(m.a);
+		f32 invB = InverseMass(m.b);
+		f32 invSum = invA + invB;
+		Vector3 relative = m.b->velocity - m.a->velocity;
+		f32 approach = relative.dot(m.normal);
+		forI(m.pointCount){
+			ContactPoint& p = m.points[i];
+			p.normalMass   = (invSum > 0) ? 1.f / invSum : 0;
+			p.tangentMass  = p.normalMass; //only linear velocity is solved so every direction has the same mass
+			p.velocityBias = (p.normalImpulse == 0 && approach < -params.restitutionThreshold) ? -m.restitution * approach : 0;
+			
+			if(params.warmStarting){
+				ApplyImpulse(m, invA, invB, m.normal * p.normalImpulse + m.tangent[0] * p.tangentImpulse[0] + m.tangent[1] * p.tangentImpulse[1]);
+			}else{
+				p.normalImpulse     = 0;
+				p.tangentImpulse[0] = 0;
+				p.tangentImpulse[1] = 0;
+			}
+		}
+	}
+	
+	//velocity iterations, friction is clamped by the normal impulse so it goes first with last iteration's value
+	for(u32 iteration = 0; iteration < params.iterations; ++iteration){
+		for(ContactManifold& m : cache.manifolds){
+			f32 invA = InverseMass(m.a);
+			f32 invB = InverseMass(m.b);
+			forI(m.pointCount){
+				ContactPoint& p = m.points[i];
+				
+				f32 maxFriction = m.friction * p.normalImpulse;
+				for(u32 k = 0; k < 2; ++k){
+					f32 lambda = -(m.b->velocity - m.a->velocity).dot(m.tangent[k]) * p.tangentMass;
+					f32 total  = Clamp(p.tangentImpulse[k] + lambda, -maxFriction, maxFriction);
+					lambda = total - p.tangentImpulse[k];
+					p.tangentImpulse[k] = total;
+					ApplyImpulse(m, invA, invB, m.tangent[k] * lambda);
+				}
+				
+				f32 lambda = p.normalMass * (p.velocityBias - (m.b->velocity - m.a->velocity).dot(m.normal));
+				f32 total  = Max(p.normalImpulse + lambda, 0.f);
+				lambda = total - p.normalImpulse;
+				p.normalImpulse = total;
+				ApplyImpulse(m, invA, invB, m.normal * lambda);
+			}
+		}
+	}
+	
+	//push bodies apart directly instead of adding a velocity bias, so correcting penetration doesnt add energy
+	for(ContactManifold& m : cache.manifolds){
+		f32 invA = InverseMass(m.a);
+		f32 invB = InverseMass(m.b);
+		if(invA + invB <= 0) continue;
+		
+		f32 depth = 0;
+		forI(m.pointCount) depth = Max(depth, m.points[i].depth);
+		f32 correction = Max(depth - params.penetrationSlop, 0.f) * params.positionCorrection / (invA + invB);
+		m.a->position -= m.normal * correction * invA;
+		m.b->position += m.normal * correction * invB;
+	}
+}
@@ -0,0 +1,109 @@
+#pragma once
+#ifndef SYSTEM_PHYSICS_SOLVER_H
+#define SYSTEM_PHYSICS_SOLVER_H
+
+#include "../../defines.h"
+#include "../../math/Vector.h"
+
+#include <vector>
+
+struct Physics;
+struct Collider;
+
+//most points a manifold keeps, enough for a face resting on a face
+#define CONTACT_MAX_POINTS 4
+
+struct ContactPoint{
+	Vector3 position; //world space
+	f32 depth;        //penetration along the normal, positive when overlapping
+	Vector3 localA;   //position relative to each body when it was found, used to match points across steps
+	Vector3 localB;
+	
+	//accumulated over the solver iterations and kept for warm starting the next step
+	f32 normalImpulse;
+	f32 tangentImpulse[2];
+	
+	f32 normalMass;
+	f32 tangentMass;
+	f32 velocityBias; //restitution target along the normal
+};
+
+//contact state of one collider pair, kept across steps for as long as the pair keeps touching
+struct ContactManifold{
+	Collider* colliderA;
+	Collider* colliderB;
+	u64 keyA; //Collider::Key of each, which a collider reusing a deleted one's memory doesnt share
+	u64 keyB;
+	Physics* a;
+	Physics* b;
+	Vector3 normal; //from a to b
+	Vector3 tangent[2];
+	f32 friction;
+	f32 restitution;
+	ContactPoint points[CONTACT_MAX_POINTS];
+	u32 pointCount;
+	u32 stamp; //step it was last updated on
+};
+
+#define CONTACT_CACHE_EMPTY 0xFFFFFFFF
+
+//unordered pair of Collider::Keys, so a key matches the pair either way around
+struct ContactKey{
+	u64 a;
+	u64 b;
+	
+	bool operator==(const ContactKey& other) const{ return (a == other.a && b == other.b) || (a == other.b && b == other.a); }
+};
+
+//the keys are mixed since their slots are small and close together, which would pile the pairs up in a few slots
+struct ContactKeyHash{
+	size_t operator()(const ContactKey& key) const{
+		u64 lo = Min(key.a, key.b);
+		u64 hi = Max(key.a, key.b);
+		u64 hash = (lo * 0x9E3779B97F4A7C15ULL) ^ (hi * 0xC2B2AE3D27D4EB4FULL);
+		return (size_t)(hash ^ (hash >> 32));
+	}
+};
+
+//persistent manifolds keyed by collider pair, the narrowphase updates the pairs it finds touching each step
+//and pairs it didnt find are dropped at the end of the step
+//the lookup is an open addressed table of indexes into manifolds, kept at least twice as big as them so probes stay
+//short; it is rebuilt in place when manifolds are dropped instead of deleting from it, so once the number of pairs
+//settles neither array allocates
+struct ContactCache{
+	std::vector<u32> lookup; //power of two sized, CONTACT_CACHE_EMPTY for empty slots
+	std::vector<ContactManifold> manifolds;
+	u32 stamp = 0;
+	f32 matchDistance = .05f; //how far a point's local position can move and still carry its impulses over
+	
+	void BeginStep();
+	
+	//stores this step's contacts for the pair, matching them to the last step's points so their impulses carry over
+	//a and b can be passed either way around, a new manifold keeps the order they were passed in and an existing one
+	//keeps its own, so the pair isnt ordered by where the colliders happen to be in memory; normal goes from a to b
+	ContactManifold* Update(Collider* colliderA, Physics* a, Collider* colliderB, Physics* b, Vector3 normal,
+							Vector3* points, f32* depths, u32 pointCount);
+	
+	//removes the manifolds that werent updated this step
+	void EndStep();
+	
+	void Clear();
+	
+	//slot holding the pair's manifold index, or the empty slot it would go in
+	u32& Slot(const ContactKey& key);
+	void Rehash(u32 size);
+};
+
+struct ContactSolverParams{
+	u32 iterations;
+	b32 warmStarting;
+	f32 positionCorrection;   //fraction of the penetration past the slop removed each step
+	f32 penetrationSlop;      //penetration left alone so resting contacts stay touching
+	f32 restitutionThreshold; //approach speed below which contacts dont bounce
+};
+
+//sequential impulses over every cached manifold followed by a positional correction pass
+//only linear velocity is solved, rotation in the physics tick isnt driven by contacts
+void SolveContacts(ContactCache& cache, ContactSolverParams& params);
+
+#endif //SYSTEM_PHYSICS_SOLVER_H
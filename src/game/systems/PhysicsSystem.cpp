@@ -11,10 +11,10 @@
 #include "../../core/time.h"
 #include "../../core/window.h"
 #include "../../math/Math.h"
-#include "../../geometry/Geometry.h"
+#include "../../geometry/SpatialHash2.h"
 #include "../../utils/Command.h"
 
-u32 collCount;
+#include <algorithm>
 
 bool breakphys = false;
 
@@ -22,702 +22,6 @@ bool breakphys = false;
 //if something happens in 2 different ticks etc
 u32 physTickCounter = 0;
 
-struct PhysicsTuple { 
-	Transform* transform = nullptr; 
-	Physics*   physics   = nullptr; 
-	Collider*  collider  = nullptr;
-	PhysicsTuple(Transform* transform, Physics* physics, Collider* collider) 
-		: transform(transform), physics(physics), collider(collider) {}
-};
-
-/////////////////////
-//// integration ////
-/////////////////////
-
-inline std::vector<PhysicsTuple> GetPhysicsTuples(Admin* admin) {
-	std::vector<PhysicsTuple> out;
-	for(int i = 0; i < admin->entities.size(); i++) {
-		if (admin->entities[i]) {
-			Transform* transform = &admin->entities[i]->transform;
-			Physics* physics = nullptr;
-			Collider* collider = nullptr;
-			
-			for (Component* c : admin->entities[i]->components) {
-				if (Physics* phy = dynamic_cast<Physics*>(c)) { physics = phy; continue; }
-				if (Collider* col = dynamic_cast<Collider*>(c)) { collider = col; continue; }
-			}
-			if (physics) {
-				out.push_back(PhysicsTuple(transform, physics, collider));
-			}
-		}
-	}
-	return out;
-}
-
-//TODO(delle,Ph) look into bettering this physics tick
-//https://gafferongames.com/post/physics_in_3d/
-inline void PhysicsTick(PhysicsTuple& t, PhysicsSystem* ps, Time* time) {
-	//// translation ////
-	
-	//add input forces
-	t.physics->inputVector.normalize();
-	t.physics->AddForce(nullptr, t.physics->inputVector);
-	t.physics->inputVector = Vector3::ZERO;
-	
-	//add gravity 
-	t.physics->acceleration += Vector3(0, -ps->gravity, 0);
-	
-	//add temp air friction force
-	t.physics->AddFrictionForce(nullptr, ps->frictionAir);
-	
-	//contacts is the various contact states it has with each object while
-	//contactState is the overall state of the object, regardless of what object its touching
-	bool contactMoving = false;
-	bool contactStationary = false;
-	for (auto c : t.physics->contacts) {
-		if (c.second == ContactMoving) {
-			if (t.physics->velocity.mag() > 0.01) {
-				
-				for (auto& m : t.physics->manifolds) {
-					Vector3 norm = m.second.norm.normalized();
-					Vector3 vPerpNorm = t.physics->velocity - t.physics->velocity.dot(norm) * norm;
-					//account for friction along ang surfaces
-					Vector3 weight = Vector3::DOWN * t.physics->mass * ps->gravity;
-					float primedweight = weight.dot(norm);
-					t.physics->forces.push_back(-vPerpNorm.normalized() * t.physics->kineticFricCoef * primedweight);
-				}
-				
-				//t.physics->AddFrictionForce(nullptr, t.physics->kineticFricCoef, ps->gravity);
-			}
-			else
-				t.physics->velocity = Vector3::ZERO;
-			contactMoving = true;
-		}
-		else if (c.second == ContactStationary) contactStationary = true;
-	}
-	
-	if      (contactMoving)     t.physics->contactState = ContactMoving;
-	else if (contactStationary) t.physics->contactState = ContactStationary;
-	else                        t.physics->contactState = ContactNONE;
-	
-	//sum up forces to calculate acceleration
-	Vector3 netForce;
-	for (auto& f : t.physics->forces) {
-		netForce += f;
-	}
-	t.physics->acceleration += netForce / t.physics->mass;
-	
-	//update linear movement and clamp it to min/max velocity
-	if (!t.physics->staticPosition) {
-		t.physics->velocity += t.physics->acceleration * time->fixedDeltaTime;
-		float velMag = t.physics->velocity.mag();
-		if (velMag > ps->maxVelocity) {
-			t.physics->velocity /= velMag;
-			t.physics->velocity *= ps->maxVelocity;
-		}
-		else if (velMag < ps->minVelocity) {
-			t.physics->velocity = Vector3::ZERO;
-			t.physics->acceleration = Vector3::ZERO;
-		}
-		t.physics->position += t.physics->velocity * time->fixedDeltaTime;
-	}
-	
-	//// rotation ////
-	
-	//make fake rotational friction
-	if (t.physics->rotVelocity != Vector3::ZERO) {
-		t.physics->rotAcceleration = Vector3(t.physics->rotVelocity.x > 0 ? -1 : 1, t.physics->rotVelocity.y > 0 ? -1 : 1, t.physics->rotVelocity.z > 0 ? -1 : 1) * ps->frictionAir * t.physics->mass * 100;
-	}
-	
-	//update rotational movement and scuffed vector rotational clamping
-	t.physics->rotVelocity += t.physics->rotAcceleration * time->fixedDeltaTime;
-	//if(t.physics->rotVelocity.x > ps->maxRotVelocity) {
-	//	t.physics->rotVelocity.x = ps->maxRotVelocity;
-	//} else if(t.physics->rotVelocity.x < -ps->maxRotVelocity) {
-	//	t.physics->rotVelocity.x = -ps->maxRotVelocity;
-	//} else if(abs(t.physics->rotVelocity.x) < ps->minRotVelocity) {
-	//	t.physics->rotVelocity.x = 0;
-	//	t.physics->rotAcceleration.x = 0;
-	//}
-	//if(t.physics->rotVelocity.y > ps->maxRotVelocity) {
-	//	t.physics->rotVelocity.y = ps->maxRotVelocity;
-	//} else if(t.physics->rotVelocity.y < -ps->maxRotVelocity) {
-	//	t.physics->rotVelocity.y = -ps->maxRotVelocity;
-	//} else if(abs(t.physics->rotVelocity.y) < ps->minRotVelocity) {
-	//	t.physics->rotVelocity.y = 0;
-	//	t.physics->rotAcceleration.y = 0;
-	//}
-	//if(t.physics->rotVelocity.z > ps->maxRotVelocity) {
-	//	t.physics->rotVelocity.z = ps->maxRotVelocity;
-	//} else if(t.physics->rotVelocity.z < -ps->maxRotVelocity) {
-	//	t.physics->rotVelocity.z = -ps->maxRotVelocity;
-	//} else if(abs(t.physics->rotVelocity.z) < ps->minRotVelocity) {
-	//	t.physics->rotVelocity.z = 0;
-	//	t.physics->rotAcceleration.z = 0;
-	//}
-	t.physics->rotation += t.physics->rotVelocity * time->fixedDeltaTime;
-	
-	//reset forces
-	t.physics->forces.clear();
-	
-	//ImGui::DebugDrawText3(t.physics->position.str().c_str(), t.physics->position, ad->mainCamera, DengWindow->dimensions, Color(180, 150, 130));
-	//ImGui::DebugDrawText3(t.physics->velocity.str().c_str(), t.physics->position, ad->mainCamera, DengWindow->dimensions, Color(130, 150, 180), Vector2(0, 20));
-	//ImGui::DebugDrawText3(t.physics->acceleration.str().c_str(), t.physics->position, ad->mainCamera, DengWindow->dimensions, Color(150, 130, 180), Vector2(0, 40));
-	
-	t.physics->acceleration = Vector3::ZERO;
-}
-
-/////////////////////
-//// collisions  ////
-/////////////////////
-
-Matrix4 LocalToWorldInertiaTensor(Physics* physics, Matrix3 inertiaTensor) {
-	Matrix4 inverseTransformation = Matrix4::TransformationMatrix(physics->position, physics->rotation, Vector3::ONE).Inverse();
-	return inverseTransformation.Transpose() * inertiaTensor.To4x4() * inverseTransformation;
-}
-
-bool AABBAABBCollision(Physics* obj1, AABBCollider* obj1Col, Physics* obj2, AABBCollider* obj2Col) {
-	vec3 min1 = obj1->position - (obj1Col->halfDims * obj1->entity->transform.scale);
-	vec3 max1 = obj1->position + (obj1Col->halfDims * obj1->entity->transform.scale);
-	vec3 min2 = obj2->position - (obj2Col->halfDims * obj2->entity->transform.scale);
-	vec3 max2 = obj2->position + (obj2Col->halfDims * obj2->entity->transform.scale);
-	
-	if (//check if overlapping
-		(min1.x <= max2.x && max1.x >= min2.x) &&
-		(min1.y <= max2.y && max1.y >= min2.y) &&
-		(min1.z <= max2.z && max1.z >= min2.z)) {
-		
-		
-		
-		
-		//triggers and no collision
-		if (obj1Col->collided.find(obj2Col) == obj1Col->collided.end()) {
-			if (obj1Col->event != 0 && !obj1Col->sentEvent) { obj1Col->sender->SendEvent(obj1Col->event); obj1Col->sentEvent = true; }
-			if (obj2Col->event != 0 && !obj2Col->sentEvent) { obj2Col->sender->SendEvent(obj2Col->event); obj2Col->sentEvent = true; }
-		}
-		
-		obj1Col->collided.clear();
-		obj2Col->collided.clear();
-		
-		//store entity
-		obj1Col->collided.insert(obj2Col);
-		obj2Col->collided.insert(obj1Col);
-		
-		if(obj1Col->noCollide || obj2Col->noCollide) return false;
-		
-		float xover, yover, zover;
-		
-		//we need to know which box is in front over each axis so
-		//the overlap is correct
-		if (max1.x < max2.x) xover = max1.x - min2.x;
-		else                 xover = max2.x - min1.x;
-		if (max1.y < max2.y) yover = max1.y - min2.y;
-		else                 yover = max2.y - min1.y;
-		if (max1.z < max2.z) zover = max1.z - min2.z;
-		else                 zover = max2.z - min1.z;
-		
-		Manifold3 m1;
-		Manifold3 m2;
-		
-		//static resolution
-		Vector3 norm;
-		if (xover < yover && xover < zover) {
-			if(!obj1->staticPosition) obj1->position.x += xover / 2;
-			if(!obj2->staticPosition) obj2->position.x -= xover / 2;
-			norm = Vector3::LEFT;
-		}	
-		else if (yover < xover && yover < zover) {
-			if(!obj1->staticPosition) obj1->position.y += yover / 2;
-			if(!obj2->staticPosition) obj2->position.y -= yover / 2;
-			norm = Vector3::DOWN;
-		}
-		else if (zover < yover && zover < xover) {
-			if(!obj1->staticPosition) obj1->position.z += zover / 2;
-			if(!obj2->staticPosition) obj2->position.z -= zover / 2;
-			norm = Vector3::BACK;
-		}
-		
-		m1.norm = norm;
-		m2.norm = norm;
-		
-		
-		//dynamic resolution
-		Vector3 rv = obj2->velocity - obj1->velocity;
-		
-		//PRINTLN(TOSTRING(rv));
-		
-		float vAlongNorm = rv.dot(norm);
-		if (vAlongNorm < 0) {
-			//TODO(sushi, Ph) do better elasticity later
-			float j = -(1 + (obj1->elasticity + obj2->elasticity) / 2) * vAlongNorm;
-			j /= 1 / obj1->mass + 1 / obj2->mass;
-			
-			Vector3 impulse = j * norm;
-			if (!obj1->staticPosition) obj1->velocity -= impulse / obj1->mass;
-			if (!obj2->staticPosition) obj2->velocity += impulse / obj2->mass;
-			//PRINTLN(obj2->velocity.mag());
-			
-			
-			//setting contact state depending on movement
-			if (fabs(obj1->velocity.normalized().dot(norm)) != 1) {
-				if (!obj1->staticPosition) {
-					obj1->contacts[obj2] = ContactMoving;
-				}
-				else obj1->contacts[obj2] = ContactStationary;
-			}
-			else {
-				obj1->contacts[obj2] = ContactStationary;
-			}
-			if (fabs(obj2->velocity.normalized().dot(norm)) != 1) {
-				if (!obj2->staticPosition) 
-					obj2->contacts[obj1] = ContactMoving;
-				else obj2->contacts[obj1] = ContactStationary;
-			}
-			else {
-				obj2->contacts[obj1] = ContactStationary;
-			}
-		}
-		
-		//all of this probably isnt nececssary but i'm trying to get it to wo rkr kr k r
-		//the player checking is so i can point the normal in the proper direction when trying 
-		//to figure out if the player is on the floor or a wall/ceiling
-		//TODO(sushi, PhCl) clean this up
-		if (g_admin->player == obj1->entity) {
-			Vector3 pto = obj2->position - obj1->position;
-			if (pto.normalized().dot(norm) > 0) { m1.player = 1; m2.player = 0; }
-			else                                { m1.player = 0; m2.player = 1; }
-			
-			obj1->manifolds[obj2] = m1;
-			obj2->manifolds[obj1] = m2;
-		}
-		else if (g_admin->player == obj2->entity) {
-			Vector3 pto = obj2->position - obj1->position;
-			if (pto.normalized().dot(norm) > 0) { m1.player = 1; m2.player = 0; }
-			else                                { m1.player = 0; m2.player = 1; }
-			
-			obj1->manifolds[obj2] = m2;
-			obj2->manifolds[obj1] = m1;
-		}
-		else {
-			obj1->manifolds[obj2] = m2;
-			obj2->manifolds[obj1] = m1;
-		}
-		
-		return true;
-	}	
-	obj1->contacts[obj2] = ContactNONE;
-	obj2->contacts[obj1] = ContactNONE;
-	return false;
-}
-
-inline void AABBSphereCollision(Physics* aabb, AABBCollider* aabbCol, Physics* sphere, SphereCollider* sphereCol) {
-	Vector3 aabbPoint = Geometry::ClosestPointOnAABB(aabb->position, (aabbCol->halfDims * EntityAt(aabb->entityID)->transform.scale), sphere->position);
-	Vector3 vectorBetween = aabbPoint - sphere->position; //sphere towards aabb
-	float distanceBetween = vectorBetween.mag();
-	if(distanceBetween < sphereCol->radius) {
-		//triggers and no collision
-		if (aabbCol->event != 0)   aabbCol->sender->SendEvent(aabbCol->event);
-		if (sphereCol->event != 0) sphereCol->sender->SendEvent(sphereCol->event);
-		if (aabbCol->noCollide || sphereCol->noCollide) return;
-		
-		//aabb->entity->GetComponent<AudioSource>()->request_play = true;
-		//static resolution
-		if (aabbPoint == sphere->position) { 
-			//NOTE if the closest point is the same, the vector between will have no direction; this 
-			//is supposed to be a remedy to that by offsetting in the direction between thier centers
-			vectorBetween = aabb->position - sphere->position;
-		}
-		float overlap = .5f * (sphereCol->radius - distanceBetween);
-		Vector3 normal = -vectorBetween.normalized();
-		vectorBetween = -normal * overlap;
-		if(aabb->staticPosition){
-			sphere->position -= vectorBetween;
-		}else if(sphere->staticPosition){
-			aabb->position += vectorBetween;
-		}else{
-			aabb->position += vectorBetween / 2.f;
-			sphere->position -= vectorBetween / 2.f;
-		}
-		
-		//dynamic resolution
-		Matrix4 sphereInertiaTensorInverse = LocalToWorldInertiaTensor(sphere, sphereCol->inertiaTensor).Inverse();
-		Vector3 ra = sphere->position + Geometry::ClosestPointOnSphere(sphere->position, sphereCol->radius, aabbPoint);
-		Vector3 sphereAngularVelocityChange = normal.cross(ra);
-		sphereAngularVelocityChange *= sphereInertiaTensorInverse;
-		float inverseMassA = 1.f / sphere->mass;
-		float scalar = inverseMassA + sphereAngularVelocityChange.cross(ra).dot(normal);
-		
-		Matrix4 aabbInertiaTensorInverse = LocalToWorldInertiaTensor(aabb, aabbCol->inertiaTensor).Inverse();
-		Vector3 rb = aabb->position + aabbPoint;
-		Vector3 aabbAngularVelocityChange = normal.cross(rb);
-		aabbAngularVelocityChange *= aabbInertiaTensorInverse;
-		float inverseMassB = 1.f / aabb->mass; 
-		scalar += inverseMassB + aabbAngularVelocityChange.cross(rb).dot(normal);
-		
-		float coefRest = (aabb->elasticity + sphere->elasticity) / 2; 
-		float impulseMod = (coefRest + 1) * (sphere->velocity - aabb->velocity).mag(); //this too :)
-		Vector3 impulse = normal * impulseMod;
-		aabb->AddImpulse(sphere, -impulse);
-		//sphere->rotVelocity -= sphereAngularVelocityChange;
-		//aabb->entity->rotVelocity -= aabbAngularVelocityChange; //we dont do this because AABB shouldnt rotate
-	}
-}
-
-inline void AABBBoxCollision(Physics* aabb, AABBCollider* aabbCol, Physics* box, BoxCollider* boxCol) {
-	ERROR("AABB-Box collision not implemented in PhysicsSystem.cpp");
-}
-
-inline bool SphereSphereCollision(Physics* s1, SphereCollider* sc1, Physics* s2, SphereCollider* sc2) {
-	//static resolution
-	float dist = (s1->position - s2->position).mag();
-	float rsum = sc1->radius + sc2->radius;
-	if (rsum > dist) {
-		//triggers and no collision
-		if(sc1->event != Event_NONE) sc1->sender->SendEvent(sc1->event);
-		if(sc2->event != Event_NONE) sc2->sender->SendEvent(sc2->event);
-		if(sc1->noCollide || sc2->noCollide) return false;
-		
-		Vector3 s1t2 = s2->position - s1->position;
-		float overlap = (rsum - dist) / 2;
-		if (!s1->staticPosition) s1->position -= s1t2.normalized() * overlap;
-		if (!s2->staticPosition) s2->position += s1t2.normalized() * overlap;
-		
-		//dynamic resolution
-		//from https://www.gamasutra.com/view/feature./131424/pool_hall_lessons_fast_accurate_.php?print=1
-		Vector3 n = s1->position - s2->position;
-		n.normalize();
-		
-		float a1 = s1->velocity.dot(n);
-		float a2 = s2->velocity.dot(n);
-		
-		float opP = (2 * (a1 - a2)) / (s1->mass + s2->mass);
-		
-		s1->velocity = s1->velocity - opP * s2->mass * n;
-		s2->velocity = s2->velocity + opP * s1->mass * n;
-		return true;
-	}
-	return false;
-}
-
-inline void SphereLandscapeCollision(Physics* s, SphereCollider* sc, Physics* ls, SphereCollider* lsc) {
-	
-}
-
-inline void SphereBoxCollision(Physics* sphere, SphereCollider* sphereCol, Physics* box, BoxCollider* boxCol) {
-	ERROR("Sphere-Box collision not implemented in PhysicsSystem.cpp");
-}
-
-inline void BoxBoxCollision(Physics* box, BoxCollider* boxCol, Physics* other, BoxCollider* otherCol) {
-	ERROR("Box-Box collision not implemented in PhysicsSystem.cpp");
-}
-
-//TODO(sushi, Cl) move this to some utilities file eventually 
-template<class T>
-bool is_in(T test, std::vector<T> vec) {
-	for (T t : vec) if (test == t) return true;
-	return false;
-}
-
-//TODO(sushi, Op) store face information eventually, these two functions could get really bad in some cases
-//				  doing that will also prevent us from checking a face several times if multiple triangles make it up
-//returns a faces neighbors as well as the triangles that make up the face
-inline pair<std::vector<Triangle*>, std::vector<Triangle*>>
-findFaceNbrs(Triangle* base) {
-	std::vector<Triangle*> face{ base };
-	std::vector<Triangle*> ret;
-	//pair<std::vector<Triangle*>, std::vector<Triangle*>> p(face, ret)
-	for (int i = 0; i < face.size(); i++) {
-		for (Triangle* t : face[i]->nbrs) {
-			if (!is_in(t, face)) {
-				if (t->norm == base->norm) {
-					face.push_back(t);
-				}
-				else {
-					ret.push_back(t);
-				}
-			}
-		}
-	}
-	return pair<std::vector<Triangle*>, std::vector<Triangle*>>(ret, face);
-}
-
-//returns a vector of all triangles that make up a face
-//TODO(sushi, Cl) merge this function with the above or the other way around
-inline std::vector<Triangle*> findFace(Triangle* base) {
-	std::vector<Triangle*> face{ base };
-	for (int i = 0; i < face.size(); i++) {
-		for (Triangle* t : face[i]->nbrs) {
-			if (!is_in(t, face)) {
-				if (t->norm == base->norm) {
-					face.push_back(t);
-				}
-			}
-		}
-	}
-	return face;
-}
-
-
-//This is currently done by SAT
-inline bool ComplexComplexCollision(Physics* obj1, ComplexCollider* obj1Col, Physics* obj2, ComplexCollider* obj2Col) {
-	//LOG("tick ", physTickCounter, " with ", obj1->entity->id, " against ", obj2->entity->id, " ---------------------------------------------------------");
-	
-	Physics* o1 = obj1; Physics* o2 = obj2;
-	ComplexCollider* o1c = obj1Col; ComplexCollider* o2c = obj2Col;
-	Physics* refphys = nullptr;
-	Physics* incphys = nullptr;
-	ComplexCollider* refcol = nullptr;
-	ComplexCollider* inccol = nullptr;
-	
-	
-	
-	float minpen = -INFINITY;
-	Vector3 bestnorm;
-	
-	auto dist = [](vec3 p, vec3 plane_n, vec3 plane_p) {
-		//return (plane_n.x * p.x + plane_n.y * p.y + plane_n.z * p.z - plane_n.dot(plane_p));
-		return (p - plane_p).dot(plane_n);
-	};
-	
-	vec3 p0, p1, p2, normal, normal2, intersect;
-	f32  t;
-	int  index = 0;
-	bool done = false;
-	
-	float saved = 0;
-	float saved2 = 0;
-	
-	for (int shape = 0; shape < 2; shape++) {
-		if (shape == 1) { 
-			o1c = obj2Col; o2c = obj1Col; 
-			o1 = obj2; o2 = obj1;
-		}
-		
-		mat4 o1transform = Matrix4::TransformationMatrix(o1->position, o1->rotation, o1->entity->transform.scale);//o1->entity->transform.TransformMatrix();
-		mat4 o2transform = Matrix4::TransformationMatrix(o2->position, o2->rotation, o2->entity->transform.scale);//o2->entity->transform.TransformMatrix();
-		
-		mat4 o1rotation = Matrix4::RotationMatrix(o1->rotation);
-		mat4 o2rotation = Matrix4::RotationMatrix(o2->rotation);
-		
-		//PRINTLN("o1 rot: " << o1->rotation.str());
-		//PRINTLN("o2 rot: " << o2->rotation.str());
-		
-		Face* lastface = 0;
-		for (Face* f : o1c->mesh->faces) {
-			p0 = f->points[0] * o1transform;
-			normal = f->norm * o1rotation;
-			float deepest = INFINITY;
-			for (Face* f2 : o2c->mesh->faces) {
-				for (int i = 0; i < f2->points.size(); i++) {
-					Vector3 v = f2->points[i] * o2transform;
-					p1 = v;
-					float vertdepth = Math::DistPointToPlane(v, normal, p0);
-					//ImGui::DebugDrawLine3(v, v - normal * vertdepth, Color(0, 255.0 * (i / (float)f2->points.size()), 0));
-					if (vertdepth < deepest) {
-						deepest = vertdepth;
-					}
-					lastface = f2;
-				}
-				if (deepest > 0) {
-					for (int i = 0; i < lastface->points.size(); i += 2) {
-						ImGui::DebugDrawLine3(lastface->points[i] * o2transform, lastface->points[i + 1] * o2transform, Color::MAGENTA);
-					}
-					ImGui::DebugDrawLine3(p1, p1 - normal * deepest, Color::BLACK);
-					ERROR("func failed with deepest ", deepest);
-					return false;
-				}
-				else if (deepest > minpen) {
-					minpen = deepest;
-					bestnorm = normal;
-					refphys = o1;
-					incphys = o2;
-					refcol = o1c;
-					inccol = o2c;
-				}
-			}
-			
-		}
-		
-		
-		//for (Batch& b : o1c->mesh->batchArray) {
-		//	for (u32 i = 0; i < b.indexArray.size(); i += 3) {
-		//		p0 = b.vertexArray[b.indexArray[i]].pos * o1transform;
-		//		normal = b.vertexArray[b.indexArray[i]].normal * o1rotation;
-		//		//ImGui::DebugDrawLine3(p0, p0 + normal, Color(20, 50, 155));
-		//		//LOG("eid: ", o1->entityID, " shape: ", shape, normal);
-		//		float deepest = INFINITY;
-		//		for (Batch& b2 : o2c->mesh->batchArray) {
-		//			//this would maybe work better using just the indexarray, not sure yet tho
-		//			for (u32 j = 0; j < b2.vertexArray.size(); j++) {
-		//				Vector3 vert = b2.vertexArray[j].pos * o2transform;
-		//				normal2 = b2.vertexArray[j].normal * o2rotation;
-		//				float vertdepth = Math::DistPointToPlane(vert, normal, p0);
-		//				ImGui::DebugDrawLine3(vert, vert - normal * vertdepth, Color(0, 255, 0));
-		//				//ImGui::DebugDrawText3(TOSTRING(vertdepth).c_str(), p0 + normal2 * vertdepth, Color::BLACK);
-		//				if (vertdepth < deepest) deepest = vertdepth;
-		//			}
-		//		}
-		//		//LOG(deepest);
-		//		if (deepest > 0) {
-		//			//ImGui::DebugDrawLine3(p0, p0 + normal * saved, Color::GREEN);
-		//			//ERROR("func failed with deepest ", deepest);
-		//			return false;
-		//		}
-		//		else if (deepest > minpen) {
-		//			minpen = deepest;
-		//			bestnorm = normal;
-		//			refphys = o1;
-		//			incphys = o2;
-		//			refcol = o1c;
-		//			inccol = o2c;
-		//		}
-		//	}
-		//}
-	}
-	
-	//SUCCESS("func succeded with minpen ", minpen);
-	
-	//ImGui::DebugDrawLine3(save, save + minpen * saven, Color::BLACK);
-	////ImGui::DebugDrawLine3(save2, save2 + saved2 * saven2, Color::DARK_YELLOW);
-	//ImGui::DebugDrawCircle3(save2 + minpen * bestnorm, 5, Color::MAGENTA);
-	//ImGui::DebugDrawLine3(save + minpen * saven, save2);
-	//
-	//ImGui::DebugDrawLine3(obj1->position, obj2->position, Color::RED);
-	
-	
-	//////////////////
-	//// Clipping ////
-	//////////////////
-	
-	
-	//float furthest = -INFINITY;
-	//Triangle* best;
-	//for (Triangle* t : refcol->mesh->triangles) {
-	//	u32 furthestid = 0;
-	//	for (int i = 0; i < t->p.size(); i++) {
-	//		float dist = bestnorm.dot(t->p[i]);
-	//		if (dist > furthest) {
-	//			furthest = dist;
-	//			best = t;
-	//		}
-	//	}
-	//}
-	
-	
-	
-	
-	
-	//find triangle that's most aligned with normal
-	u32 furthestTriRef = Geometry::FurthestTriangleAlongNormal(refcol->mesh, Matrix4::RotationMatrix(refphys->rotation), bestnorm);
-	u32 furthestTriInc = Geometry::FurthestTriangleAlongNormal(inccol->mesh, Matrix4::RotationMatrix(incphys->rotation), -bestnorm);
-	
-	
-	Triangle* triRef = refcol->mesh->triangles[furthestTriRef];
-	Triangle* triInc = inccol->mesh->triangles[furthestTriInc];
-	
-	//ImGui::DebugDrawTriangle3(triRef->midpoint(), triRef->midpoint() + bestnorm, Color::YELLOW);
-	
-	
-	Matrix4 refTransform = Matrix4::TransformationMatrix(refphys->position, refphys->rotation, refphys->entity->transform.scale);
-	Matrix4 incTransform = Matrix4::TransformationMatrix(incphys->position, incphys->rotation, incphys->entity->transform.scale);
-	ImGui::DebugDrawLine3(triRef->midpoint() * refTransform, triRef->midpoint() * refTransform + bestnorm, Color::YELLOW);
-	
-	Matrix4 refRotation = Matrix4::RotationMatrix(refphys->rotation);
-	Matrix4 incRotation = Matrix4::RotationMatrix(incphys->rotation);
-	ImGui::DebugDrawLine3(triInc->midpoint() * incTransform, triInc->midpoint() * incTransform + triInc->norm * incRotation,  Color::VERY_DARK_YELLOW);
-	
-	std::vector<Vector3> colPoints;
-	//we need to find all nbrs to the face, not just the triangle
-	pair<std::vector<Triangle*>, std::vector<Triangle*>>
-		nbrs2check = findFaceNbrs(triRef); 
-	
-	std::vector<Triangle*> incFace = findFace(triInc);
-	
-	//for (Triangle* t : triInc->face->tris) {
-	//	ImGui::DebugDrawTriangle3(
-	//		t->p[0] * incphys->entity->transform.TransformMatrix(),
-	//		t->p[1] * incphys->entity->transform.TransformMatrix(),
-	//		t->p[2] * incphys->entity->transform.TransformMatrix(), Color::MAGENTA);
-	//}
-	
-	for (int i = 0; i < triInc->face->points.size(); i += 2) {
-		ImGui::DebugDrawLine3(triInc->face->points[i] * incTransform, triInc->face->points[i + 1] * incTransform, Color::MAGENTA);
-	}
-	
-	//for (Triangle* t : nbrs2check.first) {
-	//	ImGui::DebugDrawTriangle3(
-	//		t->p[0] * refphys->entity->transform.TransformMatrix(),
-	//		t->p[1] * refphys->entity->transform.TransformMatrix(),
-	//		t->p[2] * refphys->entity->transform.TransformMatrix(), Color::MAGENTA);
-	//}
-	//
-	for (Triangle* t : nbrs2check.second) {
-		ImGui::DebugDrawTriangle3(
-								  t->p[0] * refphys->entity->transform.TransformMatrix(),
-								  t->p[1] * refphys->entity->transform.TransformMatrix(),
-								  t->p[2] * refphys->entity->transform.TransformMatrix(), Color::GREEN);
-	}
-	
-	//clip inc face's points against ref's adjacent faces
-	for (Triangle* t : nbrs2check.first) {
-		Vector3 refP = t->p[0] * refTransform;
-		for (Triangle* tInc : incFace) {
-			for (int i = 0; i < 3; i++) {
-				Vector3 incP = tInc->p[i] * incTransform;
-				Vector3 incPLast = tInc->p[(i + 2) % 3] * incTransform;
-				
-				float dCurr = -Math::DistPointToPlane(incP, t->norm * refRotation, refP);
-				float dLast = -Math::DistPointToPlane(incPLast, t->norm * refRotation, refP);
-				
-				if (dCurr < 0 && dLast > 0) {
-					//ImGui::DebugDrawText3(TOSTRING(dCurr).c_str(), incP);
-					//ImGui::DebugDrawLine3(incP, incP + t->norm * dCurr, Color::GREEN);
-					//ImGui::DebugDrawText3(TOSTRING(dLast).c_str(), incPLast);
-					//ImGui::DebugDrawLine3(incPLast, incPLast + t->norm * dLast, Color::RED);
-					Vector3 inter = Math::VectorPlaneIntersect(refP, t->norm * refRotation, incPLast, incP);
-					
-					colPoints.push_back(inter);
-					
-				}
-				else {
-					//colPoints.push_back(t->p[i]);
-				}
-			}
-		}
-	}
-	
-	for (auto& v : colPoints) {
-		ImGui::DebugDrawCircle3(v, 5, Color(255, 255, 0));
-		float distance = Math::DistPointToPlane(v, triRef->norm * refRotation, triRef->p[0] * refTransform);
-		
-		
-		
-		if (distance < 0) {
-			
-			ImGui::DebugDrawCircleFilled3(o1->position - bestnorm * distance / 2, 5, Color(0, 0, 255));
-			//ImGui::DebugDrawText3(TOSTRING(physTickCounter).c_str(), o1->position - bestnorm * distance / 2, Color::BLACK);
-			ImGui::DebugDrawCircleFilled3(o2->position + bestnorm * distance / 2, 5, Color(255, 0, 0));
-			//ImGui::DebugDrawText3(TOSTRING(physTickCounter).c_str(), o2->position + bestnorm * distance / 2, Color::BLACK);
-			ImGui::DebugDrawCircleFilled3(o2->position, 5, Color::GREEN);
-			ImGui::DebugDrawCircleFilled3(o1->position, 5, Color::GREEN);
-			ImGui::DebugDrawText3(TOSTRING(distance).c_str(), v, Color::BLACK);
-			
-			//PRINTLN(physTickCounter << " ------------------------------------------ " << distance);
-			//PRINTLN(o1 << " before: " << TOSTRING(o1->position));
-			//o1->position -= bestnorm * distance / 2;
-			//PRINTLN(o1 << " change: " << TOSTRING(bestnorm * distance / 2));
-			//PRINTLN(o1 << " after:  " << TOSTRING(o1->position));
-			//PRINTLN(o2 << " before: " << TOSTRING(o2->position));
-			//PRINTLN(o2 << " change: " << TOSTRING(-bestnorm * distance / 2));
-			//o2->position += bestnorm * distance / 2;
-			//PRINTLN(o2 << " after:  " << TOSTRING(o2->position));
-			
-		}
-	}
-	return true;
-}
-
-
 ////////////////////
 //
 //
@@ -764,7 +68,7 @@ int GetFaceID(poly* p, Vector2 n) {
 }
 
 void ClipSide(Vector2* colpoints, poly* p, int faceID) {
-	
+
 	int outside = 0;
 	int inside = 0;
 	
@@ -827,7 +131,7 @@ void Clip(Manifold2& m) {
 	}
 	
 	m.refID = refID;
-	
+
 }
 
 bool ShapeOverlapSAT(poly& r1, poly& r2, Manifold2& m) {
@@ -846,7 +150,7 @@ bool ShapeOverlapSAT(poly& r1, poly& r2, Manifold2& m) {
 		if (shape == 1) { p1 = &r2; p2 = &r1; }
 		
 		for (int i = 0; i < p1->p.size(); i += 2) {
-			
+		
 			Vector2 fp1 = p1->p[i];
 			//DrawString(Vector2(fp1.x, fp1.y - 20), std::to_string(i), olc::CYAN);
 			Vector2 fp2 = p1->p[i + 1];
@@ -858,7 +162,7 @@ bool ShapeOverlapSAT(poly& r1, poly& r2, Manifold2& m) {
 			Vector2 vertp;
 			
 			for (int j = 0; j < p2->p.size(); j++) {
-				
+			
 				Vector2 vert = p2->p[j];
 				vertp = vert;
 				float vertdepth = (fp1 - vert).dot(norm);
@@ -891,30 +195,35 @@ bool ShapeOverlapSAT(poly& r1, poly& r2, Manifold2& m) {
 	return true;
 }
 
-void FillManis(std::vector<poly>& polys, std::vector<Manifold2>& manis) {
+//SAT over the pairs of polys whose bounds overlap in the grid and that pass filter(m, n)
+template<class F>
+void FillManis(std::vector<poly>& polys, u32 count, SpatialHash2& grid, std::vector<Manifold2>& manis, F filter) {
 	manis.clear();
-	for (int m = 0; m < polys.size(); m++) {
-		for (int n = m + 1; n < polys.size(); n++) {
-			Manifold2 ma;
-			if (ShapeOverlapSAT(polys[m], polys[n], ma)) {
-				//PRINTLN("TRUE------------------------");
-			}
-			else {
-				//PRINTLN("FALSE------------------------");
-			}
-			//polys[m].overlap |= 
-			manis.push_back(ma);
+	grid.Clear();
+	for (u32 i = 0; i < count; ++i) {
+		poly& p = polys[i];
+		Vector2 min = p.pos, max = p.pos;
+		for (Vector2& v : p.p) {
+			min = Vector2(Min(min.x, v.x), Min(min.y, v.y));
+			max = Vector2(Max(max.x, v.x), Max(max.y, v.y));
 		}
+		grid.Add(min, max);
 	}
+	grid.Build();
+	grid.ForEachPair([&](u32 m, u32 n) {
+		if (!filter(m, n)) return;
+		Manifold2 ma;
+		if (ShapeOverlapSAT(polys[m], polys[n], ma)) manis.push_back(ma);
+	});
 }
 
-void SolveManifolds(std::vector<Manifold2> manis) {
+void SolveManifolds(std::vector<Manifold2>& manis) {
 	for (Manifold2& m : manis) {
 		poly* p1 = m.a;
 		poly* p2 = m.b;
 		
 		if (p1 && p2) {
-			
+		
 			//if (!p1->staticPosition && m.depth[0] < 0) p1->pos -= m.norm * m.depth[0] / 2;
 			//if (!p1->staticPosition && m.depth[1] < 0) p1->pos -= m.norm * m.depth[1] / 2;
 			//
@@ -946,14 +255,14 @@ void SolveManifolds(std::vector<Manifold2> manis) {
 				
 				Vector2 impulse = j * m.norm;
 				if (!p1->staticPosition) {
-					
+				
 					Vector3 impworld = Math::ScreenToWorld(p1->pos + p1->vel + impulse, DengCamera->projMat, DengCamera->viewMat, DengWindow->dimensions);
 					Vector3 impworldpr = Math::VectorPlaneIntersect(p1->ogphys->position, DengCamera->position - p1->ogphys->position, DengCamera->position, impworld);
 					
 					p1->ogphys->velocity -= (impworldpr - p1->ogphys->position);
 				}
 				if (!p2->staticPosition) {
-					
+				
 					Vector3 impworld = Math::ScreenToWorld(p2->pos + p2->vel + impulse, DengCamera->projMat, DengCamera->viewMat, DengWindow->dimensions);
 					Vector3 impworldpr = Math::VectorPlaneIntersect(p2->ogphys->position, DengCamera->position - p2->ogphys->position, DengCamera->position, impworld);
 					
@@ -964,13 +273,19 @@ void SolveManifolds(std::vector<Manifold2> manis) {
 	}
 }
 
-poly GeneratePoly(Physics* p) {
-	poly poly;
-	poly.o =
-		EntityAt(p->entityID)->GetComponent<MeshComp>()->mesh->
-		GenerateOutlinePoints(Matrix4::TransformationMatrix(p->position, p->rotation, EntityAt(p->entityID)->transform.scale),
-							  DengCamera->projMat, DengCamera->viewMat, DengWindow->dimensions, g_admin->mainCamera->position);
+//fills a pooled poly in place so the outline vectors keep their memory between steps
+//the outline comes from the mesh's silhouette cache, so only projecting it is paid for while the view is steady
+void GeneratePoly(Physics* p, poly& poly) {
+	p->entity->GetComponent<MeshComp>()->mesh->
+		GenerateOutlinePoints(Matrix4::TransformationMatrix(p->position, p->rotation, p->entity->transform.scale),
+							  DengCamera->projMat, DengCamera->viewMat, DengWindow->dimensions, g_admin->mainCamera->position, poly.o);
 	poly.p = poly.o;
+	poly.acc     = Vector2::ZERO;
+	poly.rotvel  = 0;
+	poly.rotacc  = 0;
+	poly.angle   = 0;
+	poly.moi     = 1;
+	poly.overlap = false;
 	
 	poly.pos = Math::WorldToScreen2(p->position, DengCamera->projMat, DengCamera->viewMat, DengWindow->dimensions);
 	
@@ -990,87 +305,72 @@ poly GeneratePoly(Physics* p) {
 	poly.staticPosition = p->staticPosition;
 	
 	poly.ogphys = p;
-	
-	return poly;
-	
+
 }
 
-//NOTE make sure you are using the right physics component, because the collision 
-//functions dont check that the provided one matches the tuple
-inline void CheckCollision(PhysicsTuple& tuple, PhysicsTuple& other, std::vector<poly>& polys) {
-	auto genpolys = [&]() {
-		if (!tuple.physics->twoDpolygon) {
-			tuple.physics->twoDpolygon = new poly(GeneratePoly(tuple.physics));
-			polys.push_back(*tuple.physics->twoDpolygon);
-		}
-		if (!other.physics->twoDpolygon) {
-			other.physics->twoDpolygon = new poly(GeneratePoly(other.physics));
-			polys.push_back(*other.physics->twoDpolygon);
-		}
-	};
-	
-	switch(tuple.collider->type){
-		case(ColliderType_Box):
-		switch(other.collider->type){
-			case(ColliderType_Box):   { BoxBoxCollision   (tuple.physics, (BoxCollider*)   tuple.collider, 
-														   other.physics, (BoxCollider*)   other.collider); }break;
-			case(ColliderType_Sphere):{ SphereBoxCollision(other.physics, (SphereCollider*)other.collider, 
-														   tuple.physics, (BoxCollider*)   tuple.collider); }break;
-			case(ColliderType_AABB):  { AABBBoxCollision  (other.physics, (AABBCollider*)  other.collider, 
-														   tuple.physics, (BoxCollider*)   tuple.collider); }break;
-		}break;
-		case(ColliderType_Sphere):
-		switch(other.collider->type){
-			case(ColliderType_Box):   { SphereBoxCollision   (tuple.physics, (SphereCollider*)tuple.collider, 
-															  other.physics, (BoxCollider*)   other.collider); }break;
-			case(ColliderType_Sphere):{ 
-				if (!SphereSphereCollision(tuple.physics, (SphereCollider*)tuple.collider,
-										   other.physics, (SphereCollider*)other.collider)) {
-					if (tuple.physics->twoDphys && other.physics->twoDphys) genpolys();
-				}
-				
-			}break;
-			case(ColliderType_AABB):  { AABBSphereCollision  (other.physics, (AABBCollider*)  other.collider, 
-															  tuple.physics, (SphereCollider*)tuple.collider); }break;
-		}break;
-		case(ColliderType_AABB):
-		switch(other.collider->type){
-			case(ColliderType_Box):   { AABBBoxCollision   (tuple.physics, (AABBCollider*)  tuple.collider, 
-															other.physics, (BoxCollider*)   other.collider); }break;
-			case(ColliderType_Sphere):{ AABBSphereCollision(tuple.physics, (AABBCollider*)  tuple.collider, 
-															other.physics, (SphereCollider*)other.collider); }break;
-			case(ColliderType_AABB):  { 
-				if (!AABBAABBCollision(tuple.physics, (AABBCollider*)tuple.collider,
-									   other.physics, (AABBCollider*)other.collider)) {
-					if (tuple.physics->twoDphys && other.physics->twoDphys) genpolys();
-				}
-				
-			}break;
-		}break;
-		case ColliderType_Complex:
-		switch (other.collider->type) {
-			case(ColliderType_Complex): {
-				ComplexComplexCollision(tuple.physics, (ComplexCollider*)tuple.collider, other.physics, (ComplexCollider*)other.collider);
-			}
-		}
+//2D collisions happen in screen space so they cant use the world broadphase, they get their own grid instead
+//it runs after each world step since it needs the main camera and the window
+inline void TwoDCollisions(PhysicsSystem* ps){
+	std::vector<PhysicsTuple>& tuples = ps->tuples;
+	std::vector<AABB>& bounds = ps->bounds;
+	//the vectors are kept across steps so they dont get reallocated, polys is a pool whose slots are refilled
+	//each step and Physics::twoDpolygon points at the body's slot until the next one
+	persist std::vector<Manifold2> manis;
+	persist std::vector<poly> polys;
+	persist std::vector<u32> polyTuples; //tuple index of each poly
+	persist SpatialHash2 grid;
+	polyTuples.clear();
+	for(u32 i = 0; i < tuples.size(); ++i){
+		PhysicsTuple& t = tuples[i];
+		t.physics->twoDpolygon = 0;
+		if(!t.collider || !t.physics->twoDphys) continue;
+		if(t.collider->type != ColliderType_Sphere && t.collider->type != ColliderType_AABB) continue;
+		if(polyTuples.size() == polys.size()) polys.push_back(poly());
+		GeneratePoly(t.physics, polys[polyTuples.size()]);
+		polyTuples.push_back(i);
 	}
+	forI(polyTuples.size()) tuples[polyTuples[i]].physics->twoDpolygon = &polys[i];
+	FillManis(polys, polyTuples.size(), grid, manis, [&](u32 m, u32 n){
+		PhysicsTuple& t  = tuples[polyTuples[m]];
+		PhysicsTuple& t2 = tuples[polyTuples[n]];
+		if(t.collider->type != t2.collider->type) return false;
+		if(t.collider->collisionLayer != t2.collider->collisionLayer ||
+		   (t.physics->staticPosition && t2.physics->staticPosition)) return false;
+		//objects already touching in 3D are handled by the 3D narrowphase
+		return !bounds[polyTuples[m]].Overlaps(bounds[polyTuples[n]]);
+	});
+	SolveManifolds(manis);
 }
 
-inline void CollisionTick(std::vector<PhysicsTuple>& tuples, PhysicsTuple& t){
-	std::vector<Manifold2> manis; //TODO(sushi, Ph) put the manifolds vector somewhere better later
-	std::vector<poly> polys; 
-	if(t.collider) {
-		for(auto& t2 : tuples) {
-			if(&t != &t2 && t2.collider && 
-			   t.collider->collisionLayer == t2.collider->collisionLayer &&
-			   (!t.physics->staticPosition || !t2.physics->staticPosition)) {
-				CheckCollision(t, t2, polys);
-				collCount++;
-			}
-		}
-		FillManis(polys, manis);
-		SolveManifolds(manis);
+//one fixed step of the game's world, run by the main thread's accumulator loop or by the physics thread
+inline void SystemStep(PhysicsSystem* ps){
+	physTickCounter++;
+	if(ps->player){
+		if(Movement* movement = ps->player->GetComponent<Movement>()) movement->Update();
 	}
+	PhysicsStep(ps);
+	TwoDCollisions(ps);
+	DengTime->fixedTotalTime += ps->deltaTime;
+}
+
+//seconds on a steady clock, the physics thread schedules its steps and stamps its snapshots with this
+inline f64 PhysicsClock(){
+	return std::chrono::duration<f64>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+//copies the tuples over the older snapshot and makes it the latest, only done while holding worldLock
+inline void PublishSnapshot(PhysicsSystem* ps, std::vector<PhysicsTuple>& tuples, f64 time){
+	u32 next = ps->latestSnapshot ^ 1;
+	PhysicsSnapshot& snapshot = ps->snapshots[next];
+	snapshot.time    = time;
+	snapshot.version = ps->admin->componentsVersion;
+	snapshot.position.resize(tuples.size());
+	snapshot.rotation.resize(tuples.size());
+	forI(tuples.size()){
+		snapshot.position[i] = tuples[i].physics->position;
+		snapshot.rotation[i] = tuples[i].physics->rotation;
+	}
+	ps->latestSnapshot = next;
 }
 
 //////////////////////////
@@ -1079,47 +379,82 @@ inline void CollisionTick(std::vector<PhysicsTuple>& tuples, PhysicsTuple& t){
 
 void PhysicsSystem::Init(Admin* a) {
 	admin = a;
-	integrationMode = IntegrationMode::EULER;
-	collisionMode   = CollisionDetectionMode::DISCRETE;
-	
-	gravity        = 9.81;
-	frictionAir    = 0.01f; 
-	minVelocity    = 0.005f;
-	maxVelocity    = 100.f;
-	minRotVelocity = 1.f;
-	maxRotVelocity = 360.f;
+	PhysicsWorld::Init(DengTime->fixedDeltaTime);
+	tuplesVersion = -1;
+	
+	threaded        = false;
+	maxCatchUpSteps = 30;
+	droppedSteps    = 0;
+	latestSnapshot  = 0;
+	snapshots[0].version = -1;
+	snapshots[1].version = -1;
+}
+
+void PhysicsSystem::SyncBodies() {
+	//the tuples are only rebuilt when the admin's Physics query is, so steady frames dont scan entities
+	ComponentView<Physics>& bodies = admin->Query<Physics>();
+	if(bodies.version != tuplesVersion){
+		tuples.clear();
+		for(auto& row : bodies){
+			tuples.push_back(PhysicsTuple(&row.entity->transform, row.Get<Physics>(), row.entity->GetComponent<Collider>()));
+		}
+		tuplesVersion = bodies.version;
+		syncPending = true;
+	}
+	camera    = admin->mainCamera;
+	player    = admin->player;
+	deltaTime = DengTime->fixedDeltaTime;
 }
 
 void PhysicsSystem::Update() {
-	std::vector<PhysicsTuple> tuples = GetPhysicsTuples(admin);
-	//update physics extra times per frame if frame time delta is larger than physics time delta
-	TIMER_START(physLocalTime);
-	while(DengTime->fixedAccumulator >= DengTime->fixedDeltaTime) {
-		collCount = 0;
-		physTickCounter++;
-		for(auto& t : tuples) {
+	//hand stepping between the main thread and the physics thread when the mode is toggled
+	if(threaded && !threadRunning && !thread.joinable()) StartThread();
+	if(!threaded && threadRunning) threadRunning = false; //it exits the next time it gets worldLock
+	if(thread.joinable() && threadExited) thread.join();
+	
+	SyncBodies();
+	float alpha = 1;
+	PhysicsSnapshot* from = 0;
+	PhysicsSnapshot* to   = 0;
+	if(threadRunning){
+		syncPending = true;
+		DengTime->fixedAccumulator = 0;
+		
+		//render a step behind the physics clock so the render time falls between the last two snapshots
+		PhysicsSnapshot& prev = snapshots[latestSnapshot ^ 1];
+		PhysicsSnapshot& next = snapshots[latestSnapshot];
+		if(prev.version == admin->componentsVersion && next.version == admin->componentsVersion && next.time > prev.time){
+			from  = &prev;
+			to    = &next;
+			alpha = Clamp(f32((PhysicsClock() - DengTime->fixedDeltaTime - prev.time) / (next.time - prev.time)), 0.f, 1.f);
+		}
+	}else{
+		//the editor can move anything between frames, so the broadphase is synced every frame
+		SyncBroadphase(this);
+		WakeEditedBodies(this);
+		syncPending = false;
+		//update physics extra times per frame if frame time delta is larger than physics time delta
+		TIMER_START(physLocalTime);
+		while(DengTime->fixedAccumulator >= DengTime->fixedDeltaTime) {
 			if (TIMER_END(physLocalTime) > 5000 && breakphys) {
 				admin->pause_phys = true;
 				ERROR("Physics system took longer than 5 seconds, pausing.");
 				goto physend;
 			}
-			if (admin->player && admin->player == t.physics->entity) {
-				admin->player->GetComponent<Movement>()->Update();
-			}
-			
-			if(admin->player != t.physics->entity) 
-				PhysicsTick(t, this, DengTime);
-			CollisionTick(tuples, t);
+			SystemStep(this);
+			DengTime->fixedAccumulator -= DengTime->fixedDeltaTime;
 		}
-		DengTime->fixedAccumulator -= DengTime->fixedDeltaTime;
-		DengTime->fixedTotalTime += DengTime->fixedDeltaTime;
-		collisionCount = collCount;
+		physTickCounter = 0;
+		physend:
+		//interpolate between new physics position and old transform position by the leftover time
+		alpha = DengTime->fixedAccumulator / DengTime->fixedDeltaTime;
 	}
-	physTickCounter = 0;
-	physend:
-	//interpolate between new physics position and old transform position by the leftover time
-	float alpha = DengTime->fixedAccumulator / DengTime->fixedDeltaTime;
-	for(auto& t : tuples) {
+	//a frame can run several steps, or none, so their trigger events are handed over together
+	frameTriggerEvents.swap(triggerEvents);
+	triggerEvents.clear();
+	
+	for(u32 i = 0; i < tuples.size(); ++i) {
+		PhysicsTuple& t = tuples[i];
 		//switch (t.physics->contactState) {
 		//	case ContactMoving:
 		//	ImGui::DebugDrawText3("ContactMoving", t.transform->position);
@@ -1132,14 +467,15 @@ void PhysicsSystem::Update() {
 		//	break;
 		//}
 		
-		if (t.physics->twoDpolygon) {
-			delete t.physics->twoDpolygon;
-			t.physics->twoDpolygon = 0;
-		}
 		t.transform->prevPosition = t.transform->position;
 		t.transform->prevRotation = t.transform->rotation;
-		t.transform->position = t.transform->position * (1.f - alpha) + t.physics->position * alpha;
-		t.transform->rotation = t.transform->rotation * (1.f - alpha) + t.physics->rotation * alpha;
+		if(from){
+			t.transform->position = from->position[i] * (1.f - alpha) + to->position[i] * alpha;
+			t.transform->rotation = from->rotation[i] * (1.f - alpha) + to->rotation[i] * alpha;
+		}else{
+			t.transform->position = t.transform->position * (1.f - alpha) + t.physics->position * alpha;
+			t.transform->rotation = t.transform->rotation * (1.f - alpha) + t.physics->rotation * alpha;
+		}
 		if(t.collider) t.collider->sentEvent = false;
 		
 		//t.transform->rotation = Quaternion::QuatSlerp(t.transform->rotation, t.transform->prevRotation, alpha).ToVector3();
@@ -1147,3 +483,54 @@ void PhysicsSystem::Update() {
 		//TODO(delle,Ph) look into better rotational interpolation once we switch to quaternions
 	}
 }
+
+void PhysicsSystem::StartThread() {
+	snapshots[0].version = -1;
+	snapshots[1].version = -1;
+	threadExited  = false;
+	threadRunning = true;
+	thread = std::thread(&PhysicsSystem::ThreadLoop, this);
+}
+
+void PhysicsSystem::StopThread() {
+	threadRunning = false;
+	if(thread.joinable()) thread.join();
+}
+
+void PhysicsSystem::ThreadLoop() {
+	f64 stepTime = PhysicsClock(); //physics clock time the last step ended at
+	while(true){
+		f64 dt = DengTime->fixedDeltaTime;
+		{
+			std::lock_guard<std::mutex> lock(worldLock);
+			if(!threadRunning) break;
+			
+			f64 now = PhysicsClock();
+			if(admin->skip || admin->pause_phys || admin->paused){
+				stepTime = now; //paused time isnt simulated afterwards
+			}else if(now - stepTime >= dt){
+				//a thread that fell far behind drops its backlog instead of spiraling
+				if(now - stepTime > maxCatchUpSteps * dt){
+					droppedSteps += u32((now - stepTime) / dt) - 1;
+					stepTime = now - dt;
+				}
+				stepTime += dt;
+				
+				SyncBodies();
+				if(syncPending || snapshots[latestSnapshot].version != admin->componentsVersion){
+					SyncBroadphase(this);
+					WakeEditedBodies(this);
+					syncPending = false;
+				}
+				SystemStep(this);
+				PublishSnapshot(this, tuples, stepTime);
+				continue; //release the lock between steps so the main thread can get in
+			}
+		}
+		
+		//sleep until the next step is due
+		f64 wait = stepTime + dt - PhysicsClock();
+		if(wait > 0) std::this_thread::sleep_for(std::chrono::duration<f64>(wait));
+	}
+	threadExited = true;
+}
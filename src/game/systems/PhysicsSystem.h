@@ -3,32 +3,63 @@
 #define SYSTEM_PHYSICS_H
 
 #include "../../defines.h"
+#include "SystemScheduler.h"
+#include "PhysicsWorld.h"
 
-struct Admin;
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <vector>
 
-enum struct CollisionDetectionMode {
-	DISCRETE, /*CONTINUOUS, GJK,*/ NONE
-};
+struct Admin;
 
-enum struct IntegrationMode {
-	/*RK4, VERLET,*/ EULER
+//positions and rotations of the tuples after a physics thread step, indexed like the tuples
+struct PhysicsSnapshot{
+	f64 time;    //seconds on the physics clock the step ended at
+	u32 version; //admin components version the tuples were built from
+	std::vector<Vector3> position;
+	std::vector<Vector3> rotation;
 };
 
-struct PhysicsSystem{
+//the game's physics world, its tuples are the admin's entities with a Physics component
+//and it adds the fixed rate stepping, the physics thread, and the 2D screen space pass on top of the world
+struct PhysicsSystem : public PhysicsWorld{
 	Admin* admin;
-	IntegrationMode integrationMode;
-	CollisionDetectionMode collisionMode;
-	f32 gravity;
-	f32 frictionAir; //TODO(delle,Ph) this should depend on object shape
-	f32 maxVelocity;
-	f32 minVelocity;
-	f32 maxRotVelocity; //per axis in degrees
-	f32 minRotVelocity;
+	u32 tuplesVersion; //version of the admin's Physics query the tuples were built from
+	
+	//threaded mode steps at the fixed rate on its own thread so frame rate and physics rate are independent
+	//the main thread holds worldLock while it touches game state (see deshi.cpp) and the physics thread holds it
+	//for one step at a time, each step publishes a snapshot and transforms are interpolated between the last two
+	b32 threaded;
+	u32 maxCatchUpSteps; //steps a late physics thread runs before dropping the rest of its backlog
+	u32 droppedSteps;    //total steps dropped that way
+	std::thread thread;
+	std::atomic<b32> threadRunning{false};
+	std::atomic<b32> threadExited{true};
+	std::mutex worldLock;
+	PhysicsSnapshot snapshots[2];
+	u32 latestSnapshot;
 	
-	u32 collisionCount;
+	//trigger events of every step since the last frame, moved out of triggerEvents by Update for gameplay to read
+	std::vector<TriggerEvent> frameTriggerEvents;
+	
+	//stays on the main thread since it updates player movement and draws debug lines
+	SystemAccess access{ComponentType_Player | ComponentType_Camera,
+		ComponentType_Physics | ComponentType_Movement | ComponentType_Transform | ComponentType_Collider |
+		ComponentType_ColliderBox | ComponentType_ColliderAABB | ComponentType_ColliderSphere | ComponentType_ColliderLandscape, true};
 	
 	void Init(Admin* admin);
 	void Update();
+	
+	void StartThread();
+	//stops and joins the physics thread, the caller must not be holding worldLock
+	void StopThread();
+	void ThreadLoop();
+	
+	//rebuilds the tuples when the admin's entities changed and points the world at the main camera and player
+	//when the physics thread is running this and the scene queries have to be called while holding worldLock,
+	//which the main thread's update does
+	void SyncBodies() override;
 };
 
 #endif //SYSTEM_PHYSICS_H
\ No newline at end of file
@@ -0,0 +1,1759 @@
+#include "PhysicsWorld.h"
+#include "PhysicsIntegrator.h"
+#include "PhysicsSolver.h"
+#include "PhysicsConvex.h"
+#include "PhysicsPrimitives.h"
+#include "../entities/Entity.h"
+#include "../components/Physics.h"
+#include "../components/Camera.h"
+#include "../components/Collider.h"
+#include "../../core/jobs.h"
+#include "../../core/memory.h"
+#include "../../core/time.h"
+#include "../../math/Math.h"
+#include "../../geometry/Geometry.h"
+
+#include <algorithm>
+
+struct NarrowphaseResult;
+
+//what the one-vs-many kernels need of a tuple that the bounds dont already give, refreshed along with the bounds
+struct PrimitiveShape{
+	u32 type;       //ColliderType_Sphere, ColliderType_AABB (whose corners are its bounds), or anything else to skip the kernels
+	f32 radius;     //sphere
+	Vector3 center; //sphere
+};
+
+//keys of the colliders of an overlapping pair, the lower key first
+struct ColliderPair{
+	u64 a;
+	u64 b;
+};
+
+inline b32 ColliderPairLess(const ColliderPair& a, const ColliderPair& b){
+	return (a.a != b.a) ? a.a < b.a : a.b < b.b;
+}
+
+//vectors the stages fill every step, kept in the world so they arent reallocated and so worlds dont share them
+struct PhysicsWorldScratch{
+	PhysicsBodiesSoA bodies;
+	std::vector<u32> indexes; //bodies integrated this step
+	std::vector<u64> pairs;   //tuple indexes packed as i << 32 | j
+	std::vector<std::vector<NarrowphaseResult>> buffers; //one per batch, so a batch only writes its own
+	std::vector<NarrowphaseResult> merged;
+	std::vector<PrimitiveShape> shapes; //indexed like the tuples, valid wherever the bounds are
+	std::vector<ColliderPair> eventPairs;     //pairs that send their events once which overlapped this step
+	std::vector<ColliderPair> lastEventPairs; //and last step, sorted so they can be searched
+	std::vector<TriggerOverlap> lastTriggerOverlaps;
+	std::vector<u64> liveColliders; //sorted keys, to find which colliders trigger exits can still be reported for
+	std::vector<u8>  islandAwake;
+	std::vector<u32> islandIds;
+	std::vector<u64> sleepers; //sleeping bodies as island << 32 | tuple index, sorted so each island's bodies are together
+	b32 sleepersValid = false; //cleared whenever bodies may have fallen asleep or the tuples been rebuilt
+};
+
+//bodies on an entity are scaled by its transform, the rest by their own scale
+inline Vector3 BodyScale(Physics* p){
+	return (p->entity) ? p->entity->transform.scale : p->scale;
+}
+
+//bodies without an entity are never the player, even in a world that has none
+inline b32 IsPlayer(PhysicsWorld* ps, Physics* p){
+	return ps->player && p->entity == ps->player;
+}
+
+/////////////////////
+//// integration ////
+/////////////////////
+
+
+//TODO(delle,Ph) look into bettering this physics tick
+//https://gafferongames.com/post/physics_in_3d/
+//the tick is split into stages so the linear stage can be batched by the SoA integrator (see PhysicsIntegrator.h)
+
+//returns the sum of the forces on the body this tick, gravity and air friction are left to the linear stage
+inline Vector3 PhysicsTickForces(PhysicsTuple& t, PhysicsWorld* ps) {
+	//add input forces
+	t.physics->inputVector.normalize();
+	t.physics->AddForce(nullptr, t.physics->inputVector);
+	t.physics->inputVector = Vector3::ZERO;
+	
+	//contacts is the various contact states it has with each object while
+	//contactState is the overall state of the object, regardless of what object its touching
+	bool contactMoving = false;
+	bool contactStationary = false;
+	//friction along contact surfaces is applied by the contact solver
+	for (auto& c : t.physics->contacts) {
+		if      (c.state == ContactMoving)     contactMoving = true;
+		else if (c.state == ContactStationary) contactStationary = true;
+	}
+	
+	if      (contactMoving)     t.physics->contactState = ContactMoving;
+	else if (contactStationary) t.physics->contactState = ContactStationary;
+	else                        t.physics->contactState = ContactNONE;
+	
+	//forces are summed as they are added
+	Vector3 netForce = t.physics->netForce;
+	t.physics->netForce = Vector3::ZERO;
+	return netForce;
+}
+
+//gravity, air friction, and euler integration of velocity and position
+inline void PhysicsTickLinear(PhysicsTuple& t, PhysicsWorld* ps, Vector3 netForce, f32 deltaTime) {
+	//add gravity 
+	t.physics->acceleration += Vector3(0, -ps->gravity, 0);
+	
+	//add temp air friction force
+	netForce += -t.physics->velocity.normalized() * ps->frictionAir * t.physics->mass * 9.807f;
+	t.physics->acceleration += netForce / t.physics->mass;
+	
+	//update linear movement and clamp it to min/max velocity
+	if (!t.physics->staticPosition) {
+		t.physics->velocity += t.physics->acceleration * deltaTime;
+		float velMag = t.physics->velocity.mag();
+		if (velMag > ps->maxVelocity) {
+			t.physics->velocity /= velMag;
+			t.physics->velocity *= ps->maxVelocity;
+		}
+		else if (velMag < ps->minVelocity) {
+			t.physics->velocity = Vector3::ZERO;
+			t.physics->acceleration = Vector3::ZERO;
+		}
+		t.physics->position += t.physics->velocity * deltaTime;
+	}
+}
+
+inline void PhysicsTickRotation(PhysicsTuple& t, PhysicsWorld* ps, f32 deltaTime) {
+	//make fake rotational friction
+	if (t.physics->rotVelocity != Vector3::ZERO) {
+		t.physics->rotAcceleration = Vector3(t.physics->rotVelocity.x > 0 ? -1 : 1, t.physics->rotVelocity.y > 0 ? -1 : 1, t.physics->rotVelocity.z > 0 ? -1 : 1) * ps->frictionAir * t.physics->mass * 100;
+	}
+	
+	//update rotational movement and scuffed vector rotational clamping
+	t.physics->rotVelocity += t.physics->rotAcceleration * deltaTime;
+	//if(t.physics->rotVelocity.x > ps->maxRotVelocity) {
+	//	t.physics->rotVelocity.x = ps->maxRotVelocity;
+	//} else if(t.physics->rotVelocity.x < -ps->maxRotVelocity) {
+	//	t.physics->rotVelocity.x = -ps->maxRotVelocity;
+	//} else if(abs(t.physics->rotVelocity.x) < ps->minRotVelocity) {
+	//	t.physics->rotVelocity.x = 0;
+	//	t.physics->rotAcceleration.x = 0;
+	//}
+	//if(t.physics->rotVelocity.y > ps->maxRotVelocity) {
+	//	t.physics->rotVelocity.y = ps->maxRotVelocity;
+	//} else if(t.physics->rotVelocity.y < -ps->maxRotVelocity) {
+	//	t.physics->rotVelocity.y = -ps->maxRotVelocity;
+	//} else if(abs(t.physics->rotVelocity.y) < ps->minRotVelocity) {
+	//	t.physics->rotVelocity.y = 0;
+	//	t.physics->rotAcceleration.y = 0;
+	//}
+	//if(t.physics->rotVelocity.z > ps->maxRotVelocity) {
+	//	t.physics->rotVelocity.z = ps->maxRotVelocity;
+	//} else if(t.physics->rotVelocity.z < -ps->maxRotVelocity) {
+	//	t.physics->rotVelocity.z = -ps->maxRotVelocity;
+	//} else if(abs(t.physics->rotVelocity.z) < ps->minRotVelocity) {
+	//	t.physics->rotVelocity.z = 0;
+	//	t.physics->rotAcceleration.z = 0;
+	//}
+	t.physics->rotation += t.physics->rotVelocity * deltaTime;
+	
+	//ImGui::DebugDrawText3(t.physics->position.str().c_str(), t.physics->position, ad->mainCamera, DengWindow->dimensions, Color(180, 150, 130));
+	//ImGui::DebugDrawText3(t.physics->velocity.str().c_str(), t.physics->position, ad->mainCamera, DengWindow->dimensions, Color(130, 150, 180), Vector2(0, 20));
+	//ImGui::DebugDrawText3(t.physics->acceleration.str().c_str(), t.physics->position, ad->mainCamera, DengWindow->dimensions, Color(150, 130, 180), Vector2(0, 40));
+	
+	t.physics->acceleration = Vector3::ZERO;
+}
+
+//integrates bodies that all skipped the same number of ticks over deltaTime
+//forces added while a body waited are averaged, so they act for as long as they would have one tick at a time
+inline void IntegrateGroup(PhysicsWorld* ps, std::vector<PhysicsTuple>& tuples, u32* indexes, u32 count, u32 ticks, f32 deltaTime) {
+	PhysicsBodiesSoA& bodies = ps->scratch->bodies;
+	if(!ps->simdIntegration){
+		forI(count){
+			Vector3 netForce = PhysicsTickForces(tuples[indexes[i]], ps) / (f32)ticks;
+			PhysicsTickLinear(tuples[indexes[i]], ps, netForce, deltaTime);
+			PhysicsTickRotation(tuples[indexes[i]], ps, deltaTime);
+		}
+		return;
+	}
+	
+	bodies.Resize(count);
+	forI(count){
+		Physics* p = tuples[indexes[i]].physics;
+		Vector3 netForce = PhysicsTickForces(tuples[indexes[i]], ps) / (f32)ticks;
+		bodies.Set(i, p->position, p->velocity, p->acceleration, netForce, p->mass, p->staticPosition);
+	}
+	
+	PhysicsIntegrateParams params{deltaTime, ps->gravity, ps->frictionAir * 9.807f, ps->minVelocity, ps->maxVelocity};
+	IntegrateBodiesSIMD(bodies, params);
+	
+	forI(count){
+		Physics* p = tuples[indexes[i]].physics;
+		p->position = Vector3(bodies.px[i], bodies.py[i], bodies.pz[i]);
+		p->velocity = Vector3(bodies.vx[i], bodies.vy[i], bodies.vz[i]);
+		PhysicsTickRotation(tuples[indexes[i]], ps, deltaTime);
+	}
+}
+
+//runs the tick stages over every awake non-player body whose LOD tier is due this tick,
+//batching the linear stage through the SoA integrator
+inline void IntegrateBodies(PhysicsWorld* ps, std::vector<PhysicsTuple>& tuples) {
+	std::vector<u32>& indexes = ps->scratch->indexes;
+	indexes.clear();
+	b32 skipped = false;
+	for(u32 i = 0; i < tuples.size(); ++i){
+		PhysicsTuple& t = tuples[i];
+		if(IsPlayer(ps, t.physics) || t.physics->sleeping) continue;
+		t.physics->lodTicks++;
+		if(t.physics->lodTicks < (1u << t.physics->lodTier)) continue;
+		skipped |= t.physics->lodTicks > 1;
+		indexes.push_back(i);
+	}
+	
+	//bodies that skipped the same number of ticks are integrated together since they share a delta time
+	if(skipped){
+		std::sort(indexes.begin(), indexes.end(), [&](u32 a, u32 b){
+			u32 ticksA = tuples[a].physics->lodTicks, ticksB = tuples[b].physics->lodTicks;
+			return (ticksA != ticksB) ? ticksA < ticksB : a < b;
+		});
+	}
+	for(u32 start = 0; start < indexes.size();){
+		u32 ticks = tuples[indexes[start]].physics->lodTicks;
+		u32 end = start + 1;
+		while(end < indexes.size() && tuples[indexes[end]].physics->lodTicks == ticks) end++;
+		IntegrateGroup(ps, tuples, &indexes[start], end - start, ticks, ticks * ps->deltaTime);
+		for(u32 i = start; i < end; ++i) tuples[indexes[i]].physics->lodTicks = 0;
+		start = end;
+	}
+}
+
+//puts each awake body in a tier by its distance from the world's camera and whether it is in the camera's view
+//the bounds are from the last step, which is close enough for picking a tier
+inline void AssignLODTiers(PhysicsWorld* ps, std::vector<PhysicsTuple>& tuples, std::vector<AABB>& bounds) {
+	forI(PHYSICS_LOD_TIERS) ps->lodCounts[i] = 0;
+	Camera* camera = ps->camera;
+	
+	//frustum side planes from the columns of the view projection matrix, pointing inwards (Gribb and Hartmann)
+	//the near and far planes are left out, behind the camera is caught by the sides and far away by the distances
+	Vector4 planes[4];
+	if(camera){
+		Matrix4 m = camera->viewMat * camera->projMat;
+		Vector4 columns[4];
+		forI(4) columns[i] = Vector4(m.data[i], m.data[4+i], m.data[8+i], m.data[12+i]);
+		planes[0] = columns[3] + columns[0];
+		planes[1] = columns[3] - columns[0];
+		planes[2] = columns[3] + columns[1];
+		planes[3] = columns[3] - columns[1];
+		forI(4){
+			f32 length = Vector3(planes[i].x, planes[i].y, planes[i].z).mag();
+			if(length > 0) planes[i] = planes[i] / length;
+		}
+	}
+	
+	for(u32 i = 0; i < tuples.size(); ++i){
+		Physics* p = tuples[i].physics;
+		if(p->sleeping) continue;
+		u32 tier = 0;
+		if(ps->lodEnabled && camera && !IsPlayer(ps, p)){
+			Vector3 center = p->position;
+			f32 radius = 0;
+			if(tuples[i].collider && tuples[i].collider->broadphaseProxy != AABBTREE_NULL && i < bounds.size()){
+				center = bounds[i].Center();
+				radius = (bounds[i].max - bounds[i].min).mag() * .5f;
+			}
+			
+			f32 distance = (center - camera->position).mag() - radius;
+			while(tier < PHYSICS_LOD_TIERS-1 && distance >= ps->lodDistances[tier]) tier++;
+			
+			if(ps->lodOffscreenTier && tier < ps->lodOffscreenTier){
+				forX(plane, 4){
+					if(planes[plane].x*center.x + planes[plane].y*center.y + planes[plane].z*center.z + planes[plane].w < -radius){
+						tier = Min(ps->lodOffscreenTier, (u32)PHYSICS_LOD_TIERS-1);
+						break;
+					}
+				}
+			}
+		}
+		p->lodTier = tier;
+		ps->lodCounts[tier]++;
+	}
+}
+
+/////////////////////
+//// collisions  ////
+/////////////////////
+
+Matrix4 LocalToWorldInertiaTensor(Physics* physics, Matrix3 inertiaTensor) {
+	Matrix4 inverseTransformation = Matrix4::TransformationMatrix(physics->position, physics->rotation, Vector3::ONE).Inverse();
+	return inverseTransformation.Transpose() * inertiaTensor.To4x4() * inverseTransformation;
+}
+
+//what the narrowphase found for one pair, the tests only read the bodies so they can run on any thread
+//and their results are applied to the colliders and the contact cache afterwards in pair order
+struct NarrowphaseResult{
+	u64 key; //tuple indexes of the pair, results are merged sorted by this so the thread count doesnt change them
+	Physics*  a;
+	Collider* colliderA;
+	Physics*  b;
+	Collider* colliderB;
+	b32 overlap;   //the shapes overlap, so their events are sent
+	b32 eventOnce; //only send events when the pair didnt overlap last step
+	b32 found;
+	Vector3 normal; //from a to b
+	Vector3 points[CONTACT_MAX_POINTS];
+	f32 depths[CONTACT_MAX_POINTS];
+	u32 pointCount;
+};
+
+inline void NarrowphaseOverlap(NarrowphaseResult& out, Physics* a, Collider* colliderA, Physics* b, Collider* colliderB, b32 eventOnce){
+	out.a         = a;
+	out.colliderA = colliderA;
+	out.b         = b;
+	out.colliderB = colliderB;
+	out.overlap   = true;
+	out.eventOnce = eventOnce;
+}
+
+inline void NarrowphaseContacts(NarrowphaseResult& out, Vector3 normal, Vector3* points, f32* depths, u32 pointCount){
+	out.normal     = normal;
+	out.pointCount = Min(pointCount, (u32)CONTACT_MAX_POINTS);
+	forI(out.pointCount){
+		out.points[i] = points[i];
+		out.depths[i] = depths[i];
+	}
+}
+
+bool AABBAABBCollision(NarrowphaseResult& out, Physics* obj1, AABBCollider* obj1Col, Physics* obj2, AABBCollider* obj2Col) {
+	vec3 min1 = obj1->position - (obj1Col->halfDims * BodyScale(obj1));
+	vec3 max1 = obj1->position + (obj1Col->halfDims * BodyScale(obj1));
+	vec3 min2 = obj2->position - (obj2Col->halfDims * BodyScale(obj2));
+	vec3 max2 = obj2->position + (obj2Col->halfDims * BodyScale(obj2));
+	
+	if (//check if overlapping
+		(min1.x <= max2.x && max1.x >= min2.x) &&
+		(min1.y <= max2.y && max1.y >= min2.y) &&
+		(min1.z <= max2.z && max1.z >= min2.z)) {
+		NarrowphaseOverlap(out, obj1, obj1Col, obj2, obj2Col, true);
+		
+		//overlap region of the two boxes
+		vec3 overMin(Max(min1.x, min2.x), Max(min1.y, min2.y), Max(min1.z, min2.z));
+		vec3 overMax(Min(max1.x, max2.x), Min(max1.y, max2.y), Min(max1.z, max2.z));
+		vec3 over = overMax - overMin;
+		vec3 mid  = (overMin + overMax) / 2.f;
+		
+		//the normal is the axis of least overlap pointing from obj1 to obj2, the contact points are the
+		//corners of the overlap region's face across that axis
+		vec3 normal;
+		f32 depth;
+		vec3 points[4];
+		if (over.x <= over.y && over.x <= over.z) {
+			normal = (obj2->position.x >= obj1->position.x) ? Vector3::RIGHT : Vector3::LEFT;
+			depth  = over.x;
+			points[0] = vec3(mid.x, overMin.y, overMin.z); points[1] = vec3(mid.x, overMax.y, overMin.z);
+			points[2] = vec3(mid.x, overMax.y, overMax.z); points[3] = vec3(mid.x, overMin.y, overMax.z);
+		}
+		else if (over.y <= over.z) {
+			normal = (obj2->position.y >= obj1->position.y) ? Vector3::UP : Vector3::DOWN;
+			depth  = over.y;
+			points[0] = vec3(overMin.x, mid.y, overMin.z); points[1] = vec3(overMax.x, mid.y, overMin.z);
+			points[2] = vec3(overMax.x, mid.y, overMax.z); points[3] = vec3(overMin.x, mid.y, overMax.z);
+		}
+		else {
+			normal = (obj2->position.z >= obj1->position.z) ? Vector3::FORWARD : Vector3::BACK;
+			depth  = over.z;
+			points[0] = vec3(overMin.x, overMin.y, mid.z); points[1] = vec3(overMax.x, overMin.y, mid.z);
+			points[2] = vec3(overMax.x, overMax.y, mid.z); points[3] = vec3(overMin.x, overMax.y, mid.z);
+		}
+		f32 depths[4] = {depth, depth, depth, depth};
+		NarrowphaseContacts(out, normal, points, depths, 4);
+		return true;
+	}
+	return false;
+}
+
+inline bool AABBSphereCollision(NarrowphaseResult& out, Physics* aabb, AABBCollider* aabbCol, Physics* sphere, SphereCollider* sphereCol) {
+	Vector3 halfDims = aabbCol->halfDims * BodyScale(aabb);
+	Vector3 aabbPoint = Geometry::ClosestPointOnAABB(aabb->position, halfDims, sphere->position);
+	Vector3 vectorBetween = sphere->position - aabbPoint; //aabb towards sphere
+	float distanceBetween = vectorBetween.mag();
+	if(distanceBetween < sphereCol->radius) {
+		NarrowphaseOverlap(out, aabb, aabbCol, sphere, sphereCol, false);
+		
+		Vector3 normal;
+		float depth;
+		if (distanceBetween > 1e-5f) {
+			normal = vectorBetween / distanceBetween;
+			depth  = sphereCol->radius - distanceBetween;
+		}
+		else {
+			//NOTE if the sphere's center is inside the aabb the closest point has no direction, so
+			//push out through the face the center is closest to
+			Vector3 offset = sphere->position - aabb->position;
+			Vector3 face   = halfDims - Vector3(fabs(offset.x), fabs(offset.y), fabs(offset.z));
+			if (face.x <= face.y && face.x <= face.z) { normal = Vector3((offset.x >= 0) ? 1.f : -1.f, 0, 0); depth = face.x; }
+			else if (face.y <= face.z)                { normal = Vector3(0, (offset.y >= 0) ? 1.f : -1.f, 0); depth = face.y; }
+			else                                      { normal = Vector3(0, 0, (offset.z >= 0) ? 1.f : -1.f); depth = face.z; }
+			depth += sphereCol->radius;
+		}
+		NarrowphaseContacts(out, normal, &aabbPoint, &depth, 1);
+		return true;
+	}
+	return false;
+}
+
+inline bool SphereSphereCollision(NarrowphaseResult& out, Physics* s1, SphereCollider* sc1, Physics* s2, SphereCollider* sc2) {
+	Vector3 s1t2 = s2->position - s1->position;
+	float dist = s1t2.mag();
+	float rsum = sc1->radius + sc2->radius;
+	if (rsum > dist) {
+		NarrowphaseOverlap(out, s1, sc1, s2, sc2, false);
+		
+		Vector3 normal = (dist > 1e-5f) ? s1t2 / dist : Vector3::UP;
+		float depth = rsum - dist;
+		Vector3 point = s1->position + normal * (sc1->radius - depth / 2);
+		NarrowphaseContacts(out, normal, &point, &depth, 1);
+		return true;
+	}
+	return false;
+}
+
+inline void SphereLandscapeCollision(Physics* s, SphereCollider* sc, Physics* ls, SphereCollider* lsc) {
+
+}
+
+//support shape of a collider for GJK, returns false for colliders that arent convex
+inline b32 ColliderConvexShape(Physics* p, Collider* c, ConvexShape& out) {
+	Vector3 scale = BodyScale(p);
+	switch(c->type){
+		case(ColliderType_AABB):{
+			out = ConvexShape::FromAABB(p->position, ((AABBCollider*)c)->halfDims * scale);
+		}return true;
+		case(ColliderType_Sphere):{
+			out = ConvexShape::FromSphere(p->position, ((SphereCollider*)c)->radius);
+		}return true;
+		case(ColliderType_Box):{
+			out = ConvexShape::FromBox(p->position, p->rotation, ((BoxCollider*)c)->halfDims * scale);
+		}return true;
+		case(ColliderType_Complex):{ //treated as the render mesh's convex hull when it has no hulls of its own
+			if(!((ComplexCollider*)c)->mesh) return false;
+			out = ConvexShape::FromMesh(((ComplexCollider*)c)->mesh, p->position, p->rotation, scale);
+		}return true;
+	}
+	return false;
+}
+
+//calls fn(shape) for each convex piece of the collider, which is one for everything but complex colliders with hulls
+//fn returns false to stop
+template<class F>
+inline void ColliderConvexShapes(Physics* p, Collider* c, F fn) {
+	if(c->type == ColliderType_Complex && ((ComplexCollider*)c)->hulls.size()){
+		Vector3 scale = BodyScale(p);
+		for(ConvexHull& hull : ((ComplexCollider*)c)->hulls){
+			ConvexShape shape = ConvexShape::FromHull(hull, p->position, p->rotation, scale);
+			if(!fn(shape)) return;
+		}
+		return;
+	}
+	ConvexShape shape;
+	if(ColliderConvexShape(p, c, shape)) fn(shape);
+}
+
+//contacts found between the convex pieces of two colliders, once full the shallowest is replaced
+struct PieceContacts{
+	ConvexContact contacts[4*CONTACT_MAX_POINTS];
+	u32 count = 0;
+	
+	void Add(const ConvexContact& contact){
+		u32 slot = count;
+		if(count == ArrayCount(contacts)){
+			slot = 0;
+			forI(count) if(contacts[i].depth < contacts[slot].depth) slot = i;
+			if(contacts[slot].depth >= contact.depth) return;
+		}else{
+			count++;
+		}
+		contacts[slot] = contact;
+	}
+};
+
+//the deepest contact gives the normal and the contacts that agree with it are the manifold's points
+inline void NarrowphasePieceContacts(NarrowphaseResult& out, PieceContacts& pieces){
+	ConvexContact* contacts = pieces.contacts;
+	std::sort(contacts, contacts + pieces.count, [](const ConvexContact& a, const ConvexContact& b){ return a.depth > b.depth; });
+	Vector3 normal = contacts[0].normal;
+	Vector3 points[CONTACT_MAX_POINTS];
+	f32 depths[CONTACT_MAX_POINTS];
+	u32 pointCount = 0;
+	for(u32 i = 0; i < pieces.count && pointCount < CONTACT_MAX_POINTS; ++i){
+		f32 agreement = (i) ? contacts[i].normal.dot(normal) : 1.f;
+		if(agreement < .95f) continue;
+		points[pointCount] = contacts[i].point;
+		depths[pointCount] = contacts[i].depth * agreement;
+		pointCount++;
+	}
+	NarrowphaseContacts(out, normal, points, depths, pointCount);
+}
+
+//GJK for overlap and EPA for the penetration between every pair of the colliders' convex pieces, used for every
+//pair without a dedicated test
+inline bool ConvexConvexCollision(NarrowphaseResult& out, Physics* obj1, Collider* obj1Col, Physics* obj2, Collider* obj2Col) {
+	PieceContacts pieces;
+	ColliderConvexShapes(obj1, obj1Col, [&](ConvexShape& a){
+		ColliderConvexShapes(obj2, obj2Col, [&](ConvexShape& b){
+			ConvexContact contact;
+			if(ConvexCollision(a, b, contact)) pieces.Add(contact);
+			return true;
+		});
+		return true;
+	});
+	if(!pieces.count) return false;
+	
+	NarrowphaseOverlap(out, obj1, obj1Col, obj2, obj2Col, false);
+	
+	NarrowphasePieceContacts(out, pieces);
+	return true;
+}
+
+//bounds of the box's corners after they are transformed
+inline AABB TransformAABB(const AABB& aabb, const Matrix4& transform) {
+	AABB out;
+	forI(8){
+		Vector3 corner = Vector3((i & 1) ? aabb.max.x : aabb.min.x, (i & 2) ? aabb.max.y : aabb.min.y, (i & 4) ? aabb.max.z : aabb.min.z) * transform;
+		out = (i) ? AABB::Union(out, AABB(corner, corner)) : AABB(corner, corner);
+	}
+	return out;
+}
+
+//world space bounds of a convex shape from its support points along the axes
+inline AABB ConvexShapeAABB(ConvexShape& shape) {
+	return AABB(Vector3(shape.Support(Vector3(-1, 0, 0)).x, shape.Support(Vector3(0, -1, 0)).y, shape.Support(Vector3(0, 0, -1)).z),
+				Vector3(shape.Support(Vector3( 1, 0, 0)).x, shape.Support(Vector3(0,  1, 0)).y, shape.Support(Vector3(0, 0,  1)).z));
+}
+
+//the triangle bvh of the tuple's collider if it should be tested against other triangle by triangle
+//landscapes always are, complex meshes only when they have no hulls (their bvh is empty otherwise), and then against
+//everything but a moving complex mesh, which uses the render mesh's convex hull
+//other is 0 for scene queries
+inline TriangleBVH* ColliderTriangles(PhysicsTuple& t, Collider* other) {
+	TriangleBVH* bvh = 0;
+	switch(t.collider->type){
+		case(ColliderType_Landscape):{
+			bvh = &((LandscapeCollider*)t.collider)->bvh;
+		}break;
+		case(ColliderType_Complex):{
+			if(other && other->type == ColliderType_Complex && !t.physics->staticPosition) return 0;
+			bvh = &((ComplexCollider*)t.collider)->bvh;
+		}break;
+	}
+	return (bvh && bvh->TriangleCount()) ? bvh : 0;
+}
+
+//the triangles of a mesh collider that the aabb overlaps as world space shapes, or the collider's convex shape
+template<class F>
+inline void ColliderShapes(PhysicsTuple& t, const AABB& aabb, F fn){
+	if(TriangleBVH* bvh = ColliderTriangles(t, 0)){
+		Matrix4 transform = Matrix4::TransformationMatrix(t.physics->position, t.physics->rotation, BodyScale(t.physics));
+		bvh->Query(TransformAABB(aabb, transform.Inverse()), [&](u32 index){
+			const Vector3* p = bvh->TriangleVertices(index);
+			ConvexShape triangle = ConvexShape::FromTriangle(p[0] * transform, p[1] * transform, p[2] * transform);
+			return fn(triangle);
+		});
+		return;
+	}
+	ColliderConvexShapes(t.physics, t.collider, fn);
+}
+
+//GJK/EPA between each convex piece of the collider and each triangle of the mesh's bvh that its bounds touch, so the
+//mesh doesnt have to be convex
+inline bool ConvexTrianglesCollision(NarrowphaseResult& out, Physics* obj, Collider* col, Physics* meshObj, Collider* meshCol, TriangleBVH* bvh) {
+	Matrix4 transform = Matrix4::TransformationMatrix(meshObj->position, meshObj->rotation, BodyScale(meshObj));
+	Matrix4 inverse = transform.Inverse();
+	PieceContacts pieces;
+	ColliderConvexShapes(obj, col, [&](ConvexShape& shape){
+		bvh->Query(TransformAABB(ConvexShapeAABB(shape), inverse), [&](u32 index){
+			const Vector3* p = bvh->TriangleVertices(index);
+			ConvexShape triangle = ConvexShape::FromTriangle(p[0] * transform, p[1] * transform, p[2] * transform);
+			ConvexContact contact;
+			if(ConvexCollision(shape, triangle, contact)) pieces.Add(contact);
+			return true;
+		});
+		return true;
+	});
+	if(!pieces.count) return false;
+	
+	NarrowphaseOverlap(out, obj, col, meshObj, meshCol, false);
+	
+	NarrowphasePieceContacts(out, pieces);
+	return true;
+}
+
+
+
+//NOTE make sure you are using the right physics component, because the collision 
+//functions dont check that the provided one matches the tuple
+//returns true if the narrowphase found contacts, which are left in the result until the merge
+//spheres and AABBs have their own tests in DISCRETE mode, everything else goes through GJK
+inline bool CheckCollision(NarrowphaseResult& out, PhysicsTuple& tuple, PhysicsTuple& other, CollisionDetectionMode mode) {
+	if(mode == CollisionDetectionMode::DISCRETE || mode == CollisionDetectionMode::CONTINUOUS){
+		switch(tuple.collider->type){
+			case(ColliderType_Sphere):
+			switch(other.collider->type){
+				case(ColliderType_Sphere):{ return SphereSphereCollision(out, tuple.physics, (SphereCollider*)tuple.collider,
+																		      other.physics, (SphereCollider*)other.collider); }
+				case(ColliderType_AABB):  { return AABBSphereCollision  (out, other.physics, (AABBCollider*)  other.collider,
+																		      tuple.physics, (SphereCollider*)tuple.collider); }
+			}break;
+			case(ColliderType_AABB):
+			switch(other.collider->type){
+				case(ColliderType_Sphere):{ return AABBSphereCollision(out, tuple.physics, (AABBCollider*)  tuple.collider,
+																	      other.physics, (SphereCollider*)other.collider); }
+				case(ColliderType_AABB):  { return AABBAABBCollision  (out, tuple.physics, (AABBCollider*)tuple.collider,
+																	      other.physics, (AABBCollider*)other.collider); }
+			}break;
+		}
+	}
+	if(mode == CollisionDetectionMode::NONE) return false;
+	if(TriangleBVH* bvh = ColliderTriangles(other, tuple.collider)){
+		return ConvexTrianglesCollision(out, tuple.physics, tuple.collider, other.physics, other.collider, bvh);
+	}
+	if(TriangleBVH* bvh = ColliderTriangles(tuple, other.collider)){
+		return ConvexTrianglesCollision(out, other.physics, other.collider, tuple.physics, tuple.collider, bvh);
+	}
+	return ConvexConvexCollision(out, tuple.physics, tuple.collider, other.physics, other.collider);
+}
+
+//runs the pairs of one body, which all have it first, through the one-vs-many kernels in PhysicsPrimitives when it is a
+//sphere or AABB; its sphere and AABB candidates are packed into lanes from the shapes and bounds the refit left, and a
+//lane that misses would have been found not touching by CheckCollision, so only the hits are passed to test to make
+//their contacts and everything else is passed as is
+template<class F>
+inline void PrimitivePairs(std::vector<PrimitiveShape>& shapes, std::vector<AABB>& bounds, u64* pairs, u32 count, F test) {
+	u32 index = pairs[0] >> 32;
+	PrimitiveShape& shape = shapes[index];
+	if(count < PRIMITIVE_MIN_CANDIDATES || (shape.type != ColliderType_Sphere && shape.type != ColliderType_AABB)){
+		forI(count) test(pairs[i]);
+		return;
+	}
+	
+	b32 isSphere = shape.type == ColliderType_Sphere;
+	AABB& box = bounds[index];
+	PrimitiveLanes spheres, aabbs;
+	auto flush = [&](PrimitiveLanes& lanes, b32 lanesAreSpheres){
+		if(!lanes.count) return;
+		lanes.Pad();
+		u32 hits;
+		if(isSphere) hits = (lanesAreSpheres) ? SphereVsSpheresSIMD(shape.center, shape.radius, lanes) : SphereVsAABBsSIMD(shape.center, shape.radius, lanes);
+		else         hits = (lanesAreSpheres) ? AABBVsSpheresSIMD(box.min, box.max, lanes)             : AABBVsAABBsSIMD(box.min, box.max, lanes);
+#if DESHI_SLOW
+		u32 scalar;
+		if(isSphere) scalar = (lanesAreSpheres) ? SphereVsSpheresScalar(shape.center, shape.radius, lanes) : SphereVsAABBsScalar(shape.center, shape.radius, lanes);
+		else         scalar = (lanesAreSpheres) ? AABBVsSpheresScalar(box.min, box.max, lanes)             : AABBVsAABBsScalar(box.min, box.max, lanes);
+		Assert(hits == scalar, "the SIMD kernels have to find the same hits as the scalar ones");
+#endif
+		forX(lane, lanes.count) if(hits & (1 << lane)) test(pairs[lanes.id[lane]]);
+		lanes.count = 0;
+	};
+	forI(count){
+		u32 other = pairs[i] & 0xFFFFFFFF;
+		if(shapes[other].type == ColliderType_Sphere){
+			spheres.AddSphere(shapes[other].center, shapes[other].radius, i);
+			if(spheres.count == PHYSICS_SIMD_WIDTH) flush(spheres, true);
+		}else if(shapes[other].type == ColliderType_AABB){
+			aabbs.AddAABB(bounds[other].min, bounds[other].max, i);
+			if(aabbs.count == PHYSICS_SIMD_WIDTH) flush(aabbs, false);
+		}else{
+			test(pairs[i]);
+		}
+	}
+	flush(spheres, true);
+	flush(aabbs, false);
+}
+
+////////////////////
+//// broadphase ////
+////////////////////
+
+//world space bounds of a tuple's collider, returns false if the collider shouldnt be in the broadphase
+inline b32 ColliderAABB(PhysicsTuple& t, AABB& out) {
+	Vector3 scale = BodyScale(t.physics);
+	switch(t.collider->type){
+		case(ColliderType_AABB):{
+			out = AABB::FromCenter(t.physics->position, ((AABBCollider*)t.collider)->halfDims * scale);
+		}return true;
+		case(ColliderType_Sphere):{
+			f32 r = ((SphereCollider*)t.collider)->radius;
+			out = AABB::FromCenter(t.physics->position, Vector3(r, r, r));
+		}return true;
+		case(ColliderType_Box):{ //bounding sphere so rotation doesnt matter
+			f32 r = (((BoxCollider*)t.collider)->halfDims * scale).mag();
+			out = AABB::FromCenter(t.physics->position, Vector3(r, r, r));
+		}return true;
+		case(ColliderType_Complex):{
+			f32 r = ((ComplexCollider*)t.collider)->boundingRadius * Max(Max(fabs(scale.x), fabs(scale.y)), fabs(scale.z));
+			out = AABB::FromCenter(t.physics->position, Vector3(r, r, r));
+		}return true;
+		case(ColliderType_Landscape):{
+			TriangleBVH& bvh = ((LandscapeCollider*)t.collider)->bvh;
+			if(!bvh.TriangleCount()) return false;
+			out = TransformAABB(bvh.Bounds(), Matrix4::TransformationMatrix(t.physics->position, t.physics->rotation, scale));
+		}return true;
+	}
+	return false;
+}
+
+inline AABBTree& GetBroadphaseTree(PhysicsWorld* ps, BroadphaseTree tree){
+	switch(tree){
+		case(BroadphaseTree_Static):  return ps->staticTree;
+		case(BroadphaseTree_Trigger): return ps->triggerTree;
+		default:                      return ps->dynamicTree;
+	}
+}
+
+//proxies whose collider went away are found by their stamp not being updated
+void SyncBroadphase(PhysicsWorld* ps) {
+	std::vector<PhysicsTuple>& tuples = ps->tuples;
+	ps->broadphaseStamp++;
+	for(u32 i = 0; i < tuples.size(); ++i){
+		PhysicsTuple& t = tuples[i];
+		if(!t.collider) continue;
+		
+		AABB aabb;
+		if(!ColliderAABB(t, aabb)){
+			if(t.collider->broadphaseProxy != AABBTREE_NULL){
+				GetBroadphaseTree(ps, t.collider->broadphaseTree).DestroyProxy(t.collider->broadphaseProxy);
+				t.collider->broadphaseProxy = AABBTREE_NULL;
+			}
+			continue;
+		}
+		
+		BroadphaseTree which = (t.collider->noCollide) ? BroadphaseTree_Trigger : (t.physics->staticPosition) ? BroadphaseTree_Static : BroadphaseTree_Dynamic;
+		if(t.collider->broadphaseProxy != AABBTREE_NULL && t.collider->broadphaseTree != which){
+			GetBroadphaseTree(ps, t.collider->broadphaseTree).DestroyProxy(t.collider->broadphaseProxy);
+			t.collider->broadphaseProxy = AABBTREE_NULL;
+		}
+		
+		AABBTree& tree = GetBroadphaseTree(ps, which);
+		if(t.collider->broadphaseProxy == AABBTREE_NULL){
+			t.collider->broadphaseProxy = tree.CreateProxy(aabb, i);
+			t.collider->broadphaseTree  = which;
+		}else{
+			tree.MoveProxy(t.collider->broadphaseProxy, aabb, Vector3::ZERO); //static bodies can still be moved by the editor
+			tree.nodes[t.collider->broadphaseProxy].userdata = i;
+		}
+		tree.nodes[t.collider->broadphaseProxy].stamp = ps->broadphaseStamp;
+	}
+	
+	//destroy orphaned proxies, we cant touch their colliders since they may have been deleted
+	for(AABBTree* tree : {&ps->staticTree, &ps->dynamicTree, &ps->triggerTree}){
+		for(u32 i = 0; i < tree->nodes.size(); ++i){
+			if(tree->nodes[i].height == 0 && tree->nodes[i].stamp != ps->broadphaseStamp){
+				tree->DestroyProxy(i);
+			}
+		}
+	}
+}
+
+//sets the bounds of the tuple's collider and the shape the one-vs-many kernels read for it
+inline void RefreshBounds(PhysicsWorld* ps, u32 i) {
+	PhysicsTuple& t = ps->tuples[i];
+	ColliderAABB(t, ps->bounds[i]);
+	PrimitiveShape& shape = ps->scratch->shapes[i];
+	shape.type = t.collider->type;
+	if(shape.type == ColliderType_Sphere){
+		shape.radius = ((SphereCollider*)t.collider)->radius;
+		shape.center = t.physics->position;
+	}
+}
+
+//refits dynamic proxies after integration, static proxies and static triggers only move in SyncBroadphase
+inline void RefitBroadphase(PhysicsWorld* ps, std::vector<PhysicsTuple>& tuples, std::vector<AABB>& bounds) {
+	bounds.resize(tuples.size());
+	ps->scratch->shapes.resize(tuples.size());
+	for(u32 i = 0; i < tuples.size(); ++i){
+		PhysicsTuple& t = tuples[i];
+		if(!t.collider || t.collider->broadphaseProxy == AABBTREE_NULL || t.physics->sleeping) continue;
+		RefreshBounds(ps, i);
+		if(t.collider->broadphaseTree == BroadphaseTree_Dynamic || (t.collider->broadphaseTree == BroadphaseTree_Trigger && !t.physics->staticPosition)){
+			GetBroadphaseTree(ps, t.collider->broadphaseTree).MoveProxy(t.collider->broadphaseProxy, bounds[i], t.physics->velocity * ps->deltaTime);
+		}
+	}
+}
+
+inline u32 IslandRoot(std::vector<u32>& parent, u32 i){
+	while(parent[i] != i){
+		parent[i] = parent[parent[i]];
+		i = parent[i];
+	}
+	return i;
+}
+
+//wakes every body that fell asleep in the island and gives it fresh bounds for this tick
+//the sleepers are listed by island the first time one wakes after they were invalidated, so waking only looks at the
+//island's own bodies instead of every tuple
+inline void WakeIsland(PhysicsWorld* ps, u32 island){
+	std::vector<u64>& sleepers = ps->scratch->sleepers;
+	if(!ps->scratch->sleepersValid){
+		sleepers.clear();
+		for(u32 k = 0; k < ps->tuples.size(); ++k){
+			if(ps->tuples[k].physics->sleeping) sleepers.push_back(((u64)ps->tuples[k].physics->sleepIsland << 32) | k);
+		}
+		std::sort(sleepers.begin(), sleepers.end());
+		ps->scratch->sleepersValid = true;
+	}
+	
+	for(auto it = std::lower_bound(sleepers.begin(), sleepers.end(), (u64)island << 32); it != sleepers.end() && (*it >> 32) == island; ++it){
+		u32 k = *it & 0xFFFFFFFF;
+		PhysicsTuple& t = ps->tuples[k];
+		if(!t.physics->sleeping) continue; //woken on its own since the list was made
+		t.physics->WakeUp();
+		if(t.collider && k < ps->bounds.size()) RefreshBounds(ps, k);
+	}
+}
+
+//sets the body's contact with other, replacing the one it already had
+inline void RecordBodyContact(Arena& arena, Physics* p, Physics* other, ContactState state, Manifold3& manifold){
+	b32 found = false;
+	for(BodyContact& c : p->contacts){
+		if(c.other == other){ c.state = state; found = true; break; }
+	}
+	if(!found) p->contacts.Add(arena, BodyContact{other, state});
+	
+	for(Manifold3& m : p->manifolds){
+		if(m.a == manifold.a && m.b == manifold.b){ m = manifold; return; }
+	}
+	p->manifolds.Add(arena, manifold);
+}
+
+//fills the per body contacts and manifolds that movement and the force stage read from the solved pairs
+//they are allocated from this step's arena, sleeping bodies keep theirs by moving them over from last step's
+inline void RecordContacts(PhysicsWorld* ps, std::vector<PhysicsTuple>& tuples){
+	Arena& arena = ps->stepArenas[ps->stepArena];
+	for(PhysicsTuple& t : tuples){
+		if(t.physics->sleeping){
+			t.physics->contacts.MoveTo(arena);
+			t.physics->manifolds.MoveTo(arena);
+		}else{
+			t.physics->contacts  = ArenaArray<BodyContact>();
+			t.physics->manifolds = ArenaArray<Manifold3>();
+		}
+	}
+	
+	for(ContactManifold& m : ps->contactCache.manifolds){
+		Vector3 relative = m.b->velocity - m.a->velocity;
+		b32 sliding = (relative - m.normal * relative.dot(m.normal)).mag() > 0.01f;
+		
+		//each body gets the normal that pushes it out of the other one
+		Manifold3 ma, mb;
+		ma.a = mb.a = m.colliderA;
+		ma.b = mb.b = m.colliderB;
+		ma.coltypea = mb.coltypea = m.colliderA->type;
+		ma.coltypeb = mb.coltypeb = m.colliderB->type;
+		ma.nColPoints = mb.nColPoints = Min(m.pointCount, (u32)MANIFOLD3_MAX_POINTS);
+		forI(ma.nColPoints){
+			ma.colpoints[i] = m.points[i].position;
+			mb.colpoints[i] = m.points[i].position;
+			ma.depth[i]     = mb.depth[i] = m.points[i].depth;
+		}
+		ma.norm   = -m.normal;
+		mb.norm   = m.normal;
+		ma.player = IsPlayer(ps, m.a);
+		mb.player = IsPlayer(ps, m.b);
+		RecordBodyContact(arena, m.a, m.b, (sliding && !m.a->staticPosition) ? ContactMoving : ContactStationary, ma);
+		RecordBodyContact(arena, m.b, m.a, (sliding && !m.b->staticPosition) ? ContactMoving : ContactStationary, mb);
+	}
+}
+
+//applies one narrowphase result, runs on one thread in pair order so events and the cache are filled deterministically
+inline void MergeNarrowphaseResult(PhysicsWorld* ps, NarrowphaseResult& r){
+	if(r.overlap){
+		Collider* c1 = r.colliderA;
+		Collider* c2 = r.colliderB;
+		if(r.eventOnce){
+			//the pair lists keep their capacity between steps, so a steady tick doesnt allocate for them
+			u64 k1 = c1->Key(), k2 = c2->Key();
+			ColliderPair pair = (k1 < k2) ? ColliderPair{k1, k2} : ColliderPair{k2, k1};
+			std::vector<ColliderPair>& last = ps->scratch->lastEventPairs;
+			if(!std::binary_search(last.begin(), last.end(), pair, ColliderPairLess)){
+				if (c1->event != 0 && !c1->sentEvent) { c1->sender->SendEvent(c1->event); c1->sentEvent = true; }
+				if (c2->event != 0 && !c2->sentEvent) { c2->sender->SendEvent(c2->event); c2->sentEvent = true; }
+			}
+			ps->scratch->eventPairs.push_back(pair);
+		}else{
+			if(c1->event != Event_NONE) c1->sender->SendEvent(c1->event);
+			if(c2->event != Event_NONE) c2->sender->SendEvent(c2->event);
+		}
+	}
+	if(r.found) ps->pairsFound++;
+	if(r.pointCount) ps->contactCache.Update(r.colliderA, r.a, r.colliderB, r.b, r.normal, r.points, r.depths, r.pointCount);
+}
+
+inline void CollisionTick(PhysicsWorld* ps, std::vector<PhysicsTuple>& tuples, std::vector<AABB>& bounds){
+	std::vector<u64>& pairs = ps->scratch->pairs;
+	std::vector<std::vector<NarrowphaseResult>>& buffers = ps->scratch->buffers;
+	std::vector<NarrowphaseResult>& merged = ps->scratch->merged;
+	std::vector<PrimitiveShape>& shapes = ps->scratch->shapes;
+	
+	ps->islandParent.resize(tuples.size());
+	forI(tuples.size()) ps->islandParent[i] = i;
+	ps->scratch->sleepersValid = false;
+	ps->contactCache.BeginStep();
+	TIMER_START(stage);
+	
+	//dynamic vs dynamic and dynamic vs static pairs, each pair only once
+	//sleeping bodies dont query, so pairs with them are always handled by the awake body
+	//this stays serial since it wakes islands and joins touching bodies into islands
+	pairs.clear();
+	for(u32 i = 0; i < tuples.size(); ++i){
+		PhysicsTuple& t = tuples[i];
+		if(!t.collider || t.collider->noCollide || t.collider->broadphaseProxy == AABBTREE_NULL || t.collider->broadphaseTree != BroadphaseTree_Dynamic || t.physics->sleeping) continue;
+		
+		auto gather = [&](AABBTree& tree, u32 proxy, b32 dedupe){
+			u32 j = tree.nodes[proxy].userdata;
+			PhysicsTuple& t2 = tuples[j];
+			if(dedupe && j <= i && !t2.physics->sleeping) return true;
+			if(t2.collider->noCollide) return true; //made a trigger since the last sync
+			ps->pairsTested++;
+			if(t.collider->collisionLayer != t2.collider->collisionLayer) return true;
+			
+			if(dedupe){
+				//touching an awake body wakes the sleeping island, and touching bodies share an island
+				//sleeping bodies arent refit, so their bounds are refreshed in case the tuples were rebuilt
+				if(t2.physics->sleeping) RefreshBounds(ps, j);
+				if(bounds[i].Overlaps(bounds[j])){
+					if(t2.physics->sleeping) WakeIsland(ps, t2.physics->sleepIsland);
+					ps->islandParent[IslandRoot(ps->islandParent, j)] = IslandRoot(ps->islandParent, i);
+				}
+			}
+			
+			ps->collisionCount++;
+			pairs.push_back(((u64)i << 32) | j);
+			return true;
+		};
+		ps->dynamicTree.Query(bounds[i], [&](u32 proxy){ return gather(ps->dynamicTree, proxy, true); });
+		ps->staticTree.Query (bounds[i], [&](u32 proxy){ return gather(ps->staticTree, proxy, false); });
+	}
+	
+	ps->stageTimes[PhysicsStage_Broadphase] = TIMER_END(stage);
+	TIMER_RESET(stage);
+	
+	//narrowphase over the pairs, batches run on the job system and each writes only to its own buffer
+	const u32 batchSize = 64;
+	u32 batchCount = (pairs.size() + batchSize - 1) / batchSize;
+	if(buffers.size() < batchCount){
+		//a batch makes at most one result per pair, so reserving that keeps a buffer from growing as pairs shift between batches
+		u32 first = buffers.size();
+		buffers.resize(batchCount);
+		for(u32 i = first; i < batchCount; ++i) buffers[i].reserve(batchSize);
+	}
+	b32 primitives = ps->simdNarrowphase && (ps->collisionMode == CollisionDetectionMode::DISCRETE || ps->collisionMode == CollisionDetectionMode::CONTINUOUS);
+	auto narrowphase = [&](u32 start, u32 end){
+		std::vector<NarrowphaseResult>& buffer = buffers[start / batchSize];
+		buffer.clear();
+		auto test = [&](u64 pair){
+			NarrowphaseResult result;
+			result.key        = pair;
+			result.overlap    = false;
+			result.pointCount = 0;
+			result.found      = CheckCollision(result, tuples[pair >> 32], tuples[pair & 0xFFFFFFFF], ps->collisionMode);
+			if(result.overlap || result.found) buffer.push_back(result);
+		};
+		if(!primitives){
+			for(u32 n = start; n < end; ++n) test(pairs[n]);
+			return;
+		}
+		
+		//the broadphase pushes the pairs of a body together, a body split across batches is just run as two
+		for(u32 n = start; n < end;){
+			u32 run = n + 1;
+			while(run < end && (pairs[run] >> 32) == (pairs[n] >> 32)) run++;
+			PrimitivePairs(shapes, bounds, &pairs[n], run - n, test);
+			n = run;
+		}
+	};
+	if(ps->parallelNarrowphase){
+		parallel_for(pairs.size(), batchSize, narrowphase);
+	}else{
+		forI(batchCount) narrowphase(i * batchSize, Min((u32)pairs.size(), (i+1) * batchSize));
+	}
+	
+	//merge sorted by pair so the result is the same however the batches were split between threads
+	merged.clear();
+	forI(batchCount) merged.insert(merged.end(), buffers[i].begin(), buffers[i].end());
+	std::sort(merged.begin(), merged.end(), [](const NarrowphaseResult& a, const NarrowphaseResult& b){ return a.key < b.key; });
+	ps->scratch->lastEventPairs.swap(ps->scratch->eventPairs);
+	ps->scratch->eventPairs.clear();
+	for(NarrowphaseResult& r : merged) MergeNarrowphaseResult(ps, r);
+	std::sort(ps->scratch->eventPairs.begin(), ps->scratch->eventPairs.end(), ColliderPairLess);
+	
+	ps->stageTimes[PhysicsStage_Narrowphase] = TIMER_END(stage);
+	TIMER_RESET(stage);
+	
+	//pairs that stopped touching are dropped, the rest are solved together with last step's impulses
+	ps->contactCache.EndStep();
+	ContactSolverParams params{ps->solverIterations, ps->warmStarting, ps->positionCorrection, ps->penetrationSlop, ps->restitutionThreshold};
+	SolveContacts(ps->contactCache, params);
+	RecordContacts(ps, tuples);
+	ps->stageTimes[PhysicsStage_Solve] = TIMER_END(stage);
+}
+
+////////////////////
+//// continuous ////
+////////////////////
+
+//bodies that are swept this step, either marked continuous or fast enough in CONTINUOUS mode
+inline b32 NeedsSweep(PhysicsWorld* ps, PhysicsTuple& t, Vector3 motion){
+	if(!t.collider || t.collider->noCollide || t.physics->staticPosition || t.physics->sleeping || t.physics->twoDphys) return false;
+	if(t.physics->continuous) return true;
+	return ps->collisionMode == CollisionDetectionMode::CONTINUOUS && motion.mag() > ps->ccdVelocity * ps->deltaTime;
+}
+
+//conservative advancement of swept bodies from where they started the step to where they were integrated to
+//a body that would reach something is moved back to just past its first time of impact, so the discrete
+//narrowphase finds the contact at the slop depth and the solver stops it there instead of it tunneling
+inline void SweepBodies(PhysicsWorld* ps, std::vector<PhysicsTuple>& tuples){
+	ps->ccdBodies = 0;
+	ps->ccdHits   = 0;
+	if(ps->collisionMode == CollisionDetectionMode::NONE) return;
+	
+	for(u32 i = 0; i < tuples.size(); ++i){
+		PhysicsTuple& t = tuples[i];
+		Vector3 motion = t.physics->position - ps->stepStart[i];
+		if(!NeedsSweep(ps, t, motion)) continue;
+		AABB end;
+		if(!ColliderAABB(t, end)) continue;
+		
+		//each convex piece of the body is swept on its own and the earliest hit of any of them stops the body
+		AABB swept = AABB::Union(end, AABB(end.min - motion, end.max - motion));
+		f32 toi = 1;
+		b32 convex = false;
+		ColliderConvexShapes(t.physics, t.collider, [&](ConvexShape& shape){
+			convex = true;
+			
+			//shapes are built where the bodies ended up, so they are moved back to where they started
+			shape.Translate(-motion);
+			auto sweep = [&](AABBTree& tree, u32 proxy){
+				u32 j = tree.nodes[proxy].userdata;
+				PhysicsTuple& t2 = tuples[j];
+				if(j == i || t2.collider->noCollide || t.collider->collisionLayer != t2.collider->collisionLayer) return true;
+				
+				Vector3 otherMotion = t2.physics->position - ps->stepStart[j];
+				if(TriangleBVH* bvh = ColliderTriangles(t2, t.collider)){
+					//triangles the sweep relative to the mesh passes over, taken where the mesh started
+					Matrix4 transform = Matrix4::TransformationMatrix(ps->stepStart[j], t2.physics->rotation, BodyScale(t2.physics));
+					Vector3 relative = motion - otherMotion;
+					AABB start = ConvexShapeAABB(shape);
+					AABB bounds = TransformAABB(AABB::Union(start, AABB(start.min + relative, start.max + relative)), transform.Inverse());
+					bvh->Query(bounds, [&](u32 index){
+						const Vector3* p = bvh->TriangleVertices(index);
+						ConvexShape triangle = ConvexShape::FromTriangle(p[0] * transform, p[1] * transform, p[2] * transform);
+						toi = Min(toi, ConvexTimeOfImpact(shape, motion, triangle, otherMotion, ps->ccdTolerance, ps->ccdMaxIterations));
+						return true;
+					});
+					return true;
+				}
+				
+				ColliderConvexShapes(t2.physics, t2.collider, [&](ConvexShape& other){
+					other.Translate(-otherMotion);
+					toi = Min(toi, ConvexTimeOfImpact(shape, motion, other, otherMotion, ps->ccdTolerance, ps->ccdMaxIterations));
+					return true;
+				});
+				return true;
+			};
+			ps->dynamicTree.Query(swept, [&](u32 proxy){ return sweep(ps->dynamicTree, proxy); });
+			ps->staticTree.Query (swept, [&](u32 proxy){ return sweep(ps->staticTree, proxy); });
+			return true;
+		});
+		if(!convex) continue;
+		ps->ccdBodies++;
+		if(toi >= 1) continue;
+		
+		f32 length = motion.mag();
+		f32 travel = Min(length * toi + ps->ccdTolerance + ps->penetrationSlop, length);
+		t.physics->position = ps->stepStart[i] + motion * (travel / length);
+		ps->ccdHits++;
+	}
+}
+
+//////////////////
+//// triggers ////
+//////////////////
+
+//what a trigger tests bodies against, pairs of spheres, AABBs, and boxes have closed form tests and everything
+//else goes through GJK alone, since only whether they overlap matters
+struct TriggerVolume{
+	ColliderType type;
+	AABB bounds;       //exact for AABBs
+	Vector3 center;    //spheres
+	f32 radius;
+	ConvexShape shape; //boxes
+	PhysicsTuple* tuple; //the trigger, whose convex pieces are what GJK tests
+};
+
+inline b32 MakeTriggerVolume(PhysicsTuple& t, TriggerVolume& out){
+	out.type  = t.collider->type;
+	out.tuple = &t;
+	if(!ColliderAABB(t, out.bounds)) return false;
+	if(out.type == ColliderType_Sphere){
+		out.center = t.physics->position;
+		out.radius = ((SphereCollider*)t.collider)->radius;
+	}
+	return ColliderConvexShape(t.physics, t.collider, out.shape);
+}
+
+//distance from the sphere's center to the box in the box's frame
+inline b32 SphereOverlapsBox(Vector3 center, f32 radius, ConvexShape& box){
+	Vector3 offset = center - box.center;
+	f32 half[3] = {box.halfDims.x, box.halfDims.y, box.halfDims.z};
+	f32 distanceSq = 0;
+	forI(3){
+		Vector3 axis(box.transform.data[4*i+0], box.transform.data[4*i+1], box.transform.data[4*i+2]);
+		f32 outside = fabs(offset.dot(axis)) - half[i];
+		if(outside > 0) distanceSq += outside * outside;
+	}
+	return distanceSq < radius * radius;
+}
+
+//separating axis test over the AABB's axes, the box's axes, and the nine cross products of them
+//r[i][j] is world axis i dotted with box axis j, the epsilon keeps the cross products of near parallel axes from
+//finding a separation that isnt there
+inline b32 BoxOverlapsAABB(ConvexShape& box, const AABB& aabb){
+	Vector3 center = (aabb.min + aabb.max) / 2.f;
+	Vector3 offset = box.center - center;
+	f32 e[3] = {aabb.max.x - center.x, aabb.max.y - center.y, aabb.max.z - center.z};
+	f32 h[3] = {box.halfDims.x, box.halfDims.y, box.halfDims.z};
+	f32 t[3] = {offset.x, offset.y, offset.z};
+	f32 r[3][3], absR[3][3];
+	forX(i, 3) forX(j, 3){
+		r[i][j]    = box.transform.data[4*j+i];
+		absR[i][j] = fabs(r[i][j]) + 1e-6f;
+	}
+	
+	forX(i, 3){
+		if(fabs(t[i]) > e[i] + h[0]*absR[i][0] + h[1]*absR[i][1] + h[2]*absR[i][2]) return false;
+	}
+	forX(j, 3){
+		f32 distance = fabs(t[0]*r[0][j] + t[1]*r[1][j] + t[2]*r[2][j]);
+		if(distance > e[0]*absR[0][j] + e[1]*absR[1][j] + e[2]*absR[2][j] + h[j]) return false;
+	}
+	forX(i, 3) forX(j, 3){
+		u32 i1 = (i+1)%3, i2 = (i+2)%3, j1 = (j+1)%3, j2 = (j+2)%3;
+		f32 ra = e[i1]*absR[i2][j] + e[i2]*absR[i1][j];
+		f32 rb = h[j1]*absR[i][j2] + h[j2]*absR[i][j1];
+		if(fabs(t[i2]*r[i1][j] - t[i1]*r[i2][j]) > ra + rb) return false;
+	}
+	return true;
+}
+
+//spheres and AABBs use the same comparisons as their narrowphase tests, so a trigger overlaps whatever would have
+//collided with it
+inline b32 TriggerVolumeOverlaps(TriggerVolume& volume, PhysicsTuple& t){
+	switch(t.collider->type){
+		case(ColliderType_Sphere):{
+			Vector3 center = t.physics->position;
+			f32 radius = ((SphereCollider*)t.collider)->radius;
+			switch(volume.type){
+				case(ColliderType_Sphere): return volume.radius + radius > (center - volume.center).mag();
+				case(ColliderType_AABB):{
+					Vector3 closest(Max(volume.bounds.min.x, Min(center.x, volume.bounds.max.x)),
+									Max(volume.bounds.min.y, Min(center.y, volume.bounds.max.y)),
+									Max(volume.bounds.min.z, Min(center.z, volume.bounds.max.z)));
+					return (center - closest).mag() < radius;
+				}
+				case(ColliderType_Box): return SphereOverlapsBox(center, radius, volume.shape);
+			}
+		}break;
+		case(ColliderType_AABB):{
+			AABB box;
+			ColliderAABB(t, box);
+			switch(volume.type){
+				case(ColliderType_Sphere):{
+					Vector3 closest(Max(box.min.x, Min(volume.center.x, box.max.x)),
+									Max(box.min.y, Min(volume.center.y, box.max.y)),
+									Max(box.min.z, Min(volume.center.z, box.max.z)));
+					return (volume.center - closest).mag() < volume.radius;
+				}
+				case(ColliderType_AABB): return volume.bounds.Overlaps(box);
+				case(ColliderType_Box):  return BoxOverlapsAABB(volume.shape, box);
+			}
+		}break;
+		case(ColliderType_Box):{
+			if(volume.type != ColliderType_Sphere && volume.type != ColliderType_AABB) break;
+			ConvexShape box;
+			ColliderConvexShape(t.physics, t.collider, box);
+			return (volume.type == ColliderType_Sphere) ? SphereOverlapsBox(volume.center, volume.radius, box) : BoxOverlapsAABB(box, volume.bounds);
+		}
+	}
+	
+	b32 overlap = false;
+	ColliderConvexShapes(volume.tuple->physics, volume.tuple->collider, [&](ConvexShape& piece){
+		ColliderShapes(t, volume.bounds, [&](ConvexShape& other){
+			GJKSimplex simplex;
+			overlap = GJKDistance(piece, other, simplex) <= 0;
+			return !overlap;
+		});
+		return !overlap;
+	});
+	return overlap;
+}
+
+inline b32 TriggerOverlapLess(const TriggerOverlap& a, const TriggerOverlap& b){
+	return (a.triggerKey != b.triggerKey) ? a.triggerKey < b.triggerKey : a.otherKey < b.otherKey;
+}
+
+//tests every trigger in the trigger tree against the bodies in its bounds and diffs the overlaps against last step's,
+//appending the changes to the events and returning where this step's start
+//static triggers only look at the dynamic tree, since static bodies cant move into them
+inline u32 TriggerTick(PhysicsWorld* ps, std::vector<PhysicsTuple>& tuples){
+	std::vector<TriggerOverlap>& overlaps = ps->triggerOverlaps;
+	std::vector<TriggerOverlap>& last = ps->scratch->lastTriggerOverlaps;
+	std::vector<TriggerEvent>& events = ps->triggerEvents;
+	u32 first = events.size();
+	last.swap(overlaps);
+	overlaps.clear();
+	ps->triggerTests = 0;
+	
+	for(u32 i = 0; i < tuples.size() && ps->collisionMode != CollisionDetectionMode::NONE; ++i){
+		PhysicsTuple& t = tuples[i];
+		if(!t.collider || !t.collider->noCollide || t.collider->broadphaseProxy == AABBTREE_NULL || t.collider->broadphaseTree != BroadphaseTree_Trigger) continue;
+		TriggerVolume volume;
+		if(!MakeTriggerVolume(t, volume)) continue;
+		
+		auto test = [&](AABBTree& tree, u32 proxy){
+			PhysicsTuple& t2 = tuples[tree.nodes[proxy].userdata];
+			if(t2.collider->noCollide || t.collider->collisionLayer != t2.collider->collisionLayer) return true;
+			ps->triggerTests++;
+			if(TriggerVolumeOverlaps(volume, t2)) overlaps.push_back(TriggerOverlap{t.collider, t2.collider, t.collider->Key(), t2.collider->Key()});
+			return true;
+		};
+		ps->dynamicTree.Query(volume.bounds, [&](u32 proxy){ return test(ps->dynamicTree, proxy); });
+		if(!t.physics->staticPosition) ps->staticTree.Query(volume.bounds, [&](u32 proxy){ return test(ps->staticTree, proxy); });
+	}
+	std::sort(overlaps.begin(), overlaps.end(), TriggerOverlapLess);
+	
+	//pairs that left the world since last step may have been deleted, so they only exit if both colliders are still in it
+	//a collider given a deleted one's memory has another key, so it enters instead of taking over the old pair
+	std::vector<u64>& live = ps->scratch->liveColliders;
+	b32 liveSorted = false;
+	auto isLive = [&](u64 key){
+		if(!liveSorted){
+			live.clear();
+			for(PhysicsTuple& t : tuples) if(t.collider) live.push_back(t.collider->Key());
+			std::sort(live.begin(), live.end());
+			liveSorted = true;
+		}
+		return std::binary_search(live.begin(), live.end(), key);
+	};
+	
+	//both sets are sorted, so walking them together splits them into what entered, stayed, and exited
+	u32 a = 0, b = 0;
+	while(a < overlaps.size() || b < last.size()){
+		if(b == last.size() || (a < overlaps.size() && TriggerOverlapLess(overlaps[a], last[b]))){
+			events.push_back(TriggerEvent{overlaps[a].trigger, overlaps[a].other, TriggerState_Enter});
+			a++;
+		}else if(a == overlaps.size() || TriggerOverlapLess(last[b], overlaps[a])){
+			if(isLive(last[b].triggerKey) && isLive(last[b].otherKey)) events.push_back(TriggerEvent{last[b].trigger, last[b].other, TriggerState_Exit});
+			b++;
+		}else{
+			events.push_back(TriggerEvent{overlaps[a].trigger, overlaps[a].other, TriggerState_Stay});
+			a++; b++;
+		}
+	}
+	return first;
+}
+
+//entering and leaving a trigger send both colliders' events, so a toggle like a light's is undone on the way out
+//staying only shows up in the world's events, sending it every step would toggle every step
+inline void SendTriggerEvents(PhysicsWorld* ps, u32 first){
+	for(u32 i = first; i < ps->triggerEvents.size(); ++i){
+		TriggerEvent& e = ps->triggerEvents[i];
+		if(e.state == TriggerState_Stay) continue;
+		if(e.trigger->event != Event_NONE && e.trigger->sender) e.trigger->sender->SendEvent(e.trigger->event);
+		if(e.other->event   != Event_NONE && e.other->sender)   e.other->sender->SendEvent(e.other->event);
+	}
+}
+
+//////////////////
+//// sleeping ////
+//////////////////
+
+//static bodies, the player, and 2D bodies are never put to sleep
+inline b32 CanSleep(PhysicsWorld* ps, PhysicsTuple& t){
+	return !t.physics->staticPosition && !t.physics->twoDphys && !IsPlayer(ps, t.physics);
+}
+
+void WakeEditedBodies(PhysicsWorld* ps){
+	ps->scratch->sleepersValid = false;
+	for(PhysicsTuple& t : ps->tuples){
+		if(!t.physics->sleeping) continue;
+		if(!ps->sleepEnabled || t.physics->position != t.physics->sleepPosition || t.physics->rotation != t.physics->sleepRotation){
+			WakeIsland(ps, t.physics->sleepIsland);
+		}
+	}
+}
+
+//advances sleep timers and puts islands to sleep once every body in them has been slow for long enough
+inline void UpdateSleeping(PhysicsWorld* ps, std::vector<PhysicsTuple>& tuples){
+	std::vector<u8>&  islandAwake = ps->scratch->islandAwake;
+	std::vector<u32>& islandIds   = ps->scratch->islandIds;
+	islandAwake.assign(tuples.size(), 0);
+	islandIds.assign(tuples.size(), u32(-1));
+	
+	ps->sleepingCount = 0;
+	for(u32 i = 0; i < tuples.size(); ++i){
+		Physics* p = tuples[i].physics;
+		if(p->sleeping){ ps->sleepingCount++; continue; }
+		u32 root = IslandRoot(ps->islandParent, i);
+		if(!ps->sleepEnabled || !CanSleep(ps, tuples[i])){ islandAwake[root] = 1; continue; }
+		
+		if(p->velocity.mag() < ps->sleepVelocity && fabs(p->rotVelocity.x) < ps->sleepRotVelocity &&
+		   fabs(p->rotVelocity.y) < ps->sleepRotVelocity && fabs(p->rotVelocity.z) < ps->sleepRotVelocity){
+			p->sleepTimer += ps->deltaTime;
+		}else{
+			p->sleepTimer = 0;
+		}
+		if(p->sleepTimer < ps->sleepTime) islandAwake[root] = 1;
+	}
+	if(!ps->sleepEnabled) return;
+	
+	for(u32 i = 0; i < tuples.size(); ++i){
+		Physics* p = tuples[i].physics;
+		if(p->sleeping || !CanSleep(ps, tuples[i])) continue;
+		u32 root = IslandRoot(ps->islandParent, i);
+		if(islandAwake[root]) continue;
+		if(islandIds[root] == u32(-1)) islandIds[root] = ps->sleepIslandCount++;
+		
+		p->sleeping        = true;
+		p->sleepIsland     = islandIds[root];
+		p->sleepPosition   = p->position;
+		p->sleepRotation   = p->rotation;
+		p->velocity        = Vector3::ZERO;
+		p->acceleration    = Vector3::ZERO;
+		p->rotVelocity     = Vector3::ZERO;
+		p->rotAcceleration = Vector3::ZERO;
+		p->netForce        = Vector3::ZERO;
+		p->lodTicks        = 0;
+		ps->sleepingCount++;
+	}
+}
+
+////////////////////
+//// fixed step ////
+////////////////////
+
+void PhysicsStep(PhysicsWorld* ps){
+	std::vector<PhysicsTuple>& tuples = ps->tuples;
+	std::vector<AABB>& bounds = ps->bounds;
+	u64 allocations = ThreadHeapAllocations();
+	ps->stepArena ^= 1;
+	ps->stepArenas[ps->stepArena].Reset();
+	ps->collisionCount = 0;
+	ps->pairsTested = 0;
+	ps->pairsFound = 0;
+	ps->stepStart.resize(tuples.size());
+	forI(tuples.size()) ps->stepStart[i] = tuples[i].physics->position;
+	TIMER_START(stage);
+	AssignLODTiers(ps, tuples, bounds);
+	ps->stageTimes[PhysicsStage_LOD] = TIMER_END(stage); TIMER_RESET(stage);
+	IntegrateBodies(ps, tuples);
+	ps->stageTimes[PhysicsStage_Integrate] = TIMER_END(stage); TIMER_RESET(stage);
+	SweepBodies(ps, tuples);
+	ps->stageTimes[PhysicsStage_Sweep] = TIMER_END(stage); TIMER_RESET(stage);
+	RefitBroadphase(ps, tuples, bounds);
+	ps->stageTimes[PhysicsStage_Refit] = TIMER_END(stage);
+	CollisionTick(ps, tuples, bounds); //times the broadphase, narrowphase, and solve stages itself
+	TIMER_RESET(stage);
+	u32 firstTriggerEvent = TriggerTick(ps, tuples);
+	ps->stageTimes[PhysicsStage_Triggers] = TIMER_END(stage); TIMER_RESET(stage);
+	UpdateSleeping(ps, tuples);
+	ps->stageTimes[PhysicsStage_Sleep] = TIMER_END(stage);
+	SendTriggerEvents(ps, firstTriggerEvent);
+	ps->totalTime += ps->deltaTime;
+	ps->stepCount++;
+	ps->stepAllocations = u32(ThreadHeapAllocations() - allocations);
+}
+
+/////////////////
+//// queries ////
+/////////////////
+
+//the tuple behind a proxy if the query looks at its collider
+//proxies are checked against the tuples since the tuples can be rebuilt before the broadphase is synced again
+inline PhysicsTuple* QueryTuple(std::vector<PhysicsTuple>& tuples, AABBTree& tree, BroadphaseTree which, u32 proxy, u32 layerMask, b32 hitTriggers){
+	u32 index = tree.nodes[proxy].userdata;
+	if(index >= tuples.size()) return 0;
+	PhysicsTuple& t = tuples[index];
+	if(!t.collider || t.collider->broadphaseProxy != proxy || t.collider->broadphaseTree != which) return 0;
+	if(t.collider->collisionLayer >= 32 || !(layerMask & (1 << t.collider->collisionLayer))) return 0;
+	if(t.collider->noCollide && !hitTriggers) return 0;
+	return &t;
+}
+
+//slab test against a box centered on the origin, normal is the face the ray went in through
+inline b32 RayBox(Vector3 origin, Vector3 direction, Vector3 halfDims, f32& distance, Vector3& normal){
+	f32 o[3] = {origin.x, origin.y, origin.z};
+	f32 d[3] = {direction.x, direction.y, direction.z};
+	f32 h[3] = {halfDims.x, halfDims.y, halfDims.z};
+	f32 enter = 0, exit = distance;
+	s32 axis = -1;
+	forI(3){
+		if(fabs(d[i]) < 1e-9f){
+			if(fabs(o[i]) > h[i]) return false;
+			continue;
+		}
+		f32 t0 = (-h[i] - o[i]) / d[i], t1 = (h[i] - o[i]) / d[i];
+		if(t0 > t1) std::swap(t0, t1);
+		if(t0 > enter){ enter = t0; axis = i; }
+		exit = Min(exit, t1);
+		if(enter > exit) return false;
+	}
+	distance = enter;
+	if(axis == -1){
+		normal = -direction; //started inside
+	}else{
+		f32 n[3] = {0, 0, 0};
+		n[axis] = (d[axis] > 0) ? -1.f : 1.f;
+		normal = Vector3(n[0], n[1], n[2]);
+	}
+	return true;
+}
+
+//exact ray test against the tuple's collider, shortens distance on a hit closer than it
+inline b32 RayCollider(PhysicsTuple& t, Vector3 origin, Vector3 direction, f32& distance, Vector3& normal){
+	Physics* p = t.physics;
+	Vector3 scale = BodyScale(t.physics);
+	switch(t.collider->type){
+		case(ColliderType_Sphere):{
+			f32 r = ((SphereCollider*)t.collider)->radius;
+			Vector3 m = origin - p->position;
+			f32 b = m.dot(direction);
+			f32 c = m.dot(m) - r*r;
+			if(c > 0 && b > 0) return false; //outside and pointing away
+			f32 discriminant = b*b - c;
+			if(discriminant < 0) return false;
+			f32 hit = Max(-b - sqrtf(discriminant), 0.f);
+			if(hit > distance) return false;
+			distance = hit;
+			normal = (c > 0) ? (origin + direction * hit - p->position) / r : -direction;
+		}return true;
+		case(ColliderType_AABB):{
+			return RayBox(origin - p->position, direction, ((AABBCollider*)t.collider)->halfDims * scale, distance, normal);
+		}
+		case(ColliderType_Box):{
+			Matrix4 rotation = Matrix4::RotationMatrix(p->rotation);
+			Matrix4 inverse  = rotation.Transpose();
+			if(!RayBox((origin - p->position) * inverse, direction * inverse, ((BoxCollider*)t.collider)->halfDims * scale, distance, normal)) return false;
+			normal = normal * rotation;
+		}return true;
+		case(ColliderType_Complex):
+		case(ColliderType_Landscape):{
+			//the ray is moved into the mesh's space without renormalizing so distances along it stay the same
+			Matrix4 transform = Matrix4::TransformationMatrix(p->position, p->rotation, scale);
+			Matrix4 inverse   = transform.Inverse();
+			Vector3 localOrigin = origin * inverse;
+			Vector3 localDirection = (origin + direction) * inverse - localOrigin;
+			f32 hit = distance;
+			Vector3 v[3];
+			b32 inside = false;
+			if(t.collider->type == ColliderType_Complex && ((ComplexCollider*)t.collider)->hulls.size()){
+				//the closest hull the ray enters, one it starts inside of is hit right away
+				b32 found = false;
+				for(ConvexHull& hull : ((ComplexCollider*)t.collider)->hulls){
+					u32 face;
+					if(!hull.Raycast(localOrigin, localDirection, hit, &face)) continue;
+					found  = true;
+					inside = (face == (u32)-1);
+					if(!inside) forI(3) v[i] = hull.vertices[hull.indices[3*face+i]];
+				}
+				if(!found) return false;
+			}else{
+				TriangleBVH* bvh = ColliderTriangles(t, 0);
+				if(!bvh) return false;
+				u32 triangle;
+				if(!bvh->Raycast(localOrigin, localDirection, hit, &triangle)) return false;
+				forI(3) v[i] = bvh->TriangleVertices(triangle)[i];
+			}
+			
+			if(inside){
+				normal = -direction;
+			}else{
+				Vector3 e1 = v[1] * transform - v[0] * transform;
+				Vector3 e2 = v[2] * transform - v[0] * transform;
+				normal = Vector3(e1.y*e2.z - e1.z*e2.y, e1.z*e2.x - e1.x*e2.z, e1.x*e2.y - e1.y*e2.x).normalized();
+				if(normal.dot(direction) > 0) normal = -normal;
+			}
+			distance = hit;
+		}return true;
+	}
+	return false;
+}
+
+//walks the tree with every ray of the packet at once, going into the nodes any of them still reach
+//hits shorten their ray's maxT so the rest of the walk skips what is behind them
+inline void RaycastPacket(std::vector<PhysicsTuple>& tuples, AABBTree& tree, BroadphaseTree which, RayPacket& packet, const PhysicsRay* rays, RaycastHit* hits){
+	if(tree.root == AABBTREE_NULL) return;
+	u32 stack[256]; u32 count = 0;
+	stack[count++] = tree.root;
+	while(count){
+		u32 index = stack[--count];
+		AABBTreeNode& node = tree.nodes[index];
+		u32 lanes = RayPacketAABBSIMD(packet, node.aabb);
+		if(!lanes) continue;
+		if(!node.IsLeaf()){
+#if DESHI_SLOW
+			Assert(count + 2 <= ArrayCount(stack), "raycast stack overflow");
+#endif
+			stack[count++] = node.left;
+			stack[count++] = node.right;
+			continue;
+		}
+		
+		for(u32 lane = 0; lane < RAY_PACKET_WIDTH; ++lane){
+			if(!(lanes & (1 << lane))) continue;
+			const PhysicsRay& ray = rays[lane];
+			PhysicsTuple* t = QueryTuple(tuples, tree, which, index, ray.layerMask, ray.hitTriggers);
+			if(!t) continue;
+			f32 distance = packet.maxT[lane];
+			Vector3 normal;
+			if(!RayCollider(*t, ray.origin, ray.direction, distance, normal)) continue;
+			packet.maxT[lane]     = distance;
+			hits[lane].entity     = t->physics->entity; //0 for bodies that arent on an entity
+			hits[lane].collider   = t->collider;
+			hits[lane].point      = ray.origin + ray.direction * distance;
+			hits[lane].normal     = normal;
+			hits[lane].distance   = distance;
+		}
+	}
+}
+
+//calls fn(tuple) for every collider the query looks at whose proxy overlaps the aabb
+template<class F>
+inline void QueryColliders(PhysicsWorld* ps, std::vector<PhysicsTuple>& tuples, const AABB& aabb, u32 layerMask, b32 hitTriggers, F fn){
+	ps->dynamicTree.Query(aabb, [&](u32 proxy){
+		if(PhysicsTuple* t = QueryTuple(tuples, ps->dynamicTree, BroadphaseTree_Dynamic, proxy, layerMask, hitTriggers)) fn(*t);
+		return true;
+	});
+	ps->staticTree.Query(aabb, [&](u32 proxy){
+		if(PhysicsTuple* t = QueryTuple(tuples, ps->staticTree, BroadphaseTree_Static, proxy, layerMask, hitTriggers)) fn(*t);
+		return true;
+	});
+	if(!hitTriggers) return;
+	ps->triggerTree.Query(aabb, [&](u32 proxy){
+		if(PhysicsTuple* t = QueryTuple(tuples, ps->triggerTree, BroadphaseTree_Trigger, proxy, layerMask, hitTriggers)) fn(*t);
+		return true;
+	});
+}
+
+//conservative advancement of the shape along the direction against everything its sweep passes over
+inline b32 ShapeCast(PhysicsWorld* ps, ConvexShape& shape, Vector3 direction, f32 maxDistance, RaycastHit& hit, u32 layerMask, b32 hitTriggers){
+	std::vector<PhysicsTuple>& tuples = ps->tuples;
+	hit = RaycastHit{};
+	Vector3 motion = direction * maxDistance;
+	AABB start = ConvexShapeAABB(shape);
+	AABB swept = AABB::Union(start, AABB(start.min + motion, start.max + motion));
+	
+	f32 closest = 1;
+	ConvexShape closestShape;
+	QueryColliders(ps, tuples, swept, layerMask, hitTriggers, [&](PhysicsTuple& t){
+		ColliderShapes(t, swept, [&](ConvexShape& other){
+			GJKSimplex simplex;
+			f32 toi = (GJKDistance(shape, other, simplex) <= 0) ? 0 : ConvexTimeOfImpact(shape, motion, other, Vector3::ZERO, ps->ccdTolerance, ps->ccdMaxIterations);
+			if(toi >= closest) return true;
+			closest      = toi;
+			closestShape = other;
+			hit.entity   = t.physics->entity;
+			hit.collider = t.collider;
+			return true;
+		});
+	});
+	if(!hit.collider) return false;
+	
+	//the closest points where the shape stopped give the point and normal, a shape that started inside has neither
+	hit.distance = maxDistance * closest;
+	ConvexShape moved = shape;
+	moved.Translate(motion * closest);
+	GJKSimplex simplex;
+	Vector3 closestA, closestB;
+	if(closest > 0 && GJKDistance(moved, closestShape, simplex, &closestA, &closestB) > 0){
+		hit.point  = closestB;
+		hit.normal = (closestA - closestB).normalized();
+	}else{
+		hit.point  = moved.center;
+		hit.normal = -direction;
+	}
+	return true;
+}
+
+inline u32 ShapeOverlap(PhysicsWorld* ps, ConvexShape& shape, std::vector<Collider*>& out, u32 layerMask, b32 hitTriggers){
+	std::vector<PhysicsTuple>& tuples = ps->tuples;
+	AABB bounds = ConvexShapeAABB(shape);
+	u32 count = 0;
+	QueryColliders(ps, tuples, bounds, layerMask, hitTriggers, [&](PhysicsTuple& t){
+		b32 overlap = false;
+		ColliderShapes(t, bounds, [&](ConvexShape& other){
+			GJKSimplex simplex;
+			overlap = GJKDistance(shape, other, simplex) <= 0;
+			return !overlap;
+		});
+		if(!overlap) return;
+		out.push_back(t.collider);
+		count++;
+	});
+	return count;
+}
+
+b32 PhysicsWorld::Raycast(Vector3 origin, Vector3 direction, f32 maxDistance, RaycastHit& hit, u32 layerMask, b32 hitTriggers){
+	PhysicsRay ray{origin, direction, maxDistance, layerMask, hitTriggers};
+	RaycastBatch(&ray, &hit, 1);
+	return hit.collider != 0;
+}
+
+void PhysicsWorld::RaycastBatch(const PhysicsRay* rays, RaycastHit* hits, u32 count){
+	SyncBodies();
+	u32 packets = (count + RAY_PACKET_WIDTH-1) / RAY_PACKET_WIDTH;
+	parallel_for(packets, 16, [&](u32 start, u32 end){
+		for(u32 packet = start; packet < end; ++packet){
+			u32 first = packet * RAY_PACKET_WIDTH;
+			RayPacket rayPacket;
+			RaycastHit packetHits[RAY_PACKET_WIDTH] = {};
+			forI(RAY_PACKET_WIDTH){
+				if(first + i < count){
+					rayPacket.Set(i, rays[first+i].origin, rays[first+i].direction, rays[first+i].maxDistance);
+				}else{
+					rayPacket.Clear(i);
+				}
+			}
+			b32 hitTriggers = false;
+			forI(RAY_PACKET_WIDTH) if(first + i < count && rays[first+i].hitTriggers) hitTriggers = true;
+			RaycastPacket(this->tuples, dynamicTree, BroadphaseTree_Dynamic, rayPacket, rays + first, packetHits);
+			RaycastPacket(this->tuples, staticTree,  BroadphaseTree_Static,  rayPacket, rays + first, packetHits);
+			if(hitTriggers) RaycastPacket(this->tuples, triggerTree, BroadphaseTree_Trigger, rayPacket, rays + first, packetHits);
+			for(u32 i = 0; i < RAY_PACKET_WIDTH && first + i < count; ++i) hits[first+i] = packetHits[i];
+		}
+	});
+}
+
+b32 PhysicsWorld::SphereCast(Vector3 origin, f32 radius, Vector3 direction, f32 maxDistance, RaycastHit& hit, u32 layerMask, b32 hitTriggers){
+	ConvexShape shape = ConvexShape::FromSphere(origin, radius);
+	SyncBodies();
+	return ShapeCast(this, shape, direction, maxDistance, hit, layerMask, hitTriggers);
+}
+
+b32 PhysicsWorld::BoxCast(Vector3 origin, Vector3 halfDims, Vector3 rotation, Vector3 direction, f32 maxDistance, RaycastHit& hit, u32 layerMask, b32 hitTriggers){
+	ConvexShape shape = ConvexShape::FromBox(origin, rotation, halfDims);
+	SyncBodies();
+	return ShapeCast(this, shape, direction, maxDistance, hit, layerMask, hitTriggers);
+}
+
+u32 PhysicsWorld::OverlapSphere(Vector3 center, f32 radius, std::vector<Collider*>& out, u32 layerMask, b32 hitTriggers){
+	ConvexShape shape = ConvexShape::FromSphere(center, radius);
+	SyncBodies();
+	return ShapeOverlap(this, shape, out, layerMask, hitTriggers);
+}
+
+u32 PhysicsWorld::OverlapBox(Vector3 center, Vector3 halfDims, Vector3 rotation, std::vector<Collider*>& out, u32 layerMask, b32 hitTriggers){
+	ConvexShape shape = ConvexShape::FromBox(center, rotation, halfDims);
+	SyncBodies();
+	return ShapeOverlap(this, shape, out, layerMask, hitTriggers);
+}
+
+/////////////////////////
+//// world functions ////
+/////////////////////////
+
+void PhysicsWorld::Init(f32 _deltaTime){
+	integrationMode = IntegrationMode::EULER;
+	collisionMode   = CollisionDetectionMode::CONTINUOUS;
+	
+	gravity        = 9.81;
+	frictionAir    = 0.01f; 
+	minVelocity    = 0.005f;
+	maxVelocity    = 100.f;
+	minRotVelocity = 1.f;
+	maxRotVelocity = 360.f;
+	
+	deltaTime   = _deltaTime;
+	totalTime   = 0;
+	stepCount   = 0;
+	syncPending = true;
+	player      = 0;
+	camera      = 0;
+	
+	broadphaseStamp = 0;
+	collisionCount  = 0;
+	pairsTested     = 0;
+	pairsFound      = 0;
+	triggerTests    = 0;
+	sleepingCount   = 0;
+	forI(PhysicsStage_COUNT) stageTimes[i] = 0;
+	
+	sleepEnabled     = true;
+	sleepVelocity    = 0.05f;
+	sleepRotVelocity = 2.f;
+	sleepTime        = 0.5f;
+	sleepIslandCount = 0;
+	
+	simdIntegration = true;
+	simdNarrowphase = false; //the broadphase hands most bodies too few candidates for the kernels to pay off
+	
+	lodEnabled       = true;
+	lodDistances[0]  = 50.f;
+	lodDistances[1]  = 100.f;
+	lodDistances[2]  = 200.f;
+	lodOffscreenTier = 1;
+	forI(PHYSICS_LOD_TIERS) lodCounts[i] = 0;
+	
+	ccdVelocity      = 10.f;
+	ccdTolerance     = 0.005f;
+	ccdMaxIterations = 20;
+	ccdBodies        = 0;
+	ccdHits          = 0;
+	
+	parallelNarrowphase = true;
+	
+	stepArenas[0].Init(Kilobytes(64));
+	stepArenas[1].Init(Kilobytes(64));
+	stepArena       = 0;
+	stepAllocations = 0;
+	
+	solverIterations     = 8;
+	warmStarting         = true;
+	positionCorrection   = 0.4f;
+	penetrationSlop      = 0.01f;
+	restitutionThreshold = 1.f;
+	
+	scratch = new PhysicsWorldScratch;
+}
+
+void PhysicsWorld::Cleanup(){
+	for(Collider* c : ownedColliders) delete c;
+	for(Physics* p : ownedPhysics) delete p;
+	ownedColliders.clear();
+	ownedPhysics.clear();
+	tuples.clear();
+	bounds.clear();
+	triggerOverlaps.clear();
+	triggerEvents.clear();
+	contactCache.Clear();
+	stepArenas[0].Free();
+	stepArenas[1].Free();
+	delete scratch;
+	scratch = 0;
+}
+
+u32 PhysicsWorld::AddBody(Physics* physics, Collider* collider){
+	ownedPhysics.push_back(physics);
+	if(collider) ownedColliders.push_back(collider);
+	tuples.push_back(PhysicsTuple(0, physics, collider));
+	syncPending = true;
+	return tuples.size()-1;
+}
+
+void PhysicsWorld::Step(u32 count){
+	SyncBodies();
+	if(syncPending){
+		SyncBroadphase(this);
+		WakeEditedBodies(this);
+		syncPending = false;
+	}
+	forI(count) PhysicsStep(this);
+}
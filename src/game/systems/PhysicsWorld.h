@@ -0,0 +1,208 @@
+#pragma once
+#ifndef SYSTEM_PHYSICS_WORLD_H
+#define SYSTEM_PHYSICS_WORLD_H
+
+#include "../../defines.h"
+#include "../../geometry/AABBTree.h"
+#include "../../utils/Arena.h"
+#include "PhysicsSolver.h"
+#include "PhysicsQuery.h"
+
+#include <vector>
+
+struct Transform;
+struct Physics;
+struct Collider;
+struct Camera;
+struct Entity;
+struct PhysicsWorldScratch;
+
+#define PHYSICS_LOD_TIERS 4 //tier n integrates every 2^n ticks
+
+//DISCRETE uses the dedicated sphere and AABB tests where they exist and GJK for the rest, GJK uses it for every pair
+//CONTINUOUS is DISCRETE plus sweeping every body faster than ccdVelocity
+enum struct CollisionDetectionMode {
+	DISCRETE, CONTINUOUS, GJK, NONE
+};
+
+enum struct IntegrationMode {
+	/*RK4, VERLET,*/ EULER
+};
+
+//stages of a step in the order they run, see PhysicsStep
+enum PhysicsStageBits : u32{
+	PhysicsStage_LOD, PhysicsStage_Integrate, PhysicsStage_Sweep, PhysicsStage_Refit,
+	PhysicsStage_Broadphase, PhysicsStage_Narrowphase, PhysicsStage_Solve, PhysicsStage_Triggers, PhysicsStage_Sleep, PhysicsStage_COUNT
+}; typedef u32 PhysicsStage;
+
+[[maybe_unused]] global_ const char* PhysicsStageStrings[] = {
+	"LOD", "Integrate", "Sweep", "Refit", "Broadphase", "Narrowphase", "Solve", "Triggers", "Sleep"
+};
+
+enum TriggerStateBits : u32{
+	TriggerState_Enter, TriggerState_Stay, TriggerState_Exit
+}; typedef u32 TriggerState;
+
+[[maybe_unused]] global_ const char* TriggerStateStrings[] = {
+	"Enter", "Stay", "Exit"
+};
+
+//a trigger and the collider of a body inside it
+//the pair is identified by the Collider::Keys, since a deleted collider's address goes to the next one of its type
+struct TriggerOverlap{
+	Collider* trigger;
+	Collider* other;
+	u64 triggerKey;
+	u64 otherKey;
+};
+
+struct TriggerEvent{
+	Collider* trigger;
+	Collider* other;
+	TriggerState state;
+};
+
+struct PhysicsTuple {
+	Transform* transform = nullptr; //0 for bodies that arent on an entity
+	Physics*   physics   = nullptr;
+	Collider*  collider  = nullptr;
+	PhysicsTuple(Transform* transform, Physics* physics, Collider* collider)
+		: transform(transform), physics(physics), collider(collider) {}
+};
+
+//a simulation of its own bodies with its own settings, broadphase, contacts, and scratch memory
+//stepping one only touches the world and its bodies, so worlds can step at the same time on different threads
+//the game's world is the PhysicsSystem, which fills the tuples from the admin's entities; standalone worlds own
+//bodies given to AddBody, which have no entity and use Physics::scale in place of the entity's transform
+//NOTE bodies are allocated from the component pools, which arent thread safe, so build and clean up worlds on one thread
+struct PhysicsWorld{
+	IntegrationMode integrationMode;
+	CollisionDetectionMode collisionMode;
+	f32 gravity;
+	f32 frictionAir; //TODO(delle,Ph) this should depend on object shape
+	f32 maxVelocity;
+	f32 minVelocity;
+	f32 maxRotVelocity; //per axis in degrees
+	f32 minRotVelocity;
+	
+	std::vector<PhysicsTuple> tuples;
+	std::vector<AABB> bounds; //of each tuple's collider after the last refit
+	f32 deltaTime;            //length of a step
+	f64 totalTime;            //seconds simulated
+	u64 stepCount;
+	b32 syncPending;          //bodies were added or moved from outside, the broadphase is synced before the next step
+	
+	//optional links to the game, a world without them has no player, no camera based LOD, and no 2D pass
+	Entity* player;  //never sleeps and is moved by its Movement instead of being integrated
+	Camera* camera;  //bodies are put in LOD tiers by their distance from it
+	
+	//broadphase, bodies with staticPosition go in the static tree so they never get refit
+	//triggers have a tree of their own so the bodies' queries never walk them
+	AABBTree staticTree;
+	AABBTree dynamicTree;
+	AABBTree triggerTree;
+	u32 broadphaseStamp;
+	
+	u32 collisionCount; //narrowphase checks last tick
+	u32 pairsTested;    //broadphase candidate pairs last tick
+	u32 pairsFound;     //candidate pairs the narrowphase resolved last tick
+	u32 sleepingCount;  //bodies asleep after the last tick
+	f64 stageTimes[PhysicsStage_COUNT]; //milliseconds each stage took last tick
+	
+	//bodies touching each other form an island, which sleeps once every body in it has stayed
+	//under the velocity thresholds for sleepTime seconds
+	b32 sleepEnabled;
+	f32 sleepVelocity;    //linear
+	f32 sleepRotVelocity; //per axis in degrees
+	f32 sleepTime;
+	u32 sleepIslandCount; //used to give each island that falls asleep a unique id
+	std::vector<u32> islandParent; //union-find over tuple indexes, rebuilt every tick
+	
+	b32 simdIntegration; //integrate linear movement through the SoA kernels in PhysicsIntegrator
+	b32 simdNarrowphase; //test spheres and AABBs against their sphere and AABB candidates through the kernels in PhysicsPrimitives
+	
+	//bodies far from the camera or outside its view go in coarser tiers that integrate every 2, 4 or 8 ticks
+	//over the time they skipped, collisions still run for them every tick and a body moving to a finer tier
+	//integrates what it skipped on the next tick so it doesnt jump
+	b32 lodEnabled;
+	f32 lodDistances[PHYSICS_LOD_TIERS-1]; //camera distances tiers 1 to 3 start at
+	u32 lodOffscreenTier;                  //least tier of bodies outside the camera's frustum, 0 to ignore the frustum
+	u32 lodCounts[PHYSICS_LOD_TIERS];      //awake bodies in each tier last tick
+	
+	//swept bodies are moved back to their time of impact with anything they would have passed through this step
+	//bodies with Physics::continuous are always swept, others only when faster than ccdVelocity in CONTINUOUS mode
+	f32 ccdVelocity;
+	f32 ccdTolerance;     //distance that counts as touching when advancing
+	u32 ccdMaxIterations;
+	u32 ccdBodies;        //bodies swept last tick
+	u32 ccdHits;          //swept bodies moved back last tick
+	std::vector<Vector3> stepStart; //positions before integrating, indexed like the tuples
+	
+	//colliders with noCollide are triggers, which skip the narrowphase and only get boolean overlap tests against
+	//the bodies the broadphase finds in their bounds; each step's overlaps are diffed against the last step's into
+	//enter, stay, and exit events, and enters and exits send the colliders' events once the step is done
+	//the events pile up over steps until whoever owns the world reads and clears them, PhysicsSystem does once a frame
+	std::vector<TriggerOverlap> triggerOverlaps; //pairs overlapping after the last step, sorted by trigger then other key
+	std::vector<TriggerEvent>   triggerEvents;   //changes in step order since last cleared, exits of deleted colliders are dropped
+	u32 triggerTests; //trigger vs body overlap tests last tick
+	
+	//narrowphase tests run on the job system, results are merged in pair order so they match the serial run bit for bit
+	b32 parallelNarrowphase;
+	
+	//data that only lives for a step comes from two arenas that swap at the start of each step, so what one step
+	//records (the per body contacts and manifolds) stays valid while the next one's movement and force stages read it
+	Arena stepArenas[2];
+	u32 stepArena;       //the one the current step allocates from
+	u32 stepAllocations; //heap allocations the last step made on the thread that ran it, 0 once the scene settles and the
+	                     //step's containers, the contact cache, and the arenas have stopped growing; they only grow
+	                     //on a step with more pairs or contacts than any before it (only counted with DESHI_INTERNAL)
+	
+	//touching pairs persist in the contact cache and are resolved together by a sequential impulse solver
+	ContactCache contactCache;
+	u32 solverIterations;
+	b32 warmStarting;
+	f32 positionCorrection;   //fraction of the penetration past the slop removed each step
+	f32 penetrationSlop;
+	f32 restitutionThreshold; //approach speed below which contacts dont bounce
+	
+	PhysicsWorldScratch* scratch; //vectors the stages reuse every step
+	std::vector<Physics*>  ownedPhysics;
+	std::vector<Collider*> ownedColliders;
+	
+	//sets the default settings, deltaTime is the length of a step
+	void Init(f32 deltaTime);
+	//frees the bodies the world owns and its scratch memory
+	void Cleanup();
+	
+	//gives the body to the world, which deletes it in Cleanup, the collider may be 0
+	//returns the body's tuple index
+	u32 AddBody(Physics* physics, Collider* collider);
+	
+	//runs count fixed steps
+	void Step(u32 count = 1);
+	
+	//scene queries go through the broadphase and see the bodies where the last step left them
+	//casts return the closest hit, directions are normalized and distances are in world units
+	b32 Raycast(Vector3 origin, Vector3 direction, f32 maxDistance, RaycastHit& hit, u32 layerMask = QUERY_ALL_LAYERS, b32 hitTriggers = false);
+	//rays are grouped into packets that walk the trees together, and the packets run on the job system
+	void RaycastBatch(const PhysicsRay* rays, RaycastHit* hits, u32 count);
+	b32 SphereCast(Vector3 origin, f32 radius, Vector3 direction, f32 maxDistance, RaycastHit& hit, u32 layerMask = QUERY_ALL_LAYERS, b32 hitTriggers = false);
+	b32 BoxCast(Vector3 origin, Vector3 halfDims, Vector3 rotation, Vector3 direction, f32 maxDistance, RaycastHit& hit, u32 layerMask = QUERY_ALL_LAYERS, b32 hitTriggers = false);
+	//appends the colliders that overlap the shape to out and returns how many were added
+	u32 OverlapSphere(Vector3 center, f32 radius, std::vector<Collider*>& out, u32 layerMask = QUERY_ALL_LAYERS, b32 hitTriggers = false);
+	u32 OverlapBox(Vector3 center, Vector3 halfDims, Vector3 rotation, std::vector<Collider*>& out, u32 layerMask = QUERY_ALL_LAYERS, b32 hitTriggers = false);
+	
+	//called before every step and query, a world that mirrors bodies from somewhere else refreshes its tuples here
+	virtual void SyncBodies(){}
+};
+
+//one fixed step of the world, Step syncs the broadphase first if it needs it and then calls this
+void PhysicsStep(PhysicsWorld* world);
+
+//refits the broadphase to the tuples, creating and destroying proxies for colliders that came and went
+void SyncBroadphase(PhysicsWorld* world);
+
+//wakes sleeping bodies that were moved or rotated from outside the physics world (editor, undo, commands)
+void WakeEditedBodies(PhysicsWorld* world);
+
+#endif //SYSTEM_PHYSICS_WORLD_H
@@ -273,17 +273,12 @@ void SoundSystem::Update() {
 	alListenerfv(AL_ORIENTATION, listenerOri);  TEST_ERROR;
 	
 	//check if any source is requesting to play audio
-	for (auto& e : admin->entities) {
-		if (e) {
-			for (Component* c : e->components) {
-				if (AudioSource* s = dynamic_cast<AudioSource*>(c)) {
-					if (s->source_state != AL_PLAYING && s->request_play) {
-						sources.push_back(s);
-						s->request_play = false;
-						new_sources = true;
-					}
-				}
-			}
+	for (auto& row : admin->Query<AudioSource>()) {
+		AudioSource* s = row.Get<AudioSource>();
+		if (s->source_state != AL_PLAYING && s->request_play) {
+			sources.push_back(s);
+			s->request_play = false;
+			new_sources = true;
 		}
 	}
 	
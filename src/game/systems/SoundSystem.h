@@ -3,6 +3,7 @@
 #define SYSTEM_SOUND_H
 
 #include "../../defines.h"
+#include "SystemScheduler.h"
 #include <vector>
 
 struct Admin;
@@ -22,6 +23,7 @@ struct SoundSystem{
 	ALvoid* data;
 	ALCcontext* context;
 	std::vector<ALuint*> buffers;
+	SystemAccess access{ComponentType_Transform | ComponentType_Camera, ComponentType_AudioSource, false};
 	
 	void Init(Admin* admin);
 	void Update();
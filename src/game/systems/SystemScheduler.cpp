@@ -0,0 +1,85 @@
+#include "SystemScheduler.h"
+#include "../../core/jobs.h"
+
+#include <thread>
+
+u32 SystemScheduler::Add(const char* name, SystemAccess access, f32* time, std::function<void()> fn){
+	u32 index = tasks.size();
+	Task task{name, access, fn, time, {}, 0, 0, 0};
+	forI(index){
+		if(tasks[i].access.Conflicts(access)){
+			tasks[i].dependents.push_back(index);
+			task.dependencyCount++;
+		}
+	}
+	tasks.push_back(task);
+	remaining = std::vector<std::atomic<u32>>(tasks.size());
+	return index;
+}
+
+void SystemScheduler::Clear(){
+	tasks.clear();
+	remaining.clear();
+}
+
+void SystemScheduler::Execute(u32 index){
+	Task& task = tasks[index];
+	task.start = TIMER_END(runStart);
+	task.fn();
+	task.end = TIMER_END(runStart);
+	if(task.time) *task.time = task.end - task.start;
+
+	for(u32 d : task.dependents){
+		if(--remaining[d] == 0) Launch(d);
+	}
+	finished++;
+}
+
+void SystemScheduler::Launch(u32 index){
+	if(tasks[index].access.mainThread || !DengJobs || !DengJobs->workerCount){
+		std::lock_guard<std::mutex> lock(mainReadyLock);
+		mainReady.push_back(index);
+	}else{
+		DengJobs->Submit([this, index](){ Execute(index); }, 0);
+	}
+}
+
+void SystemScheduler::Run(){
+	TIMER_RESET(runStart);
+	finished = 0;
+	forI(tasks.size()) remaining[i] = tasks[i].dependencyCount;
+	forI(tasks.size()) if(tasks[i].dependencyCount == 0) Launch(i);
+
+	//run main thread tasks as they become ready and help with the rest while waiting
+	while(finished < tasks.size()){
+		u32 next = -1;
+		{
+			std::lock_guard<std::mutex> lock(mainReadyLock);
+			if(mainReady.size()){
+				next = mainReady.front();
+				mainReady.erase(mainReady.begin());
+			}
+		}
+		if(next != -1){
+			Execute(next);
+		}else if(!DengJobs || !DengJobs->workerCount || !DengJobs->RunOne(0)){
+			std::this_thread::yield();
+		}
+	}
+	wallTime = TIMER_END(runStart);
+
+	//longest path through the dependencies, tasks are already in topological order
+	persist std::vector<f32> pathTime;
+	pathTime.resize(tasks.size());
+	serialTime = 0;
+	criticalTime = 0;
+	forI(tasks.size()) pathTime[i] = tasks[i].end - tasks[i].start;
+	forI(tasks.size()){
+		f32 duration = tasks[i].end - tasks[i].start;
+		serialTime += duration;
+		criticalTime = Max(criticalTime, pathTime[i]);
+		for(u32 d : tasks[i].dependents){
+			pathTime[d] = Max(pathTime[d], pathTime[i] + tasks[d].end - tasks[d].start);
+		}
+	}
+}
@@ -0,0 +1,63 @@
+#pragma once
+#ifndef SYSTEM_SCHEDULER_H
+#define SYSTEM_SCHEDULER_H
+
+#include "../../defines.h"
+#include "../components/Component.h"
+#include "../../core/time.h"
+
+#include <mutex>
+#include <atomic>
+#include <vector>
+#include <functional>
+
+//the component types a system or layer reads and writes, as ComponentType bits
+struct SystemAccess{
+	ComponentType reads;
+	ComponentType writes;
+	b32 mainThread; //uses something that must stay on the main thread (imgui, glfw)
+
+	b32 Conflicts(const SystemAccess& other) const{
+		return (writes & (other.reads | other.writes)) || (other.writes & reads);
+	}
+};
+
+//runs the per-frame systems and layers, letting ones whose declared access doesnt conflict run at the same time
+//tasks are added in the order they would run serially and each one waits on every earlier task it conflicts with,
+//so the results are the same as running them in order
+struct SystemScheduler{
+	struct Task{
+		const char* name;
+		SystemAccess access;
+		std::function<void()> fn;
+		f32* time;                   //where the task's duration in ms is written, can be 0
+		std::vector<u32> dependents; //later tasks that wait on this one
+		u32 dependencyCount;
+		f32 start, end;              //ms since the start of Run
+	};
+
+	std::vector<Task> tasks;
+	std::vector<std::atomic<u32>> remaining; //per task, dependencies that havent finished this run
+	std::vector<u32> mainReady;              //main thread tasks whose dependencies have finished
+	std::mutex mainReadyLock;
+	std::atomic<u32> finished{0};
+	TIMER_START(runStart);
+
+	f32 wallTime;     //time Run took
+	f32 criticalTime; //longest chain of dependent tasks, the best wallTime could be
+	f32 serialTime;   //sum of every task, what running them in order would take
+
+	//adds a task that runs after the earlier tasks it conflicts with, returns its index
+	u32 Add(const char* name, SystemAccess access, f32* time, std::function<void()> fn);
+
+	//removes all tasks
+	void Clear();
+
+	//runs every task once and waits for them to finish
+	void Run();
+
+	void Execute(u32 task);
+	void Launch(u32 task);
+};
+
+#endif //SYSTEM_SCHEDULER_H
@@ -0,0 +1,358 @@
+#pragma once
+#ifndef DESHI_AABBTREE_H
+#define DESHI_AABBTREE_H
+
+#include "../math/Math.h"
+
+#include <vector>
+
+//world space axis-aligned bounding box, used by the broadphase and other spatial structures
+struct AABB {
+	Vector3 min;
+	Vector3 max;
+
+	AABB() {}
+	AABB(Vector3 min, Vector3 max) : min(min), max(max) {}
+
+	static AABB FromCenter(Vector3 center, Vector3 halfDims) {
+		return AABB(center - halfDims, center + halfDims);
+	}
+
+	static AABB Union(const AABB& a, const AABB& b) {
+		return AABB(Vector3(fminf(a.min.x, b.min.x), fminf(a.min.y, b.min.y), fminf(a.min.z, b.min.z)),
+					Vector3(fmaxf(a.max.x, b.max.x), fmaxf(a.max.y, b.max.y), fmaxf(a.max.z, b.max.z)));
+	}
+
+	bool Overlaps(const AABB& o) const {
+		return (min.x <= o.max.x && max.x >= o.min.x) &&
+			(min.y <= o.max.y && max.y >= o.min.y) &&
+			(min.z <= o.max.z && max.z >= o.min.z);
+	}
+
+	bool Contains(const AABB& o) const {
+		return (min.x <= o.min.x && min.y <= o.min.y && min.z <= o.min.z &&
+				max.x >= o.max.x && max.y >= o.max.y && max.z >= o.max.z);
+	}
+
+	//half the surface area, which is all the SAH cost needs
+	f32 HalfArea() const {
+		f32 x = max.x - min.x, y = max.y - min.y, z = max.z - min.z;
+		return x*y + y*z + z*x;
+	}
+
+	Vector3 Center() const { return (min + max) * .5f; }
+	Vector3 HalfDims() const { return (max - min) * .5f; }
+};
+
+#define AABBTREE_NULL 0xFFFFFFFF
+
+struct AABBTreeNode {
+	AABB aabb;      //fattened aabb for leaves, union of children for branches
+	u32  parent;    //next free node when this node is on the free list
+	u32  left;
+	u32  right;
+	s32  height;    //0 for leaves, -1 when free
+	u32  userdata;  //only valid on leaves
+	u32  stamp;     //last time the owner touched this leaf, used to find orphaned proxies
+
+	bool IsLeaf() const { return left == AABBTREE_NULL; }
+};
+
+//dynamic bounding volume hierarchy with fattened leaves
+//proxies only get reinserted when their tight aabb leaves the fat one, so small movements are
+//nearly free and most frames are just containment checks
+//ref: Box2D b2DynamicTree, https://box2d.org/files/ErinCatto_DynamicBVH_GDC2019.pdf
+struct AABBTree {
+	std::vector<AABBTreeNode> nodes;
+	u32 root = AABBTREE_NULL;
+	u32 freeList = AABBTREE_NULL;
+	u32 proxyCount = 0;
+	f32 margin = 0.1f;           //how much each leaf is fattened by on every side
+	f32 displacementScale = 2.f; //how far ahead of its movement a leaf is stretched
+
+	//creates a leaf for the aabb and returns its proxy id
+	u32 CreateProxy(const AABB& aabb, u32 userdata) {
+		u32 proxy = AllocateNode();
+		Vector3 fat(margin, margin, margin);
+		nodes[proxy].aabb     = AABB(aabb.min - fat, aabb.max + fat);
+		nodes[proxy].userdata = userdata;
+		nodes[proxy].height   = 0;
+		InsertLeaf(proxy);
+		proxyCount++;
+		return proxy;
+	}
+
+	void DestroyProxy(u32 proxy) {
+		Assert(proxy < nodes.size() && nodes[proxy].IsLeaf(), "attempted to destroy an invalid proxy");
+		RemoveLeaf(proxy);
+		FreeNode(proxy);
+		proxyCount--;
+	}
+
+	//refits the proxy if its tight aabb moved out of the fat aabb
+	//returns true if the proxy was reinserted
+	b32 MoveProxy(u32 proxy, const AABB& aabb, Vector3 displacement) {
+		Assert(proxy < nodes.size() && nodes[proxy].IsLeaf(), "attempted to move an invalid proxy");
+		if (nodes[proxy].aabb.Contains(aabb)) return false;
+
+		RemoveLeaf(proxy);
+
+		//fatten and extend in the direction of movement
+		Vector3 fat(margin, margin, margin);
+		AABB fatAABB(aabb.min - fat, aabb.max + fat);
+		Vector3 d = displacement * displacementScale;
+		if (d.x < 0) fatAABB.min.x += d.x; else fatAABB.max.x += d.x;
+		if (d.y < 0) fatAABB.min.y += d.y; else fatAABB.max.y += d.y;
+		if (d.z < 0) fatAABB.min.z += d.z; else fatAABB.max.z += d.z;
+		nodes[proxy].aabb = fatAABB;
+
+		InsertLeaf(proxy);
+		return true;
+	}
+
+	//calls callback(proxy) for every leaf whose fat aabb overlaps the given aabb
+	//the callback returns false to stop the query early
+	template<class F>
+		void Query(const AABB& aabb, F callback) const {
+		if (root == AABBTREE_NULL) return;
+		u32 stack[256]; u32 count = 0;
+		stack[count++] = root;
+		while (count) {
+			u32 index = stack[--count];
+			const AABBTreeNode& node = nodes[index];
+			if (!node.aabb.Overlaps(aabb)) continue;
+			if (node.IsLeaf()) {
+				if (!callback(index)) return;
+			}
+			else {
+#if DESHI_SLOW
+				Assert(count + 2 <= ArrayCount(stack), "AABBTree query stack overflow");
+#endif
+				stack[count++] = node.left;
+				stack[count++] = node.right;
+			}
+		}
+	}
+
+	void Clear() {
+		nodes.clear();
+		root = AABBTREE_NULL;
+		freeList = AABBTREE_NULL;
+		proxyCount = 0;
+	}
+
+	s32 Height() const { return (root == AABBTREE_NULL) ? 0 : nodes[root].height; }
+
+	///////////////////
+	//// internals ////
+	///////////////////
+
+	u32 AllocateNode() {
+		u32 index;
+		if (freeList == AABBTREE_NULL) {
+			nodes.push_back(AABBTreeNode());
+			index = nodes.size() - 1;
+		}
+		else {
+			index = freeList;
+			freeList = nodes[index].parent;
+		}
+		AABBTreeNode& node = nodes[index];
+		node.parent   = AABBTREE_NULL;
+		node.left     = AABBTREE_NULL;
+		node.right    = AABBTREE_NULL;
+		node.height   = 0;
+		node.userdata = 0;
+		node.stamp    = 0;
+		return index;
+	}
+
+	void FreeNode(u32 index) {
+		nodes[index].parent = freeList;
+		nodes[index].height = -1;
+		freeList = index;
+	}
+
+	void InsertLeaf(u32 leaf) {
+		if (root == AABBTREE_NULL) {
+			root = leaf;
+			nodes[root].parent = AABBTREE_NULL;
+			return;
+		}
+
+		//find the best sibling using the surface area heuristic
+		AABB leafAABB = nodes[leaf].aabb;
+		u32 index = root;
+		while (!nodes[index].IsLeaf()) {
+			u32 left  = nodes[index].left;
+			u32 right = nodes[index].right;
+
+			f32 area = nodes[index].aabb.HalfArea();
+			f32 combinedArea = AABB::Union(nodes[index].aabb, leafAABB).HalfArea();
+
+			//cost of creating a new parent for this node and the new leaf
+			f32 cost = 2.f * combinedArea;
+			//minimum cost of pushing the leaf further down the tree
+			f32 inheritanceCost = 2.f * (combinedArea - area);
+
+			f32 costLeft = AABB::Union(leafAABB, nodes[left].aabb).HalfArea() + inheritanceCost;
+			if (!nodes[left].IsLeaf()) costLeft -= nodes[left].aabb.HalfArea();
+			f32 costRight = AABB::Union(leafAABB, nodes[right].aabb).HalfArea() + inheritanceCost;
+			if (!nodes[right].IsLeaf()) costRight -= nodes[right].aabb.HalfArea();
+
+			if (cost < costLeft && cost < costRight) break;
+			index = (costLeft < costRight) ? left : right;
+		}
+		u32 sibling = index;
+
+		//create a new parent for the sibling and leaf
+		u32 oldParent = nodes[sibling].parent;
+		u32 newParent = AllocateNode();
+		nodes[newParent].parent = oldParent;
+		nodes[newParent].aabb   = AABB::Union(leafAABB, nodes[sibling].aabb);
+		nodes[newParent].height = nodes[sibling].height + 1;
+		nodes[newParent].left   = sibling;
+		nodes[newParent].right  = leaf;
+		nodes[sibling].parent   = newParent;
+		nodes[leaf].parent      = newParent;
+		if (oldParent != AABBTREE_NULL) {
+			if (nodes[oldParent].left == sibling) nodes[oldParent].left  = newParent;
+			else                                  nodes[oldParent].right = newParent;
+		}
+		else {
+			root = newParent;
+		}
+
+		Refit(nodes[leaf].parent);
+	}
+
+	void RemoveLeaf(u32 leaf) {
+		if (leaf == root) {
+			root = AABBTREE_NULL;
+			return;
+		}
+
+		u32 parent      = nodes[leaf].parent;
+		u32 grandParent = nodes[parent].parent;
+		u32 sibling     = (nodes[parent].left == leaf) ? nodes[parent].right : nodes[parent].left;
+
+		if (grandParent != AABBTREE_NULL) {
+			if (nodes[grandParent].left == parent) nodes[grandParent].left  = sibling;
+			else                                   nodes[grandParent].right = sibling;
+			nodes[sibling].parent = grandParent;
+			FreeNode(parent);
+			Refit(grandParent);
+		}
+		else {
+			root = sibling;
+			nodes[sibling].parent = AABBTREE_NULL;
+			FreeNode(parent);
+		}
+	}
+
+	//walks up from index rebalancing and recalculating bounds
+	void Refit(u32 index) {
+		while (index != AABBTREE_NULL) {
+			index = Balance(index);
+			u32 left  = nodes[index].left;
+			u32 right = nodes[index].right;
+			nodes[index].height = 1 + Max(nodes[left].height, nodes[right].height);
+			nodes[index].aabb   = AABB::Union(nodes[left].aabb, nodes[right].aabb);
+			index = nodes[index].parent;
+		}
+	}
+
+	//performs a left or right rotation if node a is imbalanced, returns the new subtree root
+	u32 Balance(u32 a) {
+		AABBTreeNode* A = &nodes[a];
+		if (A->IsLeaf() || A->height < 2) return a;
+
+		u32 b = A->left;
+		u32 c = A->right;
+		AABBTreeNode* B = &nodes[b];
+		AABBTreeNode* C = &nodes[c];
+		s32 balance = C->height - B->height;
+
+		//rotate c up
+		if (balance > 1) {
+			u32 f = C->left;
+			u32 g = C->right;
+			AABBTreeNode* F = &nodes[f];
+			AABBTreeNode* G = &nodes[g];
+
+			C->left   = a;
+			C->parent = A->parent;
+			A->parent = c;
+			if (C->parent != AABBTREE_NULL) {
+				if (nodes[C->parent].left == a) nodes[C->parent].left  = c;
+				else                            nodes[C->parent].right = c;
+			}
+			else {
+				root = c;
+			}
+
+			if (F->height > G->height) {
+				C->right  = f;
+				A->right  = g;
+				G->parent = a;
+				A->aabb   = AABB::Union(B->aabb, G->aabb);
+				C->aabb   = AABB::Union(A->aabb, F->aabb);
+				A->height = 1 + Max(B->height, G->height);
+				C->height = 1 + Max(A->height, F->height);
+			}
+			else {
+				C->right  = g;
+				A->right  = f;
+				F->parent = a;
+				A->aabb   = AABB::Union(B->aabb, F->aabb);
+				C->aabb   = AABB::Union(A->aabb, G->aabb);
+				A->height = 1 + Max(B->height, F->height);
+				C->height = 1 + Max(A->height, G->height);
+			}
+			return c;
+		}
+
+		//rotate b up
+		if (balance < -1) {
+			u32 d = B->left;
+			u32 e = B->right;
+			AABBTreeNode* D = &nodes[d];
+			AABBTreeNode* E = &nodes[e];
+
+			B->left   = a;
+			B->parent = A->parent;
+			A->parent = b;
+			if (B->parent != AABBTREE_NULL) {
+				if (nodes[B->parent].left == a) nodes[B->parent].left  = b;
+				else                            nodes[B->parent].right = b;
+			}
+			else {
+				root = b;
+			}
+
+			if (D->height > E->height) {
+				B->right  = d;
+				A->left   = e;
+				E->parent = a;
+				A->aabb   = AABB::Union(C->aabb, E->aabb);
+				B->aabb   = AABB::Union(A->aabb, D->aabb);
+				A->height = 1 + Max(C->height, E->height);
+				B->height = 1 + Max(A->height, D->height);
+			}
+			else {
+				B->right  = e;
+				A->left   = d;
+				D->parent = a;
+				A->aabb   = AABB::Union(C->aabb, D->aabb);
+				B->aabb   = AABB::Union(A->aabb, E->aabb);
+				A->height = 1 + Max(C->height, D->height);
+				B->height = 1 + Max(A->height, E->height);
+			}
+			return b;
+		}
+
+		return a;
+	}
+};
+
+#endif //DESHI_AABBTREE_H
@@ -0,0 +1,332 @@
+#pragma once
+#ifndef DESHI_CONVEXHULL_H
+#define DESHI_CONVEXHULL_H
+
+#include "../defines.h"
+#include "../math/VectorMatrix.h"
+
+#include <vector>
+#include <algorithm>
+#include <float.h>
+
+#define CONVEXHULL_MAX_VERTICES 32 //default cap, enough for GJK to feel the shape without scanning a render mesh
+
+//how a mesh is simplified into hulls, part of the cache key so changing it rebuilds the cached hulls
+struct ConvexHullParams {
+	u32 maxVertices   = CONVEXHULL_MAX_VERTICES; //each hull stops growing at this many vertices
+	u32 maxHulls      = 1;    //above 1 the mesh is split into pieces where it is concave, see ConvexDecomposition
+	f32 minVolumeGain = .15f; //a split is only kept if the pieces' hulls are at least this fraction smaller than the hull they replace
+};
+
+//convex hull of a point set in the points' space, built with quickhull
+//the point furthest outside the hull is always added next, so a hull capped at maxVertices is made of the
+//points that shape it the most and only loses the detail that matters least
+//ref: Barber et al. 1996 'The Quickhull Algorithm for Convex Hulls', Dirk Gregorius 'Implementing Quickhull' GDC 2014
+struct ConvexHull {
+	std::vector<Vector3> vertices;
+	std::vector<u32> indices; //three per face, (b-a) x (c-a) points out of the hull
+	Vector3 center;           //average of the vertices, always inside
+	
+	u32 FaceCount() const { return indices.size() / 3; }
+	
+	f32 Volume() const {
+		f32 volume = 0;
+		for (u32 i = 0; i < indices.size(); i += 3) {
+			volume += (vertices[indices[i]] - center).dot(Cross(vertices[indices[i+1]] - center, vertices[indices[i+2]] - center));
+		}
+		return volume / 6.f;
+	}
+	
+	//ray clipped against every face plane, t is the max distance going in and the hit distance coming out
+	//direction doesnt need to be normalized, t is in multiples of it
+	//face is the face the ray enters through, or -1 if it starts inside the hull, which is a hit at 0
+	b32 Raycast(Vector3 origin, Vector3 direction, f32& t, u32* face = 0) const {
+		if (indices.empty()) return false;
+		f32 enter = 0, exit = t;
+		u32 enterFace = (u32)-1;
+		for (u32 f = 0; f < FaceCount(); ++f) {
+			const Vector3& a = vertices[indices[3*f]];
+			Vector3 normal = Cross(vertices[indices[3*f+1]] - a, vertices[indices[3*f+2]] - a);
+			f32 distance = normal.dot(origin - a);
+			f32 speed = normal.dot(direction);
+			if (speed == 0) {
+				if (distance > 0) return false;
+				continue;
+			}
+			f32 hit = -distance / speed;
+			if (speed < 0) {
+				if (hit > enter) { enter = hit; enterFace = f; }
+			}
+			else if (hit < exit) {
+				exit = hit;
+			}
+			if (enter > exit) return false;
+		}
+		t = enter;
+		if (face) *face = enterFace;
+		return true;
+	}
+	
+	//returns false and leaves the hull empty if the points are all on a plane or a line, since those have no volume
+	b32 Build(const Vector3* points, u32 count, u32 maxVertices = CONVEXHULL_MAX_VERTICES) {
+		Clear();
+		if (count < 4 || maxVertices < 4) return false;
+		
+		//the extreme points along each axis seed the tetrahedron and scale the tolerance to the mesh
+		u32 extremes[6] = {};
+		for (u32 i = 1; i < count; ++i) {
+			for (u32 a = 0; a < 3; ++a) {
+				if (Axis(points[i], a) < Axis(points[extremes[2*a+0]], a)) extremes[2*a+0] = i;
+				if (Axis(points[i], a) > Axis(points[extremes[2*a+1]], a)) extremes[2*a+1] = i;
+			}
+		}
+		f32 epsilon = 0;
+		for (u32 a = 0; a < 3; ++a) epsilon += fmaxf(fabs(Axis(points[extremes[2*a]], a)), fabs(Axis(points[extremes[2*a+1]], a)));
+		epsilon *= 3 * FLT_EPSILON;
+		
+		//initial tetrahedron: the two extremes furthest apart, then the point furthest from their line, then from their plane
+		u32 v[4] = {};
+		f32 best = 0;
+		for (u32 i = 0; i < 6; ++i) {
+			for (u32 j = i + 1; j < 6; ++j) {
+				f32 distance = (points[extremes[i]] - points[extremes[j]]).mag();
+				if (distance > best) { best = distance; v[0] = extremes[i]; v[1] = extremes[j]; }
+			}
+		}
+		if (best <= epsilon) return false;
+		Vector3 line = points[v[1]] - points[v[0]];
+		best = 0;
+		for (u32 i = 0; i < count; ++i) {
+			f32 distance = Cross(points[i] - points[v[0]], line).mag();
+			if (distance > best) { best = distance; v[2] = i; }
+		}
+		if (best <= epsilon * line.mag()) return false;
+		Vector3 normal = Cross(line, points[v[2]] - points[v[0]]).normalized();
+		best = 0;
+		for (u32 i = 0; i < count; ++i) {
+			f32 distance = fabs((points[i] - points[v[0]]).dot(normal));
+			if (distance > best) { best = distance; v[3] = i; }
+		}
+		if (best <= epsilon) return false;
+		
+		std::vector<Face> faces;
+		if ((points[v[3]] - points[v[0]]).dot(normal) > 0) std::swap(v[1], v[2]);
+		AddFace(faces, points, v[0], v[1], v[2]);
+		AddFace(faces, points, v[0], v[3], v[1]);
+		AddFace(faces, points, v[1], v[3], v[2]);
+		AddFace(faces, points, v[2], v[3], v[0]);
+		for (u32 i = 0; i < count; ++i) {
+			if (i == v[0] || i == v[1] || i == v[2] || i == v[3]) continue;
+			AssignPoint(faces, 0, points, i, epsilon);
+		}
+		
+		std::vector<u32> stack, visible, horizon, orphans;
+		for (u32 vertexCount = 4; vertexCount < maxVertices; ++vertexCount) {
+			u32 start = (u32)-1;
+			best = 0;
+			for (u32 f = 0; f < faces.size(); ++f) {
+				if (faces[f].alive && faces[f].outside.size() && faces[f].furthestDistance > best) { best = faces[f].furthestDistance; start = f; }
+			}
+			if (start == (u32)-1) break;
+			u32 eye = faces[start].furthest;
+			
+			//the faces the eye can see, grown from the one it is outside of over shared edges so the set stays connected
+			//edges of visible faces whose neighbor cant see the eye make up the horizon, in the visible face's winding
+			stack.clear(); visible.clear(); horizon.clear();
+			faces[start].visible = true;
+			stack.push_back(start);
+			while (stack.size()) {
+				u32 f = stack.back(); stack.pop_back();
+				visible.push_back(f);
+				for (u32 e = 0; e < 3; ++e) {
+					u32 a = faces[f].v[e], b = faces[f].v[(e + 1) % 3];
+					u32 neighbor = FindFace(faces, b, a);
+					if (neighbor == (u32)-1 || faces[neighbor].visible) continue;
+					if (faces[neighbor].Distance(points[eye]) > epsilon) {
+						faces[neighbor].visible = true;
+						stack.push_back(neighbor);
+					}
+					else {
+						horizon.push_back(a);
+						horizon.push_back(b);
+					}
+				}
+			}
+			
+			orphans.clear();
+			for (u32 f : visible) {
+				for (u32 p : faces[f].outside) if (p != eye) orphans.push_back(p);
+				faces[f].alive = false;
+				faces[f].outside = std::vector<u32>();
+			}
+			u32 first = faces.size();
+			for (u32 e = 0; e < horizon.size(); e += 2) AddFace(faces, points, horizon[e], horizon[e+1], eye);
+			for (u32 p : orphans) AssignPoint(faces, first, points, p, epsilon);
+		}
+		
+		//only the points still on alive faces are kept, the rest were swallowed by later points
+		std::vector<u32> remap(count, (u32)-1);
+		for (const Face& face : faces) {
+			if (!face.alive) continue;
+			for (u32 i = 0; i < 3; ++i) {
+				if (remap[face.v[i]] == (u32)-1) {
+					remap[face.v[i]] = vertices.size();
+					vertices.push_back(points[face.v[i]]);
+				}
+				indices.push_back(remap[face.v[i]]);
+			}
+		}
+		center = Vector3::ZERO;
+		for (const Vector3& vertex : vertices) center += vertex;
+		center /= (f32)vertices.size();
+		return true;
+	}
+	
+	void Clear() {
+		vertices.clear();
+		indices.clear();
+		center = Vector3::ZERO;
+	}
+	
+	///////////////////
+	//// internals ////
+	///////////////////
+	
+	struct Face {
+		u32 v[3];
+		Vector3 normal;
+		f32 offset;
+		std::vector<u32> outside; //points in front of the face that no earlier face claimed
+		u32 furthest;
+		f32 furthestDistance;
+		b32 alive;
+		b32 visible;
+		
+		f32 Distance(const Vector3& point) const { return normal.dot(point) - offset; }
+	};
+	
+	static f32 Axis(const Vector3& v, u32 axis) { return (axis == 0) ? v.x : (axis == 1) ? v.y : v.z; }
+	
+	//right hand cross product, Vector3::cross is left handed
+	static Vector3 Cross(const Vector3& a, const Vector3& b) { return Vector3(a.y*b.z - a.z*b.y, a.z*b.x - a.x*b.z, a.x*b.y - a.y*b.x); }
+	
+	//a sliver face keeps a zero normal, so nothing is ever in front of it and it is never seen
+	static void AddFace(std::vector<Face>& faces, const Vector3* points, u32 a, u32 b, u32 c) {
+		Face face;
+		face.v[0] = a; face.v[1] = b; face.v[2] = c;
+		face.normal = Cross(points[b] - points[a], points[c] - points[a]);
+		f32 length = face.normal.mag();
+		face.normal = (length > 0) ? face.normal / length : Vector3::ZERO;
+		face.offset = face.normal.dot(points[a]);
+		face.furthest = 0;
+		face.furthestDistance = 0;
+		face.alive = true;
+		face.visible = false;
+		faces.push_back(face);
+	}
+	
+	//the point goes to the first face from start on it is in front of, or nowhere if it is inside the hull
+	static void AssignPoint(std::vector<Face>& faces, u32 start, const Vector3* points, u32 point, f32 epsilon) {
+		for (u32 f = start; f < faces.size(); ++f) {
+			if (!faces[f].alive) continue;
+			f32 distance = faces[f].Distance(points[point]);
+			if (distance <= epsilon) continue;
+			faces[f].outside.push_back(point);
+			if (distance > faces[f].furthestDistance) {
+				faces[f].furthestDistance = distance;
+				faces[f].furthest = point;
+			}
+			return;
+		}
+	}
+	
+	//alive face with the directed edge a->b
+	static u32 FindFace(const std::vector<Face>& faces, u32 a, u32 b) {
+		for (u32 f = 0; f < faces.size(); ++f) {
+			if (!faces[f].alive) continue;
+			const u32* v = faces[f].v;
+			if ((v[0] == a && v[1] == b) || (v[1] == a && v[2] == b) || (v[2] == a && v[0] == b)) return f;
+		}
+		return (u32)-1;
+	}
+};
+
+//splits a mesh into at most params.maxHulls convex hulls: the piece with the biggest hull is cut in two by its triangles'
+//centroids, and the cut is only kept if the halves' hulls are at least minVolumeGain smaller than the hull they
+//replace, so pieces are only split where the mesh is actually concave
+//triangleVertices holds three vertices per triangle, hulls is left empty if the mesh is flat
+inline void ConvexDecomposition(const std::vector<Vector3>& triangleVertices, const ConvexHullParams& params, std::vector<ConvexHull>& hulls) {
+	struct Piece {
+		std::vector<u32> triangles;
+		ConvexHull hull;
+		f32 volume;
+		b32 done;
+	};
+	std::vector<Vector3> points;
+	auto build = [&](Piece& piece) {
+		points.clear();
+		for (u32 tri : piece.triangles) points.insert(points.end(), &triangleVertices[3*tri], &triangleVertices[3*tri] + 3);
+		piece.done = false;
+		if (!piece.hull.Build(points.data(), points.size(), params.maxVertices)) return false;
+		piece.volume = piece.hull.Volume();
+		return true;
+	};
+	
+	hulls.clear();
+	std::vector<Piece> pieces(1);
+	for (u32 i = 0; i < triangleVertices.size() / 3; ++i) pieces[0].triangles.push_back(i);
+	if (!build(pieces[0])) return;
+	
+	while (pieces.size() < params.maxHulls) {
+		u32 index = (u32)-1;
+		for (u32 i = 0; i < pieces.size(); ++i) {
+			if (!pieces[i].done && (index == (u32)-1 || pieces[i].volume > pieces[index].volume)) index = i;
+		}
+		if (index == (u32)-1) break;
+		if (pieces[index].triangles.size() < 2) { pieces[index].done = true; continue; }
+		
+		//cuts are tried along each axis at the median triangle and at the middle of the bounds, the one whose halves have
+		//the least hull volume wins
+		std::vector<u32>& triangles = pieces[index].triangles;
+		auto centroid = [&](u32 tri) { return (triangleVertices[3*tri] + triangleVertices[3*tri+1] + triangleVertices[3*tri+2]) / 3.f; };
+		Vector3 lo = centroid(triangles[0]), hi = lo;
+		for (u32 tri : triangles) {
+			Vector3 c = centroid(tri);
+			lo = Vector3(fminf(lo.x, c.x), fminf(lo.y, c.y), fminf(lo.z, c.z));
+			hi = Vector3(fmaxf(hi.x, c.x), fmaxf(hi.y, c.y), fmaxf(hi.z, c.z));
+		}
+		Piece left, right, bestLeft, bestRight;
+		f32 bestVolume = (1.f - params.minVolumeGain) * pieces[index].volume;
+		b32 found = false;
+		for (u32 axis = 0; axis < 3; ++axis) {
+			if (ConvexHull::Axis(hi, axis) - ConvexHull::Axis(lo, axis) < 1e-7f) continue;
+			std::sort(triangles.begin(), triangles.end(), [&](u32 a, u32 b) {
+				return ConvexHull::Axis(centroid(a), axis) < ConvexHull::Axis(centroid(b), axis);
+			});
+			f32 middle = (ConvexHull::Axis(lo, axis) + ConvexHull::Axis(hi, axis)) / 2.f;
+			u32 cuts[2] = { (u32)triangles.size() / 2, (u32)(std::lower_bound(triangles.begin(), triangles.end(), middle, [&](u32 tri, f32 value) {
+				return ConvexHull::Axis(centroid(tri), axis) < value;
+			}) - triangles.begin()) };
+			for (u32 cut : cuts) {
+				if (cut == 0 || cut == triangles.size()) continue;
+				left.triangles.assign(triangles.begin(), triangles.begin() + cut);
+				right.triangles.assign(triangles.begin() + cut, triangles.end());
+				if (!build(left) || !build(right) || left.volume + right.volume >= bestVolume) continue;
+				bestVolume = left.volume + right.volume;
+				std::swap(left, bestLeft);
+				std::swap(right, bestRight);
+				found = true;
+			}
+		}
+		if (!found) {
+			pieces[index].done = true;
+			continue;
+		}
+		pieces[index] = std::move(bestLeft);
+		pieces.push_back(std::move(bestRight));
+	}
+	
+	for (Piece& piece : pieces) hulls.push_back(std::move(piece.hull));
+}
+
+#endif //DESHI_CONVEXHULL_H
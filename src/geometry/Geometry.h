@@ -41,7 +41,7 @@ namespace Geometry {
 		return Vector3(
 					   fmaxf(center.x - halfDims.x, fminf(target.x, center.x + halfDims.x)),
 					   fmaxf(center.y - halfDims.y, fminf(target.y, center.y + halfDims.y)),
-					   fmaxf(center.y - halfDims.z, fminf(target.z, center.z + halfDims.z)));
+					   fmaxf(center.z - halfDims.z, fminf(target.z, center.z + halfDims.z)));
 	}
 	
 	static Vector3 ClosestPointOnSphere(Vector3 center, float radius, Vector3 target) {
@@ -53,6 +53,6 @@ namespace Geometry {
 		return Vector3(
 					   fmaxf(center.x - halfDims.x, fminf(target.x, center.x + halfDims.x)),
 					   fmaxf(center.y - halfDims.y, fminf(target.y, center.y + halfDims.y)),
-					   fmaxf(center.y - halfDims.z, fminf(target.z, center.z + halfDims.z)));
+					   fmaxf(center.z - halfDims.z, fminf(target.z, center.z + halfDims.z)));
 	}
 };
\ No newline at end of file
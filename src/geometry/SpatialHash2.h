@@ -0,0 +1,131 @@
+#pragma once
+#ifndef DESHI_SPATIALHASH2_H
+#define DESHI_SPATIALHASH2_H
+
+#include "../math/Math.h"
+
+#include <vector>
+#include <algorithm>
+
+#define SPATIALHASH2_MAX_CELLS 256 //items touching more cells than this skip the grid and are checked against everything
+
+//uniform grid over a plane whose cells are hashed into buckets, used to pair up 2D shapes
+//it is rebuilt from scratch every time with a counting sort, so a build is linear in the cells the items touch
+//ref: https://matthias-research.github.io/pages/tenMinutePhysics/11-hashing.pdf
+struct SpatialHash2 {
+	struct Bounds {
+		Vector2 min;
+		Vector2 max;
+	};
+
+	struct Entry {
+		s32 x, y; //cell
+		u32 item;
+	};
+
+	f32 cellSize = 1;
+	std::vector<Bounds> bounds;   //of each item, in the order they were added
+	std::vector<u32> bucketStart; //first entry of each bucket, with one extra at the end
+	std::vector<Entry> entries;   //grouped by bucket
+	std::vector<Entry> unsorted;
+	std::vector<u32> large;       //items that skipped the grid
+
+	void Clear() {
+		bounds.clear();
+	}
+
+	void Add(Vector2 min, Vector2 max) {
+		bounds.push_back(Bounds{min, max});
+	}
+
+	//picks the cell size from the average extent of the items and buckets every cell each item touches
+	void Build() {
+		entries.clear();
+		unsorted.clear();
+		large.clear();
+		bucketStart.clear();
+		if (bounds.empty()) return;
+
+		f32 extent = 0;
+		u32 finite = 0;
+		for (Bounds& b : bounds) {
+			f32 size = Max(b.max.x - b.min.x, b.max.y - b.min.y);
+			if (!(size < 1e30f)) continue;
+			extent += size;
+			finite++;
+		}
+		cellSize = (finite) ? Max(extent / finite, 1e-3f) : 1.f;
+
+		for (u32 i = 0; i < bounds.size(); ++i) {
+			f32 cellsX = (bounds[i].max.x - bounds[i].min.x) / cellSize + 1;
+			f32 cellsY = (bounds[i].max.y - bounds[i].min.y) / cellSize + 1;
+			if (!(cellsX * cellsY <= SPATIALHASH2_MAX_CELLS)) { //also catches infinite and nan bounds
+				large.push_back(i);
+				continue;
+			}
+			s32 x0 = Cell(bounds[i].min.x), x1 = Cell(bounds[i].max.x);
+			s32 y0 = Cell(bounds[i].min.y), y1 = Cell(bounds[i].max.y);
+			for (s32 y = y0; y <= y1; ++y) {
+				for (s32 x = x0; x <= x1; ++x) {
+					unsorted.push_back(Entry{x, y, i});
+				}
+			}
+		}
+
+		//twice as many buckets as entries keeps unrelated cells from sharing a bucket most of the time
+		u32 buckets = 1;
+		while (buckets < 2*unsorted.size()) buckets <<= 1;
+		bucketStart.assign(buckets + 1, 0);
+		for (Entry& e : unsorted) bucketStart[Hash(e.x, e.y, buckets) + 1]++;
+		for (u32 b = 0; b < buckets; ++b) bucketStart[b+1] += bucketStart[b];
+
+		//bucketStart is walked forward while filling and shifted back afterwards
+		entries.resize(unsorted.size());
+		for (Entry& e : unsorted) entries[bucketStart[Hash(e.x, e.y, buckets)]++] = e;
+		for (u32 b = buckets; b > 0; --b) bucketStart[b] = bucketStart[b-1];
+		bucketStart[0] = 0;
+	}
+
+	//calls fn(a, b) with a < b once for every pair of items whose bounds overlap
+	template<class F>
+		void ForEachPair(F fn) const {
+		for (u32 i = 0; i < large.size(); ++i) {
+			const Bounds& b0 = bounds[large[i]];
+			for (u32 other = 0; other < bounds.size(); ++other) {
+				//pairs of two large items are reported by the first one
+				if (other == large[i] || (other < large[i] && std::binary_search(large.begin(), large.end(), other))) continue;
+				const Bounds& b1 = bounds[other];
+				if (b0.max.x < b1.min.x || b0.min.x > b1.max.x || b0.max.y < b1.min.y || b0.min.y > b1.max.y) continue;
+				fn(Min(large[i], other), Max(large[i], other));
+			}
+		}
+		for (u32 b = 0; b + 1 < bucketStart.size(); ++b) {
+			for (u32 i = bucketStart[b]; i < bucketStart[b+1]; ++i) {
+				for (u32 j = i + 1; j < bucketStart[b+1]; ++j) {
+					const Entry& e0 = entries[i];
+					const Entry& e1 = entries[j];
+					if (e0.x != e1.x || e0.y != e1.y || e0.item == e1.item) continue; //different cells that hashed together
+
+					const Bounds& b0 = bounds[e0.item];
+					const Bounds& b1 = bounds[e1.item];
+					if (b0.max.x < b1.min.x || b0.min.x > b1.max.x || b0.max.y < b1.min.y || b0.min.y > b1.max.y) continue;
+
+					//a pair sharing several cells is only reported from the one holding the min corner of their overlap
+					if (Cell(Max(b0.min.x, b1.min.x)) != e0.x || Cell(Max(b0.min.y, b1.min.y)) != e0.y) continue;
+
+					fn(Min(e0.item, e1.item), Max(e0.item, e1.item));
+				}
+			}
+		}
+	}
+
+	s32 Cell(f32 value) const {
+		return (s32)floorf(value / cellSize);
+	}
+
+	static u32 Hash(s32 x, s32 y, u32 buckets) {
+		return ((u32)x * 73856093u ^ (u32)y * 19349663u) & (buckets - 1);
+	}
+};
+
+#endif //DESHI_SPATIALHASH2_H
@@ -0,0 +1,258 @@
+#pragma once
+#ifndef DESHI_TRIANGLEBVH_H
+#define DESHI_TRIANGLEBVH_H
+
+#include "AABBTree.h"
+
+#include <vector>
+#include <algorithm>
+#include <float.h>
+
+#define TRIANGLEBVH_LEAF_SIZE     4  //ranges this small are always leaves
+#define TRIANGLEBVH_MAX_LEAF_SIZE 16 //ranges bigger than this are always split, even when SAH says not to
+#define TRIANGLEBVH_BINS          12
+#define TRIANGLEBVH_MAX_DEPTH     32 //past this ranges are split at the median so the query stacks cant overflow
+
+struct TriangleBVHNode {
+	AABB aabb;
+	u32  offset; //first triangle for leaves, second child for branches (the first child is always the next node)
+	u32  count;  //triangles in the leaf, 0 for branches
+
+	bool IsLeaf() const { return count != 0; }
+};
+
+//static bvh over a mesh's triangles in the mesh's local space, built once with binned SAH
+//nodes are flattened depth first and the triangles are stored in leaf order, so a query walks
+//two contiguous arrays instead of chasing pointers
+//ref: https://jacco.ompf2.com/2022/04/21/how-to-build-a-bvh-part-3-quick-builds/, PBRT 4.3
+struct TriangleBVH {
+	std::vector<TriangleBVHNode> nodes;
+	std::vector<Vector3> vertices; //three per triangle
+	std::vector<u32> original;     //index each triangle had in the array the tree was built from
+
+	u32 TriangleCount() const { return vertices.size() / 3; }
+	const Vector3* TriangleVertices(u32 triangle) const { return &vertices[3*triangle]; }
+	AABB Bounds() const { return (nodes.size()) ? nodes[0].aabb : AABB(Vector3::ZERO, Vector3::ZERO); }
+
+	//triangleVertices holds three vertices per triangle
+	void Build(const std::vector<Vector3>& triangleVertices) {
+		Clear();
+		u32 count = triangleVertices.size() / 3;
+		if (!count) return;
+
+		std::vector<AABB> bounds(count);
+		std::vector<Vector3> centroids(count);
+		original.resize(count);
+		for (u32 i = 0; i < count; ++i) {
+			const Vector3* p = &triangleVertices[3*i];
+			bounds[i] = AABB(Vector3(fminf(p[0].x, fminf(p[1].x, p[2].x)), fminf(p[0].y, fminf(p[1].y, p[2].y)), fminf(p[0].z, fminf(p[1].z, p[2].z))),
+							 Vector3(fmaxf(p[0].x, fmaxf(p[1].x, p[2].x)), fmaxf(p[0].y, fmaxf(p[1].y, p[2].y)), fmaxf(p[0].z, fmaxf(p[1].z, p[2].z))));
+			centroids[i] = bounds[i].Center();
+			original[i] = i;
+		}
+
+		nodes.reserve(2*count);
+		BuildNode(bounds, centroids, 0, count, 0);
+
+		vertices.resize(3*count);
+		for (u32 i = 0; i < count; ++i) {
+			vertices[3*i+0] = triangleVertices[3*original[i]+0];
+			vertices[3*i+1] = triangleVertices[3*original[i]+1];
+			vertices[3*i+2] = triangleVertices[3*original[i]+2];
+		}
+	}
+
+	//calls callback(triangle) for every triangle whose bounds overlap the given aabb
+	//the callback returns false to stop the query early
+	template<class F>
+		void Query(const AABB& aabb, F callback) const {
+		if (nodes.empty()) return;
+		u32 stack[2*TRIANGLEBVH_MAX_DEPTH + 2]; u32 count = 0;
+		stack[count++] = 0;
+		while (count) {
+			u32 index = stack[--count];
+			const TriangleBVHNode& node = nodes[index];
+			if (!node.aabb.Overlaps(aabb)) continue;
+			if (node.IsLeaf()) {
+				for (u32 i = node.offset; i < node.offset + node.count; ++i) {
+					const Vector3* p = &vertices[3*i];
+					if (fmaxf(p[0].x, fmaxf(p[1].x, p[2].x)) < aabb.min.x || fminf(p[0].x, fminf(p[1].x, p[2].x)) > aabb.max.x ||
+						fmaxf(p[0].y, fmaxf(p[1].y, p[2].y)) < aabb.min.y || fminf(p[0].y, fminf(p[1].y, p[2].y)) > aabb.max.y ||
+						fmaxf(p[0].z, fmaxf(p[1].z, p[2].z)) < aabb.min.z || fminf(p[0].z, fminf(p[1].z, p[2].z)) > aabb.max.z) continue;
+					if (!callback(i)) return;
+				}
+			}
+			else {
+				stack[count++] = node.offset;
+				stack[count++] = index + 1;
+			}
+		}
+	}
+
+	//closest triangle hit by the ray, t is the max distance going in and the hit distance coming out
+	//direction doesnt need to be normalized, t is in multiples of it
+	b32 Raycast(Vector3 origin, Vector3 direction, f32& t, u32* triangle = 0) const {
+		if (nodes.empty()) return false;
+		Vector3 inverse(1.f / direction.x, 1.f / direction.y, 1.f / direction.z);
+		b32 hit = false;
+		u32 stack[2*TRIANGLEBVH_MAX_DEPTH + 2]; u32 count = 0;
+		stack[count++] = 0;
+		while (count) {
+			u32 index = stack[--count];
+			const TriangleBVHNode& node = nodes[index];
+			if (RayAABB(origin, inverse, node.aabb, t) > t) continue;
+			if (node.IsLeaf()) {
+				for (u32 i = node.offset; i < node.offset + node.count; ++i) {
+					if (RayTriangle(origin, direction, &vertices[3*i], t)) {
+						hit = true;
+						if (triangle) *triangle = i;
+					}
+				}
+			}
+			else {
+				//the nearer child goes on top so the further one is usually culled by the shortened ray
+				u32 first = index + 1, second = node.offset;
+				f32 tFirst = RayAABB(origin, inverse, nodes[first].aabb, t);
+				f32 tSecond = RayAABB(origin, inverse, nodes[second].aabb, t);
+				if (tFirst < tSecond) { std::swap(first, second); std::swap(tFirst, tSecond); }
+				if (tFirst <= t) stack[count++] = first;
+				if (tSecond <= t) stack[count++] = second;
+			}
+		}
+		return hit;
+	}
+
+	void Clear() {
+		nodes.clear();
+		vertices.clear();
+		original.clear();
+	}
+
+	///////////////////
+	//// internals ////
+	///////////////////
+
+	static f32 Axis(const Vector3& v, u32 axis) { return (axis == 0) ? v.x : (axis == 1) ? v.y : v.z; }
+
+	//distance along the ray to where it enters the aabb, FLT_MAX if it misses or enters after maxT
+	static f32 RayAABB(Vector3 origin, Vector3 inverse, const AABB& aabb, f32 maxT) {
+		f32 x0 = (aabb.min.x - origin.x) * inverse.x, x1 = (aabb.max.x - origin.x) * inverse.x;
+		f32 y0 = (aabb.min.y - origin.y) * inverse.y, y1 = (aabb.max.y - origin.y) * inverse.y;
+		f32 z0 = (aabb.min.z - origin.z) * inverse.z, z1 = (aabb.max.z - origin.z) * inverse.z;
+		f32 enter = fmaxf(fmaxf(fminf(x0, x1), fminf(y0, y1)), fmaxf(fminf(z0, z1), 0.f));
+		f32 exit  = fminf(fminf(fmaxf(x0, x1), fmaxf(y0, y1)), fminf(fmaxf(z0, z1), maxT));
+		return (enter <= exit) ? enter : FLT_MAX;
+	}
+
+	//moller-trumbore, both sides of the triangle are hit; shortens t on a hit
+	static b32 RayTriangle(Vector3 origin, Vector3 direction, const Vector3* p, f32& t) {
+		Vector3 e1 = p[1] - p[0], e2 = p[2] - p[0];
+		Vector3 h(direction.y*e2.z - direction.z*e2.y, direction.z*e2.x - direction.x*e2.z, direction.x*e2.y - direction.y*e2.x);
+		f32 det = e1.dot(h);
+		if (fabs(det) < 1e-12f) return false;
+		f32 inv = 1.f / det;
+		Vector3 s = origin - p[0];
+		f32 u = s.dot(h) * inv;
+		if (u < 0 || u > 1) return false;
+		Vector3 q(s.y*e1.z - s.z*e1.y, s.z*e1.x - s.x*e1.z, s.x*e1.y - s.y*e1.x);
+		f32 v = direction.dot(q) * inv;
+		if (v < 0 || u + v > 1) return false;
+		f32 hitT = e2.dot(q) * inv;
+		if (hitT < 0 || hitT > t) return false;
+		t = hitT;
+		return true;
+	}
+
+	//builds the node for triangles [start,end) of original, reordering them so each child's triangles are contiguous
+	void BuildNode(std::vector<AABB>& bounds, std::vector<Vector3>& centroids, u32 start, u32 end, u32 depth) {
+		u32 index = nodes.size();
+		nodes.push_back(TriangleBVHNode());
+
+		AABB aabb = bounds[original[start]];
+		AABB centroidBounds(centroids[original[start]], centroids[original[start]]);
+		for (u32 i = start + 1; i < end; ++i) {
+			aabb = AABB::Union(aabb, bounds[original[i]]);
+			centroidBounds = AABB::Union(centroidBounds, AABB(centroids[original[i]], centroids[original[i]]));
+		}
+		nodes[index].aabb = aabb;
+
+		u32 count = end - start;
+		if (count <= TRIANGLEBVH_LEAF_SIZE) {
+			nodes[index].offset = start;
+			nodes[index].count  = count;
+			return;
+		}
+
+		//binned SAH: triangles are dropped into bins by centroid along each axis and every plane between bins is costed
+		//as (area * triangles) of both sides, the leaf it would replace costs (area * triangles) of the whole range
+		u32 axis = 0, split = 0;
+		f32 bestCost = FLT_MAX;
+		for (u32 a = 0; a < 3; ++a) {
+			f32 lo = Axis(centroidBounds.min, a), hi = Axis(centroidBounds.max, a);
+			if (hi - lo < 1e-7f) continue;
+			f32 scale = TRIANGLEBVH_BINS / (hi - lo);
+
+			AABB binBounds[TRIANGLEBVH_BINS];
+			u32 binCounts[TRIANGLEBVH_BINS] = {};
+			for (u32 i = start; i < end; ++i) {
+				u32 tri = original[i];
+				u32 bin = Min((u32)((Axis(centroids[tri], a) - lo) * scale), (u32)TRIANGLEBVH_BINS - 1);
+				binBounds[bin] = (binCounts[bin]) ? AABB::Union(binBounds[bin], bounds[tri]) : bounds[tri];
+				binCounts[bin]++;
+			}
+
+			//sweep from the right to get the cost of everything right of each plane, then from the left
+			f32 rightArea[TRIANGLEBVH_BINS - 1];
+			u32 rightCount[TRIANGLEBVH_BINS - 1];
+			AABB sweep; u32 sweepCount = 0;
+			for (u32 b = TRIANGLEBVH_BINS - 1; b > 0; --b) {
+				if (binCounts[b]) sweep = (sweepCount) ? AABB::Union(sweep, binBounds[b]) : binBounds[b];
+				sweepCount += binCounts[b];
+				rightArea[b-1]  = (sweepCount) ? sweep.HalfArea() : 0;
+				rightCount[b-1] = sweepCount;
+			}
+			sweepCount = 0;
+			for (u32 b = 0; b < TRIANGLEBVH_BINS - 1; ++b) {
+				if (binCounts[b]) sweep = (sweepCount) ? AABB::Union(sweep, binBounds[b]) : binBounds[b];
+				sweepCount += binCounts[b];
+				if (!sweepCount || !rightCount[b]) continue;
+				f32 cost = sweep.HalfArea() * sweepCount + rightArea[b] * rightCount[b];
+				if (cost < bestCost) {
+					bestCost = cost;
+					axis  = a;
+					split = b + 1;
+				}
+			}
+		}
+
+		u32 middle;
+		if (bestCost < FLT_MAX && depth < TRIANGLEBVH_MAX_DEPTH) {
+			if (bestCost >= aabb.HalfArea() * count && count <= TRIANGLEBVH_MAX_LEAF_SIZE) {
+				nodes[index].offset = start;
+				nodes[index].count  = count;
+				return;
+			}
+			f32 lo = Axis(centroidBounds.min, axis);
+			f32 scale = TRIANGLEBVH_BINS / (Axis(centroidBounds.max, axis) - lo);
+			middle = std::partition(original.begin() + start, original.begin() + end, [&](u32 tri) {
+				return Min((u32)((Axis(centroids[tri], axis) - lo) * scale), (u32)TRIANGLEBVH_BINS - 1) < split;
+			}) - original.begin();
+		}
+		else {
+			//every centroid is in the same spot or the tree is getting too deep, split the range in half along its longest axis
+			Vector3 extent = centroidBounds.max - centroidBounds.min;
+			axis = (extent.x >= extent.y && extent.x >= extent.z) ? 0 : (extent.y >= extent.z) ? 1 : 2;
+			middle = start + count / 2;
+			std::nth_element(original.begin() + start, original.begin() + middle, original.begin() + end, [&](u32 a, u32 b) {
+				return Axis(centroids[a], axis) < Axis(centroids[b], axis);
+			});
+		}
+
+		BuildNode(bounds, centroids, start, middle, depth + 1);
+		nodes[index].offset = nodes.size();
+		nodes[index].count  = 0;
+		BuildNode(bounds, centroids, middle, end, depth + 1);
+	}
+};
+
+#endif //DESHI_TRIANGLEBVH_H
@@ -1,5 +1,5 @@
 #pragma once
-#include "../utils/debug.h"
+#include "../utils/Debug.h"
 
 struct Vector3;
 struct Matrix4;
@@ -149,7 +149,7 @@ inline Quaternion Quaternion::operator - () {
 
 //Quaternion functions
 inline float Quaternion::mag() {
-	return std::sqrtf(x * x + y * y + z * z + w * w);
+	return sqrtf(x * x + y * y + z * z + w * w);
 }
 
 inline void Quaternion::normalize() {
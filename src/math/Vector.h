@@ -3,6 +3,8 @@
 #define DESHI_VECTOR_H
 
 #include <string>
+#include <cmath>
+#include <cstring>
 
 struct Vector2;
 struct Vector3;
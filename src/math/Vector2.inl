@@ -111,7 +111,7 @@ operator-() const {
 //compares if the difference is greater than .001
 inline bool Vector2::
 operator==(const Vector2& rhs) const {
-	return abs(this->x - rhs.x) < .001f && abs(this->y - rhs.y) < .001f;
+	return fabs(this->x - rhs.x) < .001f && fabs(this->y - rhs.y) < .001f;
 	//return this->y == rhs.y  && this->y == rhs.y;
 }
 
@@ -126,7 +126,7 @@ operator!=(const Vector2& rhs) const {
 
 inline Vector2 Vector2::
 absV() const{
-	return Vector2(abs(x), abs(y));
+	return Vector2(fabs(x), fabs(y));
 }
 
 inline Vector2 Vector2::
@@ -123,7 +123,7 @@ operator -  () const {
 //floating point accuracy in our vectors is .001 :)
 inline bool Vector3::
 operator == (const Vector3& rhs) const {
-	return abs(this->x - rhs.x) < .001f && abs(this->y - rhs.y) < .001f && abs(this->z - rhs.z) < .001f;
+	return fabs(this->x - rhs.x) < .001f && fabs(this->y - rhs.y) < .001f && fabs(this->z - rhs.z) < .001f;
 	//return this->y == rhs.y  && this->y == rhs.y && this->z == rhs.z;
 }
 
@@ -138,7 +138,7 @@ operator != (const Vector3& rhs) const {
 
 inline Vector3 Vector3::
 absV() const{
-	return Vector3(abs(x), abs(y), abs(z));
+	return Vector3(fabs(x), fabs(y), fabs(z));
 }
 
 inline Vector3 Vector3::
@@ -104,7 +104,7 @@ operator -  () const {
 
 inline bool Vector4::
 operator == (const Vector4& rhs) const {
-	return abs(this->x - rhs.x) < .001f && abs(this->y - rhs.y) < .001f && abs(this->z - rhs.z) < .001f && abs(this->w - rhs.w) < .001f;
+	return fabs(this->x - rhs.x) < .001f && fabs(this->y - rhs.y) < .001f && fabs(this->z - rhs.z) < .001f && fabs(this->w - rhs.w) < .001f;
 	//return this->x == rhs.x && this->y == rhs.y && this->z == rhs.z && this->w == rhs.w;
 }
 
@@ -119,7 +119,7 @@ operator != (const Vector4& rhs) const {
 
 inline Vector4 Vector4::
 absV() const{
-	return Vector4(abs(x), abs(y), abs(z), abs(w));
+	return Vector4(fabs(x), fabs(y), fabs(z), fabs(w));
 }
 
 
@@ -60,30 +60,58 @@ void Mesh::SetName(const char* name){
 	cpystr(this->name, name, DESHI_NAME_SIZE);
 }
 
-std::vector<Vector2> Mesh::GenerateOutlinePoints(Matrix4 transform, Matrix4 proj, Matrix4 view, Vector2 windimen, Vector3 camPosition) {
-	std::vector<Vector2> outline;
-	std::vector<Triangle> nonculled;
-	for (Triangle* t : triangles) {
-		t->removed = false;
-		if (t->norm.dot(camPosition - t->p[0] * transform) > 0) {
-			Triangle tri = *t;
-			tri.p[0] = Math::WorldToScreen(t->p[0] * transform, proj, view, windimen);
-			tri.p[1] = Math::WorldToScreen(t->p[1] * transform, proj, view, windimen);
-			tri.p[2] = Math::WorldToScreen(t->p[2] * transform, proj, view, windimen);
-			
-			nonculled.push_back(tri);
-		}
-		else t->removed = true;
+Silhouette& Mesh::GetSilhouette(Vector3 localEye) {
+	silhouetteClock++;
+	f32 eyeDistance = localEye.mag();
+	Vector3 eyeDirection = (eyeDistance > 0) ? localEye / eyeDistance : Vector3::ZERO;
+	for (Silhouette& s : silhouettes) {
+		f32 distance = s.eye.mag();
+		if (distance <= 0 || fabs(eyeDistance - distance) > distance * SILHOUETTE_DISTANCE_THRESHOLD) continue;
+		if (eyeDirection.dot(s.eye / distance) < SILHOUETTE_ANGLE_THRESHOLD) continue;
+		s.lastUsed = silhouetteClock;
+		return s;
 	}
 	
-	for (Triangle& t : nonculled) {
-		for (int i = 0; i < t.nbrs.size(); i++) {
-			if (t.nbrs[i]->removed) {
-				outline.push_back(t.p[t.sharededge[i]].ToVector2());
-				outline.push_back(t.p[(t.sharededge[i] + 1) % 3].ToVector2());
+	Silhouette* s;
+	if (silhouettes.size() < SILHOUETTE_CACHE_SIZE) {
+		silhouettes.push_back(Silhouette());
+		s = &silhouettes.back();
+	}
+	else {
+		s = &silhouettes[0];
+		for (Silhouette& other : silhouettes) if (other.lastUsed < s->lastUsed) s = &other;
+	}
+	s->eye = localEye;
+	s->lastUsed = silhouetteClock;
+	s->edges.clear();
+	
+	//in the mesh's space so the normals dont have to be transformed, which gives the same sides as world space
+	for (Triangle* t : triangles) {
+		t->removed = t->norm.dot(localEye - t->p[0]) <= 0;
+	}
+	for (Triangle* t : triangles) {
+		if (t->removed) continue;
+		for (int i = 0; i < t->nbrs.size(); i++) {
+			if (t->nbrs[i]->removed) {
+				s->edges.push_back(t->p[t->sharededge[i]]);
+				s->edges.push_back(t->p[(t->sharededge[i] + 1) % 3]);
 			}
 		}
 	}
+	return *s;
+}
+
+void Mesh::GenerateOutlinePoints(Matrix4 transform, Matrix4 proj, Matrix4 view, Vector2 windimen, Vector3 camPosition, std::vector<Vector2>& outline) {
+	outline.clear();
+	Silhouette& silhouette = GetSilhouette(camPosition * transform.Inverse());
+	for (Vector3& p : silhouette.edges) {
+		outline.push_back(Math::WorldToScreen(p * transform, proj, view, windimen).ToVector2());
+	}
+}
+
+std::vector<Vector2> Mesh::GenerateOutlinePoints(Matrix4 transform, Matrix4 proj, Matrix4 view, Vector2 windimen, Vector3 camPosition) {
+	std::vector<Vector2> outline;
+	GenerateOutlinePoints(transform, proj, view, windimen, camPosition, outline);
 	return outline;
 }
 
@@ -122,6 +122,18 @@ struct Face {
 	Vector3 norm;
 };
 
+//how far the eye can move in a mesh's space before a cached silhouette is found again
+#define SILHOUETTE_ANGLE_THRESHOLD    .9998f //cosine of the angle between the old and new eye directions
+#define SILHOUETTE_DISTANCE_THRESHOLD .02f   //fraction the eye's distance from the mesh's origin can change by
+#define SILHOUETTE_CACHE_SIZE         8      //silhouettes kept per mesh, the least recently used one is replaced
+
+//edges between triangles facing towards and away from an eye position in the mesh's space
+struct Silhouette {
+	Vector3 eye;
+	std::vector<Vector3> edges; //every other point is followed by the next point of its edge
+	u32 lastUsed;
+};
+
 struct Mesh {
 	char name[DESHI_NAME_SIZE];
 	
@@ -134,10 +146,19 @@ struct Mesh {
 	std::vector<Triangle*> triangles;
 	std::vector<Face*> faces;
 	
+	//silhouettes are shared by everything drawing this mesh from about the same place in its space
+	std::vector<Silhouette> silhouettes;
+	u32 silhouetteClock = 0;
+	
 	Mesh() {}
 	Mesh(const char* name, std::vector<Batch> batchArray);
 	
 	void SetName(const char* name);
+	
+	//returns the cached silhouette for an eye within the thresholds of the local space eye, finding it if there isnt one
+	Silhouette& GetSilhouette(Vector3 localEye);
+	//screen space outline of the mesh's silhouette, every other point is followed by the next point of its edge
+	void GenerateOutlinePoints(Matrix4 transform, Matrix4 proj, Matrix4 view, Vector2 windimen, Vector3 camPosition, std::vector<Vector2>& outline);
 	std::vector<Vector2> GenerateOutlinePoints(Matrix4 transform, Matrix4 proj, Matrix4 view, Vector2 windimen, Vector3 camPosition);
 	
 	//filename: filename and extension, name: loaded mesh name, transform: pos,rot,scale of mesh
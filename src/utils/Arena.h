@@ -0,0 +1,145 @@
+// Arena is a linear allocator over one contiguous block. Allocating just moves 'used' forward and
+// nothing is freed on its own, instead the whole arena is Reset at once. An allocation that doesnt
+// fit in the block gets its own overflow block, and the next Reset grows the block to the most that
+// was used, so an arena that is reset every frame stops touching the heap once it has seen its
+// biggest frame.
+// NOTE nothing allocated from the arena is destructed and Copy and ArenaArray copy construct items into
+// their new place, so it is only meant for plain data types
+// TLDR: bump allocation, everything is freed together by Reset
+
+#pragma once
+#ifndef DESHI_ARENA_H
+#define DESHI_ARENA_H
+
+#include "../defines.h"
+
+#include <vector>
+#include <cstdlib>
+#include <new>
+#include <type_traits>
+
+#define ARENA_ALIGNMENT 16
+
+struct Arena{
+	u8* data = 0;                //pointer to the block
+	u64 used = 0;                //bytes of the block handed out since the last reset
+	u64 capacity = 0;            //size of the block in bytes
+	u64 overflowed = 0;          //bytes handed out from overflow blocks since the last reset
+	std::vector<void*> overflow; //blocks for allocations that didnt fit, freed by the next reset
+
+	//allocates a block of 'capacity' bytes
+	void Init(u64 capacity);
+
+	//deallocates the block and any overflow blocks
+	void Free();
+
+	//returns 'size' bytes aligned to ARENA_ALIGNMENT, valid until the next Reset
+	void* Alloc(u64 size);
+
+	//returns an uninitialized array of 'count' 'T', 0 if count is 0
+	template<typename T> T* Push(u32 count);
+
+	//returns a copy of 'count' 'T' from 'items'
+	template<typename T> T* Copy(const T* items, u32 count);
+
+	//frees everything allocated from the arena, growing the block if it overflowed
+	void Reset();
+};
+
+//array whose items live in an arena, so it is only valid until that arena is reset
+template<typename T>
+struct ArenaArray{
+	T* data = 0;
+	u32 count = 0;
+	u32 capacity = 0;
+
+	//appends 'item', moving the items to an allocation twice as big from 'arena' when full
+	void Add(Arena& arena, const T& item);
+
+	//moves the items into 'arena', so they outlive a reset of the arena they were in
+	void MoveTo(Arena& arena);
+
+	T* begin(){ return data; }
+	T* end(){ return data + count; }
+	T& operator[](u32 i){ return data[i]; }
+};
+
+inline void Arena::Init(u64 _capacity){
+	capacity = _capacity;
+	data = (capacity) ? (u8*)malloc(capacity) : 0;
+	used = 0;
+	overflowed = 0;
+}
+
+inline void Arena::Free(){
+	for(void* block : overflow) free(block);
+	overflow.clear();
+	free(data);
+	data = 0;
+	used = 0;
+	capacity = 0;
+	overflowed = 0;
+}
+
+inline void* Arena::Alloc(u64 size){
+	size = (size + ARENA_ALIGNMENT-1) & ~u64(ARENA_ALIGNMENT-1);
+	if(used + size <= capacity){
+		void* result = data + used;
+		used += size;
+		return result;
+	}
+
+	//malloc aligns to at least 16 on the platforms we build for
+	void* block = malloc(size);
+	overflow.push_back(block);
+	overflowed += size;
+	return block;
+}
+
+template<typename T>
+inline T* Arena::Push(u32 count){
+	static_assert(std::is_trivially_destructible<T>::value, "arena items are never destructed");
+	static_assert(alignof(T) <= ARENA_ALIGNMENT, "arena items cant be aligned past ARENA_ALIGNMENT");
+	return (count) ? (T*)Alloc(u64(count) * sizeof(T)) : 0;
+}
+
+template<typename T>
+inline T* Arena::Copy(const T* items, u32 count){
+	T* result = Push<T>(count);
+	forI(count) new(&result[i]) T(items[i]);
+	return result;
+}
+
+inline void Arena::Reset(){
+	if(overflow.size()){
+		for(void* block : overflow) free(block);
+		overflow.clear();
+
+		//the new block fits everything this round needed with some room to grow
+		u64 needed = used + overflowed;
+		free(data);
+		capacity = needed + needed/2;
+		data = (u8*)malloc(capacity);
+	}
+	used = 0;
+	overflowed = 0;
+}
+
+template<typename T>
+inline void ArenaArray<T>::Add(Arena& arena, const T& item){
+	if(count == capacity){
+		capacity = (capacity) ? 2*capacity : 4;
+		T* grown = arena.Push<T>(capacity);
+		forI(count) new(&grown[i]) T(data[i]);
+		data = grown;
+	}
+	new(&data[count++]) T(item);
+}
+
+template<typename T>
+inline void ArenaArray<T>::MoveTo(Arena& arena){
+	data = arena.Copy(data, count);
+	capacity = count;
+}
+
+#endif //DESHI_ARENA_H
@@ -0,0 +1,155 @@
+// Pool is a chunked array of 'T' slots that never moves an item once it has been allocated.
+// Slots are handed out from a free list and 'chunkSize' slots are allocated at a time, so items
+// of the same type end up packed together in memory and iterating them is a linear walk.
+// Every slot has a generation that is bumped when the slot is freed, so a PoolHandle to a freed
+// item can be detected even if the slot has been reused.
+// NOTE the pool only manages memory; construction and destruction are left to the caller
+// (the intended use is a class-specific operator new/delete)
+
+#pragma once
+#ifndef DESHI_POOL_H
+#define DESHI_POOL_H
+
+#include "../defines.h"
+
+#include <vector>
+#include <cstdlib>
+
+#define POOL_NULL 0xFFFFFFFF
+
+struct PoolHandle{
+	u32 index      = POOL_NULL;
+	u32 generation = 0;
+};
+
+template<typename T, u32 chunkSize = 64>
+struct Pool{
+	std::vector<T*>  chunks;      //each chunk is 'chunkSize' uninitialized slots
+	std::vector<u32> generations; //per slot, incremented every time the slot is freed
+	std::vector<u8>  alive;       //per slot, 1 if the slot is currently allocated
+	std::vector<u32> freeList;    //indexes of unallocated slots, the last one is reused first
+	u32 count = 0;                //number of allocated slots
+
+	//returns memory for one 'T', grows by a chunk if there are no free slots
+	void* Alloc();
+
+	//returns the slot to the pool and invalidates any handles to it
+	void Free(void* ptr);
+
+	//releases chunks at the end of the pool that have no allocated slots
+	void Trim();
+
+	//returns the slot index of 'ptr', POOL_NULL if it isnt in this pool
+	u32 IndexOf(const void* ptr);
+
+	//returns a pointer to the item at 'index', 0 if it isnt allocated
+	T* At(u32 index);
+
+	//returns a handle to 'ptr' which can be checked for staleness later
+	PoolHandle Handle(const T* ptr);
+
+	//returns the item the handle points to, 0 if it has since been freed
+	T* Get(PoolHandle handle);
+
+	//calls 'fn' with a 'T*' for each allocated slot in memory order
+	template<typename F> void ForEach(F fn);
+
+	u32 Capacity(){ return chunks.size()*chunkSize; }
+};
+
+template<typename T, u32 chunkSize>
+inline void* Pool<T,chunkSize>::Alloc(){
+	if(freeList.empty()){
+		u32 start = Capacity();
+		chunks.push_back((T*)calloc(chunkSize, sizeof(T)));
+		if(generations.size() < start+chunkSize) generations.resize(start+chunkSize, 0);
+		alive.resize(start+chunkSize, 0);
+		//push in reverse so the lowest slot gets used first
+		for(u32 i = start+chunkSize; i > start; --i) freeList.push_back(i-1);
+	}
+
+	u32 index = freeList.back();
+	freeList.pop_back();
+	alive[index] = 1;
+	count++;
+	return chunks[index/chunkSize] + (index%chunkSize);
+}
+
+template<typename T, u32 chunkSize>
+inline void Pool<T,chunkSize>::Free(void* ptr){
+	u32 index = IndexOf(ptr);
+	Assert(index != POOL_NULL && alive[index], "attempted to free a pointer that isnt allocated in this pool");
+	alive[index] = 0;
+	generations[index]++;
+	freeList.push_back(index);
+	count--;
+}
+
+template<typename T, u32 chunkSize>
+inline void Pool<T,chunkSize>::Trim(){
+	u32 oldCapacity = Capacity();
+	while(chunks.size()){
+		u32 start = (chunks.size()-1)*chunkSize;
+		b32 empty = true;
+		for(u32 i = start; i < start+chunkSize; ++i) if(alive[i]){ empty = false; break; }
+		if(!empty) break;
+		free(chunks.back());
+		chunks.pop_back();
+	}
+	if(Capacity() == oldCapacity) return;
+
+	//generations are kept so handles into trimmed chunks stay stale if the chunk comes back
+	alive.resize(Capacity());
+	u32 capacity = Capacity();
+	for(u32 i = 0; i < freeList.size();){
+		if(freeList[i] >= capacity){
+			freeList[i] = freeList.back();
+			freeList.pop_back();
+		}else{
+			++i;
+		}
+	}
+}
+
+template<typename T, u32 chunkSize>
+inline u32 Pool<T,chunkSize>::IndexOf(const void* ptr){
+	forI(chunks.size()){
+		if(ptr >= chunks[i] && ptr < chunks[i]+chunkSize){
+			return i*chunkSize + u32((const T*)ptr - chunks[i]);
+		}
+	}
+	return POOL_NULL;
+}
+
+template<typename T, u32 chunkSize>
+inline T* Pool<T,chunkSize>::At(u32 index){
+	if(index >= Capacity() || !alive[index]) return 0;
+	return chunks[index/chunkSize] + (index%chunkSize);
+}
+
+template<typename T, u32 chunkSize>
+inline PoolHandle Pool<T,chunkSize>::Handle(const T* ptr){
+	PoolHandle handle;
+	handle.index = IndexOf(ptr);
+	if(handle.index != POOL_NULL) handle.generation = generations[handle.index];
+	return handle;
+}
+
+template<typename T, u32 chunkSize>
+inline T* Pool<T,chunkSize>::Get(PoolHandle handle){
+	if(handle.index >= generations.size() || generations[handle.index] != handle.generation) return 0;
+	return At(handle.index);
+}
+
+template<typename T, u32 chunkSize>
+template<typename F>
+inline void Pool<T,chunkSize>::ForEach(F fn){
+	forX(chunk, chunks.size()){
+		T* data = chunks[chunk];
+		forI(chunkSize){ //NOTE alive is indexed every time since 'fn' may allocate and resize it
+			if(alive[chunk*chunkSize + i]) fn(data+i);
+		}
+	}
+}
+
+#endif //DESHI_POOL_H